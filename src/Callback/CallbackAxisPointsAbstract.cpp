@@ -6,13 +6,14 @@
 
 CallbackAxisPointsAbstract::CallbackAxisPointsAbstract(const DocumentModelCoords &modelCoords) :
   m_modelCoords (modelCoords),
+  m_pointIdentifierOverride (POINT_IDENTIFIER_INVALID),
   m_numberAxisPoints (0),
   m_isError (false)
 {
 }
 
 CallbackAxisPointsAbstract::CallbackAxisPointsAbstract(const DocumentModelCoords &modelCoords,
-                                                       const QString pointIdentifierOverride,
+                                                       PointIdentifier pointIdentifierOverride,
                                                        const QPointF &posScreenOverride,
                                                        const QPointF &posGraphOverride) :
   m_modelCoords (modelCoords),
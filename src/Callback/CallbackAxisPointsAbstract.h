@@ -3,6 +3,7 @@
 
 #include "CallbackSearchReturn.h"
 #include "DocumentModelCoords.h"
+#include "PointIdentifier.h"
 #include <QString>
 #include <QTransform>
 
@@ -26,7 +27,7 @@ public:
 
   /// Constructor for when the data for one of the existing axis points is to be locally overwritten.
   CallbackAxisPointsAbstract(const DocumentModelCoords &modelCoords,
-                             const QString pointIdentifierOverride,
+                             PointIdentifier pointIdentifierOverride,
                              const QPointF &posGraphOverride,
                              const QPointF &posScreenOverride);
 
@@ -63,8 +64,8 @@ private:
   // Coordinates information that will be applied to the coordinates before they are used to compute the transformation
   DocumentModelCoords m_modelCoords;
 
-  // For overriding one existing Point. Identifier is empty for no overriding
-  QString m_pointIdentifierOverride;
+  // For overriding one existing Point. Identifier is POINT_IDENTIFIER_INVALID for no overriding
+  PointIdentifier m_pointIdentifierOverride;
   QPointF m_posScreenOverride;
   QPointF m_posGraphOverride;
 
@@ -2,7 +2,7 @@
 #include "Point.h"
 
 CallbackCheckEditPointAxis::CallbackCheckEditPointAxis(const DocumentModelCoords &modelCoords,
-                                                       const QString &pointIdentifier,
+                                                       PointIdentifier pointIdentifier,
                                                        const QPointF &posScreen,
                                                        const QPointF &posGraph) :
   CallbackAxisPointsAbstract (modelCoords,
@@ -14,7 +14,7 @@ class CallbackCheckEditPointAxis : public CallbackAxisPointsAbstract
 public:
   /// Single constructor.
   CallbackCheckEditPointAxis(const DocumentModelCoords &modelCoords,
-                             const QString &pointIdentifier,
+                             PointIdentifier pointIdentifier,
                              const QPointF &posScreen,
                              const QPointF &posGraph);
 
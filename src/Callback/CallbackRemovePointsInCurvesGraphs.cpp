@@ -1,10 +1,10 @@
 #include "CallbackRemovePointsInCurvesGraphs.h"
-#include "Document.h"
+#include "Point.h"
+#include <QString>
 
 extern const QString AXIS_CURVE_NAME;
 
-CallbackRemovePointsInCurvesGraphs::CallbackRemovePointsInCurvesGraphs(Document &document) :
-  m_document (document)
+CallbackRemovePointsInCurvesGraphs::CallbackRemovePointsInCurvesGraphs()
 {
 }
 
@@ -12,10 +12,20 @@ CallbackSearchReturn CallbackRemovePointsInCurvesGraphs::callback (const QString
                                                                    const Point &point)
 {
   if (curveName == AXIS_CURVE_NAME) {
-    m_document.removePointAxis (point.identifier());
+    m_identifiersAxes [point.identifier ()] = true;
   } else {
-    m_document.removePointGraph (point.identifier());
+    m_identifiersGraphs [point.identifier ()] = true;
   }
 
   return CALLBACK_SEARCH_RETURN_CONTINUE;
 }
+
+const QHash<PointIdentifier, bool> &CallbackRemovePointsInCurvesGraphs::identifiersAxes () const
+{
+  return m_identifiersAxes;
+}
+
+const QHash<PointIdentifier, bool> &CallbackRemovePointsInCurvesGraphs::identifiersGraphs () const
+{
+  return m_identifiersGraphs;
+}
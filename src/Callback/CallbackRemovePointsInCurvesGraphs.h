@@ -2,26 +2,34 @@
 #define CALLBACK_REMOVE_POINTS_IN_CURVES_GRAPHS_H
 
 #include "CallbackSearchReturn.h"
+#include "PointIdentifier.h"
+#include <QHash>
 
-class Document;
 class Point;
 class QString;
 
-/// Callback that is used when iterating through a read-only CurvesGraphs to remove corresponding points in Document.
+/// Callback that is used when iterating through a read-only CurvesGraphs to gather the identifiers of the corresponding
+/// points in Document, so they can be removed in one pass per Curve rather than searched for one at a time.
 class CallbackRemovePointsInCurvesGraphs
 {
 public:
   /// Single constructor.
-  CallbackRemovePointsInCurvesGraphs(Document &document);
+  CallbackRemovePointsInCurvesGraphs();
 
   /// Callback method.
   CallbackSearchReturn callback (const QString &curveName,
                                  const Point &point);
 
+  /// Identifiers of the gathered axis points.
+  const QHash<PointIdentifier, bool> &identifiersAxes () const;
+
+  /// Identifiers of the gathered graph points.
+  const QHash<PointIdentifier, bool> &identifiersGraphs () const;
+
 private:
-  CallbackRemovePointsInCurvesGraphs ();
 
-  Document &m_document;
+  QHash<PointIdentifier, bool> m_identifiersAxes;
+  QHash<PointIdentifier, bool> m_identifiersGraphs;
 };
 
 #endif // CALLBACK_REMOVE_POINTS_IN_CURVES_GRAPHS_H
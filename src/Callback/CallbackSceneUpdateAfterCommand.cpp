@@ -1,14 +1,12 @@
 #include "CallbackSceneUpdateAfterCommand.h"
-#include "DataKey.h"
 #include "Document.h"
 #include "GraphicsScene.h"
 #include "Point.h"
-#include <QGraphicsItem>
 
-CallbackSceneUpdateAfterCommand::CallbackSceneUpdateAfterCommand(PointIdentifierToGraphicsItem &pointIdentifierToGraphicsItem,
+CallbackSceneUpdateAfterCommand::CallbackSceneUpdateAfterCommand(QHash<PointIdentifier, bool> &pointIdentifiersUnseen,
                                                                  GraphicsScene &scene,
                                                                  const Document &document) :
-  m_pointIdentifierToGraphicsItem (pointIdentifierToGraphicsItem),
+  m_pointIdentifiersUnseen (pointIdentifiersUnseen),
   m_scene (scene),
   m_document (document)
 {
@@ -19,23 +17,21 @@ CallbackSearchReturn CallbackSceneUpdateAfterCommand::callback (const QString &c
 {
   CallbackSearchReturn rtn = CALLBACK_SEARCH_RETURN_CONTINUE;
 
-  QGraphicsItem *item = 0;
-  if (m_pointIdentifierToGraphicsItem.contains (point.identifier())) {
+  // Points still in the set afterwards are no longer in the Document
+  if (m_pointIdentifiersUnseen.remove (point.identifier ()) > 0) {
 
-    item = m_pointIdentifierToGraphicsItem [point.identifier ()];
+    m_scene.movePoint (point.identifier (),
+                       point.posScreen ());
 
   } else {
 
     // Point does not exist in scene yet so create it
     const Curve *curve = m_document.curveForCurveName (curveName);
     Q_CHECK_PTR (curve);
-    item = m_scene.addPoint (point.identifier (),
-                             curve->pointStyle (),
-                             point.posScreen ());
+    m_scene.addPoint (point.identifier (),
+                      curve->pointStyle (),
+                      point.posScreen ());
   }
 
-  // Mark point as wanted
-  item->setData (DATA_KEY_WANTED, true);
-
   return rtn;
 }
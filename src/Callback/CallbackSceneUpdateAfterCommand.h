@@ -2,19 +2,22 @@
 #define CALLBACK_SCENE_UPDATE_AFTER_COMMAND_H
 
 #include "CallbackSearchReturn.h"
-#include "PointIdentifierToGraphicsItem.h"
+#include "PointIdentifier.h"
 #include "PointStyle.h"
+#include <QHash>
 
 class Document;
 class GraphicsScene;
 class Point;
 
-/// Callback for updating the QGraphicsItems in the scene after a command may have modified Points in Curves.
+/// Callback for updating the Points in the scene after a command may have modified Points in Curves. This is only
+/// used for a complete resynchronization. The set starts with every Point in the scene, and each visited Point is
+/// taken out, so the Points left at the end are no longer in the Document
 class CallbackSceneUpdateAfterCommand
 {
 public:
   /// Single constructor.
-  CallbackSceneUpdateAfterCommand(PointIdentifierToGraphicsItem &pointIdentifierToGraphicsItem,
+  CallbackSceneUpdateAfterCommand(QHash<PointIdentifier, bool> &pointIdentifiersUnseen,
                                   GraphicsScene &scene,
                                   const Document &document);
 
@@ -25,7 +28,7 @@ public:
 private:
   CallbackSceneUpdateAfterCommand();
 
-  PointIdentifierToGraphicsItem &m_pointIdentifierToGraphicsItem;
+  QHash<PointIdentifier, bool> &m_pointIdentifiersUnseen;
   GraphicsScene &m_scene;
   const Document &m_document;
 };
@@ -10,13 +10,32 @@ CmdAbstract::CmdAbstract(MainWindow &mainWindow,
   QUndoCommand (text),
   m_mainWindow (mainWindow),
   m_document (document),
-  m_isFirstRedo (true)
+  m_isFirstRedo (true),
+  m_byteCountTotal (0),
+  m_byteCountTracked (0)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdAbstract::CmdAbstract";
 }
 
 CmdAbstract::~CmdAbstract()
 {
+  if (m_byteCountTotal != 0) {
+    *m_byteCountTotal -= m_byteCountTracked;
+  }
+}
+
+int CmdAbstract::byteCount () const
+{
+  return sizeof (CmdAbstract) + text ().size () * sizeof (QChar);
+}
+
+void CmdAbstract::compress ()
+{
+}
+
+void CmdAbstract::discard ()
+{
+  setObsolete (true);
 }
 
 Document &CmdAbstract::document ()
@@ -60,6 +79,20 @@ void CmdAbstract::redo ()
     m_identifierIndexAfterRedo = Point::identifierIndex();
 
   }
+
+  // Compressed storage may have been unpacked
+  updateByteCountTracked ();
+}
+
+void CmdAbstract::trackByteCount (qint64 *byteCountTotal)
+{
+  if (m_byteCountTotal == 0) {
+
+    m_byteCountTotal = byteCountTotal;
+    m_byteCountTracked = 0;
+  }
+
+  updateByteCountTracked ();
 }
 
 void CmdAbstract::undo ()
@@ -72,4 +105,16 @@ void CmdAbstract::undo ()
   cmdUndo ();
 
   Point::setIdentifierIndex (m_identifierIndexBeforeRedo);
+
+  updateByteCountTracked ();
+}
+
+void CmdAbstract::updateByteCountTracked ()
+{
+  if (m_byteCountTotal != 0) {
+
+    int byteCount = this->byteCount ();
+    *m_byteCountTotal += byteCount - m_byteCountTracked;
+    m_byteCountTracked = byteCount;
+  }
 }
@@ -16,12 +16,32 @@ public:
               const QString &text);
   virtual ~CmdAbstract();
 
+  /// Approximate memory held by this command, in bytes. CmdMediator uses this to keep the undo stack within its byte
+  /// budget. Subclasses holding more than a few fixed-size members should add their own storage to this
+  virtual int byteCount () const;
+
+  /// Release or compress storage that is not needed until this command is undone or redone again. This is applied
+  /// to the oldest commands when the undo stack exceeds its byte budget. The default does nothing
+  virtual void compress ();
+
   /// Redo method that is called when QUndoStack is moved one command forward.
   virtual void cmdRedo () = 0;
 
   /// Undo method that is called when QUndoStack is moved one command backward.
   virtual void cmdUndo () = 0;
 
+  /// Release all storage and mark this command as obsolete, so QUndoStack deletes it instead of undoing it. This is
+  /// applied to the oldest commands when compressing them does not bring the undo stack within its byte budget, which
+  /// ends the undo history at the first command that was kept. Overrides release their own storage and then call this
+  virtual void discard ();
+
+  /// Keep the running total of the bytes held by the commands of an undo stack up to date with byteCount, until this
+  /// command is deleted. The total is updated after every undo and redo, and by updateByteCountTracked.
+  void trackByteCount (qint64 *byteCountTotal);
+
+  /// Bring the total passed to trackByteCount up to date, after the storage of this command changed.
+  void updateByteCountTracked ();
+
 protected:
   /// Return the Document that this command will modify during redo and undo.
   Document &document();
@@ -43,8 +63,13 @@ private:
 
   // Snapshots of GraphicsPointAbstractBase::identifierIndex before and after redo
   bool m_isFirstRedo;
-  unsigned int m_identifierIndexBeforeRedo;
-  unsigned int m_identifierIndexAfterRedo;
+  quint64 m_identifierIndexBeforeRedo;
+  quint64 m_identifierIndexAfterRedo;
+
+  // Running total of the undo stack, and the bytes of this command that it includes. The total is null until this
+  // command has been pushed
+  qint64 *m_byteCountTotal;
+  int m_byteCountTracked;
 };
 
 #endif // CMD_ABSTRACT_H
@@ -2,6 +2,7 @@
 #define CMD_ADD_POINT_AXIS_H
 
 #include "CmdAbstract.h"
+#include "PointIdentifier.h"
 #include <QPointF>
 
 /// Command for adding one axis point.
@@ -23,7 +24,7 @@ private:
 
   QPointF m_posScreen;
   QPointF m_posGraph;
-  QString m_identifierAdded; // Point that got added
+  PointIdentifier m_identifierAdded; // Point that got added
 };
 
 #endif // CMD_ADD_POINT_AXIS_H
@@ -2,6 +2,7 @@
 #define CMD_ADD_POINT_GRAPH_H
 
 #include "CmdAbstract.h"
+#include "PointIdentifier.h"
 #include <QPointF>
 
 /// Command for adding one graph point.
@@ -23,7 +24,7 @@ private:
 
   const QString m_curveName;
   QPointF m_posScreen;
-  QString m_identifierAdded; // Point that got added
+  PointIdentifier m_identifierAdded; // Point that got added
 };
 
 #endif // CMD_ADD_POINT_GRAPH_H
@@ -9,49 +9,38 @@
 #include "MimePoints.h"
 #include <QApplication>
 #include <QClipboard>
-#include <QTextStream>
 #include "QtToString.h"
 
 CmdCopy::CmdCopy(MainWindow &mainWindow,
                  Document &document,
-                 const QStringList &selectedPointIdentifiers) :
+                 const PointIdentifierList &selectedPointIdentifiers) :
   CmdAbstract(mainWindow,
               document,
               "Copy"),
   m_transformIsDefined (mainWindow.transformIsDefined())
 {
-  QStringList selected;
-  QStringList::const_iterator itr;
-  for (itr = selectedPointIdentifiers.begin (); itr != selectedPointIdentifiers.end (); itr++) {
-
-    QString selectedPointIdentifier = *itr;
-
-    selected << selectedPointIdentifier;
-  }
-
+  // Only the count is logged, since formatting every identifier would dominate the cost of large selections
   LOG4CPP_INFO_S ((*mainCat)) << "CmdCopy::CmdCopy"
-                              << " selected=" << selected.join (", ").toLatin1 ().data () << ")";
+                              << " selected=" << selectedPointIdentifiers.count ();
 
-  ExportToClipboard exportStrategy;
-  QTextStream strCsv (&m_csv), strHtml (&m_html);
-  exportStrategy.exportToClipboard (selected,
-                                    mainWindow.transformIsDefined(),
-                                    strCsv,
-                                    strHtml,
-                                    m_curvesGraphs);
+  document.capturePointsInCurvesGraphs (selectedPointIdentifiers,
+                                        m_curvesGraphsPacked.curvesGraphs ());
+}
+
+int CmdCopy::byteCount () const
+{
+  return CmdAbstract::byteCount () + m_curvesGraphsPacked.byteCount ();
 }
 
 void CmdCopy::cmdRedo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdCopy::cmdRedo";
 
-  MimePoints *mimePoints;
-  if (m_transformIsDefined) {
-    mimePoints = new MimePoints (m_csv,
-                                 m_html);
-  } else {
-    mimePoints = new MimePoints (m_csv);
-  }
+  // Only the coordinates are placed on the clipboard. MimePoints renders the text formats when they are requested
+  ExportToClipboard exportStrategy;
+  MimePoints *mimePoints = new MimePoints (exportStrategy.exportCoordinates (m_curvesGraphsPacked.curvesGraphs (),
+                                                                            m_transformIsDefined),
+                                           m_transformIsDefined);
 
   QClipboard *clipboard = QApplication::clipboard();
   clipboard->setMimeData (mimePoints, QClipboard::Clipboard);
@@ -65,3 +54,15 @@ void CmdCopy::cmdUndo ()
 
   mainWindow().updateAfterCommand();
 }
+
+void CmdCopy::compress ()
+{
+  m_curvesGraphsPacked.compress ();
+}
+
+void CmdCopy::discard ()
+{
+  m_curvesGraphsPacked.clear ();
+
+  CmdAbstract::discard ();
+}
@@ -2,9 +2,9 @@
 #define CMD_CUT_H
 
 #include "CmdAbstract.h"
-#include "CurvesGraphs.h"
+#include "CurvesGraphsPacked.h"
+#include "PointIdentifier.h"
 #include <QHash>
-#include <QStringList>
 
 /// Command for cutting all selected Points.
 class CmdCut : public CmdAbstract
@@ -13,19 +13,21 @@ public:
   /// Single constructor.
   CmdCut(MainWindow &mainWindow,
          Document &document,
-         const QStringList &selectedPointIdentifiers);
+         const PointIdentifierList &selectedPointIdentifiers);
 
+  virtual int byteCount () const;
   virtual void cmdRedo ();
   virtual void cmdUndo ();
+  virtual void compress ();
+  virtual void discard ();
 
 private:
   CmdCut();
 
   bool m_transformIsDefined;
-  QString m_csv;
-  QString m_html;
 
-  CurvesGraphs m_curvesGraphs;
+  // Captured points. Only their coordinates go to the clipboard, where the text is rendered on request
+  CurvesGraphsPacked m_curvesGraphsPacked;
 };
 
 #endif // CMD_CUT_H
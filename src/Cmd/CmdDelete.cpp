@@ -1,47 +1,37 @@
 #include "CmdDelete.h"
 #include "DataKey.h"
 #include "Document.h"
-#include "ExportToClipboard.h"
 #include "GraphicsItemType.h"
 #include "GraphicsView.h"
 #include "Logger.h"
 #include "MainWindow.h"
-#include <QTextStream>
 #include <QtToString.h>
 
 CmdDelete::CmdDelete(MainWindow &mainWindow,
                      Document &document,
-                     const QStringList &selectedPointIdentifiers) :
+                     const PointIdentifierList &selectedPointIdentifiers) :
   CmdAbstract(mainWindow,
               document,
               "Delete")
 {
-  QStringList selected;
-  QStringList::const_iterator itr;
-  for (itr = selectedPointIdentifiers.begin (); itr != selectedPointIdentifiers.end (); itr++) {
-
-    QString selectedPointIdentifier = *itr;
+  // Only the count is logged, since formatting every identifier would dominate the cost of large selections
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdDelete::CmdDelete"
+                              << " selected=" << selectedPointIdentifiers.count ();
 
-    selected << selectedPointIdentifier;
-  }
+  document.capturePointsInCurvesGraphs (selectedPointIdentifiers,
+                                        m_curvesGraphsPacked.curvesGraphs ());
+}
 
-  LOG4CPP_INFO_S ((*mainCat)) << "CmdDelete::CmdDelete"
-                              << " selected=" << selected.join (", ").toLatin1 ().data () << ")";
-
-  ExportToClipboard exportStrategy;
-  QTextStream strCsv (&m_csv), strHtml (&m_html);
-  exportStrategy.exportToClipboard (selected,
-                                    mainWindow.transformIsDefined(),
-                                    strCsv,
-                                    strHtml,
-                              m_curvesGraphs);
+int CmdDelete::byteCount () const
+{
+  return CmdAbstract::byteCount () + m_curvesGraphsPacked.byteCount ();
 }
 
 void CmdDelete::cmdRedo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdDelete::cmdRedo";
 
-  document().removePointsInCurvesGraphs (m_curvesGraphs);
+  document().removePointsInCurvesGraphs (m_curvesGraphsPacked.curvesGraphs ());
 
   mainWindow().updateAfterCommand();
 }
@@ -50,7 +40,19 @@ void CmdDelete::cmdUndo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdDelete::cmdUndo";
 
-  document().addPointsInCurvesGraphs (m_curvesGraphs);
+  document().addPointsInCurvesGraphs (m_curvesGraphsPacked.curvesGraphs ());
 
   mainWindow().updateAfterCommand();
 }
+
+void CmdDelete::compress ()
+{
+  m_curvesGraphsPacked.compress ();
+}
+
+void CmdDelete::discard ()
+{
+  m_curvesGraphsPacked.clear ();
+
+  CmdAbstract::discard ();
+}
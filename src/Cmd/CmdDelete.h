@@ -2,9 +2,9 @@
 #define CMD_DELETE_H
 
 #include "CmdAbstract.h"
-#include "CurvesGraphs.h"
+#include "CurvesGraphsPacked.h"
+#include "PointIdentifier.h"
 #include <QHash>
-#include <QStringList>
 
 /// Command for deleting all selected Points.
 class CmdDelete : public CmdAbstract
@@ -13,19 +13,19 @@ public:
   /// Single constructor.
   CmdDelete(MainWindow &mainWindow,
             Document &document,
-            const QStringList &selectedPointIdentifiers);
+            const PointIdentifierList &selectedPointIdentifiers);
 
+  virtual int byteCount () const;
   virtual void cmdRedo ();
   virtual void cmdUndo ();
+  virtual void compress ();
+  virtual void discard ();
 
 private:
   CmdDelete();
 
-  bool m_transformIsDefined;
-  QString m_csv;
-  QString m_html;
-
-  CurvesGraphs m_curvesGraphs;
+  // Captured points, for restoring on undo. No clipboard text is involved
+  CurvesGraphsPacked m_curvesGraphsPacked;
 };
 
 #endif // CMD_DELETE_H
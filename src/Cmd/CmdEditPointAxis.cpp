@@ -7,7 +7,7 @@
 
 CmdEditPointAxis::CmdEditPointAxis (MainWindow &mainWindow,
                                     Document &document,
-                                    const QString &pointIdentifier,
+                                    PointIdentifier pointIdentifier,
                                     const QPointF &posGraphBefore,
                                     const QPointF &posGraphAfter) :
   CmdAbstract (mainWindow,
@@ -18,7 +18,7 @@ CmdEditPointAxis::CmdEditPointAxis (MainWindow &mainWindow,
   m_posGraphAfter (posGraphAfter)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdEditPointAxis::CmdEditPointAxis point="
-                              << pointIdentifier.toLatin1 ().data ()
+                              << Point::identifierToString (pointIdentifier).toLatin1 ().data ()
                               << " posGraphBefore=" << QPointFToString (posGraphBefore).toLatin1 ().data ()
                               << " posGraphAfter=" << QPointFToString (posGraphAfter).toLatin1 ().data ();
 }
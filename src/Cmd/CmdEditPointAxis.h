@@ -2,6 +2,7 @@
 #define CMD_EDIT_POINT_AXIS_H
 
 #include "CmdAbstract.h"
+#include "PointIdentifier.h"
 #include <QPointF>
 
 /// Command for editing the graph coordinates one axis point. The screen coordinates are
@@ -12,7 +13,7 @@ class CmdEditPointAxis : public CmdAbstract
   /// Single constructor.
   CmdEditPointAxis(MainWindow &mainWindow,
                    Document &document,
-                   const QString &pointIdentifier,
+                   PointIdentifier pointIdentifier,
                    const QPointF &posGraphBefore,
                    const QPointF &posGraphAfter);
   virtual ~CmdEditPointAxis();
@@ -23,7 +24,7 @@ class CmdEditPointAxis : public CmdAbstract
 private:
   CmdEditPointAxis();
 
-  QString m_pointIdentifier;
+  PointIdentifier m_pointIdentifier;
   QPointF m_posGraphBefore;
   QPointF m_posGraphAfter;
 };
@@ -1,5 +1,7 @@
+#include "CmdAbstract.h"
 #include "CmdMediator.h"
 #include "Document.h"
+#include "DocumentJournal.h"
 #include "Logger.h"
 #include "Point.h"
 #include <QImage>
@@ -7,15 +9,56 @@
 #include <QXmlStreamWriter>
 #include "Transformation.h"
 
-CmdMediator::CmdMediator (const QImage &image) :
-  m_document (image)
+const int UNDO_STACK_BYTE_BUDGET = 64 * 1024 * 1024;
+const int UNDO_STACK_COMMAND_LIMIT = 10000; // Backstop since QUndoStack can only drop old commands by count
+
+CmdMediator::CmdMediator (const QImage &image,
+                          const QByteArray &imageBytes) :
+  m_document (image,
+              imageBytes),
+  m_journal (0),
+  m_journalWasReplayed (false),
+  m_byteCountTotal (0)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdMediator::CmdMediator";
+
+  // The limit can only be set while the stack is empty
+  setUndoLimit (UNDO_STACK_COMMAND_LIMIT);
+
+  connect (this, SIGNAL (indexChanged (int)), this, SLOT (slotIndexChanged (int)));
 }
 
 CmdMediator::CmdMediator (const QString &fileName) :
-  m_document (fileName)
+  m_document (fileName),
+  m_journal (0),
+  m_journalWasReplayed (false),
+  m_byteCountTotal (0)
 {
+  setUndoLimit (UNDO_STACK_COMMAND_LIMIT);
+
+  if (m_document.successfulRead ()) {
+
+    // A journal is only left behind when the application ended without saving or discarding its changes
+    QList<QByteArray> records;
+    if (DocumentJournal::readRecords (fileName,
+                                      records)) {
+
+      m_document.replayJournal (records);
+      m_journalWasReplayed = true;
+    }
+
+    startJournal (fileName);
+  }
+
+  connect (this, SIGNAL (indexChanged (int)), this, SLOT (slotIndexChanged (int)));
+}
+
+CmdMediator::~CmdMediator ()
+{
+  // The base class would delete the commands after m_byteCountTotal is gone. Nothing is undone, so there is nothing
+  // to journal
+  disconnect (this, SIGNAL (indexChanged (int)), this, SLOT (slotIndexChanged (int)));
+  clear ();
 }
 
 void CmdMediator::applyTransformation (const Transformation &transformation)
@@ -23,6 +66,12 @@ void CmdMediator::applyTransformation (const Transformation &transformation)
   m_document.applyTransformation (transformation);
 }
 
+void CmdMediator::closeJournal ()
+{
+  delete m_journal;
+  m_journal = 0;
+}
+
 const Curve &CmdMediator::curveAxes () const
 {
   return m_document.curveAxes ();
@@ -48,24 +97,60 @@ const Document &CmdMediator::document() const
   return m_document;
 }
 
-bool CmdMediator::isModified () const
-{
-  return m_document.isModified ();
-}
-
-void CmdMediator::iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
+void CmdMediator::enforceByteBudget ()
 {
-  m_document.iterateThroughCurvePointsAxes (ftorWithCallback);
+  if (m_byteCountTotal <= UNDO_STACK_BYTE_BUDGET) {
+    return;
+  }
+
+  // Compress from the oldest command forward, since those are the least likely to be undone soon. The current
+  // command is left alone. QUndoStack only hands out const commands, although it owns them and they are safe to
+  // modify here
+  for (int index = 0; (index < count () - 1) && (m_byteCountTotal > UNDO_STACK_BYTE_BUDGET); index++) {
+
+    QUndoCommand *command = const_cast<QUndoCommand*> (QUndoStack::command (index));
+    if (!command->isObsolete ()) {
+
+      CmdAbstract *cmd = dynamic_cast<CmdAbstract*> (command);
+      if (cmd != 0) {
+        cmd->compress ();
+        cmd->updateByteCountTracked ();
+      }
+    }
+  }
+
+  // Discard the oldest commands if that is not enough. The discarded commands are always the oldest ones, so undoing
+  // down to them simply ends the history at the oldest command that was kept
+  int discarded = 0;
+  for (int index = 0; (index < count () - 1) && (m_byteCountTotal > UNDO_STACK_BYTE_BUDGET); index++) {
+
+    QUndoCommand *command = const_cast<QUndoCommand*> (QUndoStack::command (index));
+    if (!command->isObsolete ()) {
+
+      CmdAbstract *cmd = dynamic_cast<CmdAbstract*> (command);
+      if (cmd != 0) {
+        cmd->discard ();
+        cmd->updateByteCountTracked ();
+      } else {
+        command->setObsolete (true);
+      }
+      ++discarded;
+    }
+  }
+
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdMediator::enforceByteBudget"
+                              << " discarded=" << discarded
+                              << " bytes=" << m_byteCountTotal;
 }
 
-void CmdMediator::iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback) const
+bool CmdMediator::isModified () const
 {
-  m_document.iterateThroughCurvePointsAxes (ftorWithCallback);
+  return m_document.isModified ();
 }
 
-void CmdMediator::iterateThroughCurvesPointsGraphs (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
+bool CmdMediator::journalWasReplayed () const
 {
-  return m_document.iterateThroughCurvesPointsGraphs (ftorWithCallback);
+  return m_journalWasReplayed;
 }
 
 QPixmap CmdMediator::pixmap () const
@@ -75,11 +160,52 @@ QPixmap CmdMediator::pixmap () const
   return m_document.pixmap ();
 }
 
+void CmdMediator::push (QUndoCommand *cmd)
+{
+  QUndoStack::push (cmd);
+
+  // The pushed command is now on top, unless it was merged into the command below, which then changed size. Both
+  // cases are covered by tracking the top command. Commands that the push deleted took their bytes off the total
+  CmdAbstract *cmdTop = dynamic_cast<CmdAbstract*> (const_cast<QUndoCommand*> (command (count () - 1)));
+  if (cmdTop != 0) {
+    cmdTop->trackByteCount (&m_byteCountTotal);
+  }
+
+  enforceByteBudget ();
+}
+
 QString CmdMediator::reasonForUnsuccessfulRead () const
 {
   return m_document.reasonForUnsuccessfulRead ();
 }
 
+void CmdMediator::slotIndexChanged (int /* index */)
+{
+  // Every push, undo and redo ends up here after the Document has changed. The changes are collected even without a
+  // journal, so they do not pile up
+  QByteArray record = m_document.journalDelta ();
+
+  if (m_journal != 0) {
+
+    m_journal->append (record);
+
+    if (m_journal->isDueForCompaction ()) {
+      m_journal->compact (m_document.journalSnapshot ());
+    }
+  }
+}
+
+void CmdMediator::startJournal (const QString &fileName)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdMediator::startJournal fileName=" << fileName.toLatin1 ().data ();
+
+  closeJournal ();
+
+  m_journal = new DocumentJournal (fileName,
+                                   m_document.journalSnapshot (),
+                                   this);
+}
+
 bool CmdMediator::successfulRead () const
 {
   return m_document.successfulRead();
@@ -6,6 +6,7 @@
 #include "PointStyle.h"
 #include <QUndoStack>
 
+class DocumentJournal;
 class QImage;
 class Transformation;
 
@@ -13,18 +14,38 @@ class Transformation;
 /// This class lies between the Document and the rest of the application. This approach is attractive because the
 /// command stack and Document are born together, work together, and deleted together. Also, wrapping this class
 /// around Document helps to encapsulate Document that much more.
+///
+/// The stack is kept within a byte budget. Each command keeps a running total of the bytes held by the stack up to
+/// date (see CmdAbstract::trackByteCount). After each push, if the total is over the budget, the oldest commands are
+/// compressed (see CmdAbstract::compress) until the total fits, and if that is not enough the oldest commands are
+/// discarded (see CmdAbstract::discard). QUndoStack only supports removing old commands by count, so a command count
+/// limit is also set when the stack is created
+///
+/// Once the Document has a file, every push, undo and redo appends the changes to a DocumentJournal next to the file,
+/// so the changes since the last save survive a crash
 class CmdMediator : public QUndoStack
 {
+  Q_OBJECT;
+
 public:
-  /// Constructor for imported images and dragged images.
-  CmdMediator (const QImage &image);
+  /// Constructor for imported images and dragged images. The original file bytes of imported images are kept so they
+  /// can be saved unchanged.
+  CmdMediator (const QImage &image,
+               const QByteArray &imageBytes = QByteArray ());
 
-  /// Constructor for opened Documents. The specified file is opened and read.
+  /// Constructor for opened Documents. The specified file is opened and read, and then the changes in its journal
+  /// are replayed if it was left behind by a crash. A new journal is then started.
   CmdMediator (const QString &fileName);
 
+  /// Delete the commands while the running total that they update still exists.
+  virtual ~CmdMediator ();
+
   /// See CurvesGraphs::applyTransformation
   void applyTransformation (const Transformation &transformation);
 
+  /// Stop journaling and remove the journal, once unsaved changes have been saved or discarded.
+  void closeJournal ();
+
   /// See Document::curveAxes
   const Curve &curveAxes () const;
 
@@ -43,28 +64,61 @@ public:
   /// See Document::isModified.
   bool isModified () const;
 
-  /// See Curve::iterateThroughCurvePoints, for the single axes curve.
-  void iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback);
+  /// True if the constructor recovered changes from a journal that was left behind by a crash.
+  bool journalWasReplayed () const;
 
   /// See Curve::iterateThroughCurvePoints, for the single axes curve.
-  void iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback) const;
+  template<typename Visitor>
+  CallbackSearchReturn iterateThroughCurvePointsAxes (Visitor &visitor) const;
 
-  /// See Curve::iterateThroughCurvePoints, for all the graphs curves.
-  void iterateThroughCurvesPointsGraphs (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback);
+  /// See CurvesGraphs::iterateThroughCurvesPoints, for all the graphs curves.
+  template<typename Visitor>
+  CallbackSearchReturn iterateThroughCurvesPointsGraphs (Visitor &visitor) const;
 
   /// See Document::pixmap.
   QPixmap pixmap () const;
 
+  /// Push a command, then keep the stack within its byte budget. This hides QUndoStack::push, which is not virtual,
+  /// so all commands must be pushed through a CmdMediator rather than a QUndoStack pointer.
+  void push (QUndoCommand *cmd);
+
   /// See Document::reasonForUnsuccessfulRead.
   QString reasonForUnsuccessfulRead () const;
 
+  /// Start a new journal for the Document file, replacing any earlier journal. Call this after the Document has been
+  /// saved to the file.
+  void startJournal (const QString &fileName);
+
   /// Wrapper for Document::successfulRead
   bool successfulRead () const;
 
+private slots:
+  void slotIndexChanged (int index);
+
 private:
   CmdMediator ();
 
+  void enforceByteBudget ();
+
   Document m_document;
+
+  DocumentJournal *m_journal; // Null until the Document has a file
+  bool m_journalWasReplayed;
+
+  // Bytes held by the commands on the stack. See CmdAbstract::trackByteCount
+  qint64 m_byteCountTotal;
 };
 
+template<typename Visitor>
+CallbackSearchReturn CmdMediator::iterateThroughCurvePointsAxes (Visitor &visitor) const
+{
+  return m_document.iterateThroughCurvePointsAxes (visitor);
+}
+
+template<typename Visitor>
+CallbackSearchReturn CmdMediator::iterateThroughCurvesPointsGraphs (Visitor &visitor) const
+{
+  return m_document.iterateThroughCurvesPointsGraphs (visitor);
+}
+
 #endif // CMD_MEDIATOR_H
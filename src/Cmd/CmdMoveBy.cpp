@@ -5,32 +5,32 @@
 #include "GraphicsView.h"
 #include "Logger.h"
 #include "MainWindow.h"
+#include <qmath.h>
 #include <QGraphicsItem>
 #include <QtToString.h>
 
+const int CMD_ID_MOVE_BY = 1; // Any non-negative value enables merging in QUndoStack
+const double MERGE_DIRECTION_TOLERANCE = 1e-6; // Relative tolerance when checking for parallel moves
+
 CmdMoveBy::CmdMoveBy(MainWindow &mainWindow,
                      Document &document,
                      const QPointF &deltaScreen,
                      const QString &moveText,
-                     const QStringList &selectedPointIdentifiers) :
+                     const PointIdentifierList &selectedPointIdentifiers) :
   CmdAbstract(mainWindow,
               document,
               moveText),
-  m_deltaScreen (deltaScreen)
+  m_deltaScreen (deltaScreen),
+  m_movedPoints (selectedPointIdentifiers)
 {
-  QStringList selected; // For debug
-  QStringList::const_iterator itr;
-  for (itr = selectedPointIdentifiers.begin (); itr != selectedPointIdentifiers.end (); itr++) {
-
-    QString selectedPointIdentifier = *itr;
-
-    selected << selectedPointIdentifier;
-    m_movedPoints [selectedPointIdentifier] = true;
-  }
-
   LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::CmdMoveBy"
                               << " deltaScreen=" << QPointFToString (deltaScreen).toLatin1 ().data ()
-                              << " selected=" << selected.join (", ").toLatin1 ().data () << ")";
+                              << " selected=" << selectedPointIdentifiers.count ();
+}
+
+int CmdMoveBy::byteCount () const
+{
+  return CmdAbstract::byteCount () + sizeof (QPointF) + m_movedPoints.byteCount ();
 }
 
 void CmdMoveBy::cmdRedo ()
@@ -55,35 +55,64 @@ void CmdMoveBy::cmdUndo ()
   mainWindow().updateAfterCommand();
 }
 
-void CmdMoveBy::moveBy (const QPointF &deltaScreen)
+void CmdMoveBy::compress ()
 {
-  // Move Points in the Document
-  PointIdentifiers::iterator itrD;
-  for (itrD = m_movedPoints.begin (); itrD != m_movedPoints.end (); itrD++) {
+  m_movedPoints.compress ();
+}
 
-      QString pointIdentifier = itrD.key ();
-      document().movePoint (pointIdentifier, deltaScreen);
+void CmdMoveBy::discard ()
+{
+  m_movedPoints = PointIdentifiersPacked ();
+
+  CmdAbstract::discard ();
+}
+
+int CmdMoveBy::id () const
+{
+  return CMD_ID_MOVE_BY;
+}
+
+bool CmdMoveBy::mergeWith (const QUndoCommand *command)
+{
+  const CmdMoveBy *other = dynamic_cast<const CmdMoveBy*> (command);
+  if (other == 0) {
+    return false;
   }
 
-  // Move Points in GraphicsScene, using the new positions in Document
-  QList<QGraphicsItem *> items = mainWindow().view().items();
-  QList<QGraphicsItem *>::iterator itrS;
-  for (itrS = items.begin (); itrS != items.end (); itrS++) {
+  // Same direction means parallel (zero cross product) and not opposite (positive dot product). Opposite moves are
+  // kept separate so undo still steps back through a change of direction
+  double cross = m_deltaScreen.x () * other->m_deltaScreen.y () - m_deltaScreen.y () * other->m_deltaScreen.x ();
+  double dot = m_deltaScreen.x () * other->m_deltaScreen.x () + m_deltaScreen.y () * other->m_deltaScreen.y ();
+  double lengthSquared = m_deltaScreen.x () * m_deltaScreen.x () + m_deltaScreen.y () * m_deltaScreen.y ();
+  double lengthSquaredOther = other->m_deltaScreen.x () * other->m_deltaScreen.x () +
+                              other->m_deltaScreen.y () * other->m_deltaScreen.y ();
+  double scale = qSqrt (lengthSquared * lengthSquaredOther);
+  bool isSameDirection = (dot > 0) && (qAbs (cross) <= MERGE_DIRECTION_TOLERANCE * scale);
+
+  if (!isSameDirection || !(m_movedPoints == other->m_movedPoints)) {
+    return false;
+  }
 
-    QGraphicsItem *item = *itrS;
-    if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT) {
+  LOG4CPP_INFO_S ((*mainCat)) << "CmdMoveBy::mergeWith"
+                              << " deltaScreen=" << QPointFToString (m_deltaScreen).toLatin1 ().data ()
+                              << " + " << QPointFToString (other->m_deltaScreen).toLatin1 ().data ();
 
-      QString pointIdentifier = item->data (DATA_KEY_IDENTIFIER).toString ();
+  // The other command has already been redone, so only the total needs updating
+  m_deltaScreen += other->m_deltaScreen;
 
-      if (m_movedPoints.contains (pointIdentifier)) {
+  return true;
+}
 
-        QPointF posScreen = document().positionScreen (pointIdentifier);
+void CmdMoveBy::moveBy (const QPointF &deltaScreen)
+{
+  // Move Points in the Document. The Document records the moved identifiers, and the GraphicsScene moves just
+  // those items in updateAfterCommand
+  PointIdentifierList movedPoints = m_movedPoints.identifiers ();
 
-        if (item->pos () != posScreen) {
+  PointIdentifierList::const_iterator itrD;
+  for (itrD = movedPoints.begin (); itrD != movedPoints.end (); itrD++) {
 
-          item->setPos (posScreen);
-        }
-      }
-    }
+      PointIdentifier pointIdentifier = *itrD;
+      document().movePoint (pointIdentifier, deltaScreen);
   }
 }
@@ -2,13 +2,12 @@
 #define CMD_MOVE_BY_H
 
 #include "CmdAbstract.h"
-#include <QHash>
+#include "PointIdentifier.h"
+#include "PointIdentifiersPacked.h"
 #include <QPointF>
-#include <QStringList>
 
-typedef QHash<QString, bool> PointIdentifiers;
-
-/// Command for moving all selected Points by a specified translation.
+/// Command for moving all selected Points by a specified translation. Consecutive moves of the same Points in the same
+/// direction, such as repeated arrow key nudges, are merged into a single command.
 class CmdMoveBy : public CmdAbstract
 {
 public:
@@ -17,10 +16,19 @@ public:
             Document &document,
             const QPointF &deltaScreen,
             const QString &moveText,
-            const QStringList &selectedPointIdentifiers);
+            const PointIdentifierList &selectedPointIdentifiers);
 
+  virtual int byteCount () const;
   virtual void cmdRedo ();
   virtual void cmdUndo ();
+  virtual void compress ();
+  virtual void discard ();
+
+  /// Identifier that QUndoStack uses to decide whether mergeWith should be tried.
+  virtual int id () const;
+
+  /// Absorb the next command if it moves the same Points in the same direction. Returns true if merged.
+  virtual bool mergeWith (const QUndoCommand *command);
 
 private:
   CmdMoveBy();
@@ -28,7 +36,7 @@ private:
   void moveBy (const QPointF &deltaScreen);
 
   QPointF m_deltaScreen;
-  PointIdentifiers m_movedPoints;
+  PointIdentifiersPacked m_movedPoints;
 };
 
 #endif // CMD_MOVE_BY_H
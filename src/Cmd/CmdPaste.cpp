@@ -5,49 +5,126 @@
 #include "GraphicsView.h"
 #include "Logger.h"
 #include "MainWindow.h"
-#include "MimePoints.h"
+#include "MimePointsParser.h"
 #include <QApplication>
 #include <QClipboard>
 #include <QGraphicsItem>
-#include <QTextStream>
+#include <QMimeData>
+#include <QVector>
 #include "QtToString.h"
 
 CmdPaste::CmdPaste(MainWindow &mainWindow,
                    Document &document,
-                   const QStringList &selectedPointIdentifiers) :
+                   const PointIdentifierList &selectedPointIdentifiers) :
   CmdAbstract(mainWindow,
               document,
               "Paste")
 {
-  QStringList selected;
-  QStringList::const_iterator itr;
+  PointIdentifierList::const_iterator itr;
   for (itr = selectedPointIdentifiers.begin (); itr != selectedPointIdentifiers.end (); itr++) {
+    m_copiedPoints [*itr] = true;
+  }
 
-    QString selectedPointIdentifier = *itr;
+  MimePointsCurves curvesPasted;
+  const QMimeData *mimeData = QApplication::clipboard()->mimeData (QClipboard::Clipboard);
+  if (mimeData != 0) {
+    MimePointsParser parser;
+    if (!parser.parse (*mimeData,
+                       curvesPasted)) {
+      LOG4CPP_INFO_S ((*mainCat)) << "CmdPaste::CmdPaste clipboard does not hold points";
+    }
+  }
 
-    selected << selectedPointIdentifier;
-    m_copiedPoints [selectedPointIdentifier] = true;
+  MimePointsCurves::const_iterator itrCurve;
+  for (itrCurve = curvesPasted.begin (); itrCurve != curvesPasted.end (); itrCurve++) {
+    capturePastedCurve (*itrCurve);
   }
 
   LOG4CPP_INFO_S ((*mainCat)) << "CmdPaste::CmdPaste"
-                              << " selected=" << selected.join (", ").toLatin1 ().data () << ")";
+                              << " selected=" << selectedPointIdentifiers.count ()
+                              << " curves=" << m_curvesGraphsPacked.curvesGraphs ().numCurves ()
+                              << " points=" << m_curvesGraphsPacked.numPoints ();
+}
+
+int CmdPaste::byteCount () const
+{
+  return CmdAbstract::byteCount () + m_curvesGraphsPacked.byteCount ();
+}
+
+void CmdPaste::capturePastedCurve (const MimePointsCurve &curvePasted)
+{
+  // Points go back to their own graph curve if the Document has it, and otherwise to the current curve
+  QString curveName = curvePasted.curveName;
+  if ((curveName == AXIS_CURVE_NAME) ||
+      (document().curvesGraphs().curveForCurveName (curveName) == 0)) {
+    curveName = mainWindow().selectedCurrentCurve ();
+  }
+
+  const Curve *curveDocument = document().curvesGraphs().curveForCurveName (curveName);
+  if (curveDocument == 0) {
+    LOG4CPP_INFO_S ((*mainCat)) << "CmdPaste::capturePastedCurve no curve for the points of "
+                                << curvePasted.curveName.toLatin1 ().data ();
+    return;
+  }
+
+  // Copied coordinates are graph coordinates once the transformation is defined, and screen coordinates before
+  int count = curvePasted.x.count ();
+  QVector<QPointF> positions (count);
+  for (int index = 0; index < count; index++) {
+    positions [index] = QPointF (curvePasted.x.at (index),
+                                 curvePasted.y.at (index));
+  }
+
+  if (mainWindow().transformIsDefined ()) {
+    mainWindow().transformation().transformInverseMany (count,
+                                                        positions.constData (),
+                                                        positions.data ());
+  }
+
+  CurvesGraphs &curvesGraphs = m_curvesGraphsPacked.curvesGraphs ();
+  Curve *curveCaptured = curvesGraphs.curveForCurveName (curveName);
+  if (curveCaptured == 0) {
+    curvesGraphs.addGraphCurveAtEnd (Curve (curveName,
+                                            curveDocument->lineStyle (),
+                                            curveDocument->pointStyle ()));
+    curveCaptured = curvesGraphs.curveForCurveName (curveName);
+  }
+
+  // Each point gets its identifier here, so undo and redo remove and add the same points
+  QVector<QPointF>::const_iterator itr;
+  for (itr = positions.begin (); itr != positions.end (); itr++) {
+    curveCaptured->addPoint (Point (curveName,
+                                    *itr));
+  }
 }
 
 void CmdPaste::cmdRedo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdPaste::cmdRedo"
-                              << " pasting=" << m_copiedPoints.count ();
-
-  QClipboard *clipboard = QApplication::clipboard();
-  clipboard->setMimeData (&m_mimePoints, QClipboard::Clipboard);
+                              << " pasting=" << m_curvesGraphsPacked.numPoints ();
 
+  document().addPointsInCurvesGraphs (m_curvesGraphsPacked.curvesGraphs ());
   mainWindow().updateAfterCommand();
 }
 
 void CmdPaste::cmdUndo ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "CmdPaste::cmdUndo"
-                              << " pasting=" << m_copiedPoints.count ();
+                              << " pasting=" << m_curvesGraphsPacked.numPoints ();
 
+  document().removePointsInCurvesGraphs (m_curvesGraphsPacked.curvesGraphs ());
   mainWindow().updateAfterCommand();
 }
+
+void CmdPaste::compress ()
+{
+  m_curvesGraphsPacked.compress ();
+}
+
+void CmdPaste::discard ()
+{
+  m_copiedPoints.clear ();
+  m_curvesGraphsPacked.clear ();
+
+  CmdAbstract::discard ();
+}
@@ -2,29 +2,39 @@
 #define CMD_PASTE_H
 
 #include "CmdAbstract.h"
-#include "MimePoints.h"
+#include "CurvesGraphsPacked.h"
+#include "MimePointsCurve.h"
+#include "PointIdentifier.h"
 #include <QHash>
-#include <QStringList>
 
-typedef QHash<QString, bool> PointIdentifiers;
+typedef QHash<PointIdentifier, bool> PointIdentifiers;
 
-/// Command for moving all selected Points by a specified translation.
+/// Command for pasting the points on the clipboard. Points of a curve that the Document has keep their curve, and
+/// the others go to the current curve.
 class CmdPaste : public CmdAbstract
 {
 public:
-  /// Single constructor.
+  /// Single constructor. The clipboard is parsed here, so redoing the command pastes the same points even after the
+  /// clipboard has changed.
   CmdPaste(MainWindow &mainWindow,
            Document &document,
-           const QStringList &selectedPointIdentifiers);
+           const PointIdentifierList &selectedPointIdentifiers);
 
+  virtual int byteCount () const;
   virtual void cmdRedo ();
   virtual void cmdUndo ();
+  virtual void compress ();
+  virtual void discard ();
 
 private:
   CmdPaste();
 
+  void capturePastedCurve (const MimePointsCurve &curvePasted);
+
   PointIdentifiers m_copiedPoints;
-  MimePoints m_mimePoints;
+
+  // Pasted points in screen coordinates, with the identifiers they get in the Document
+  CurvesGraphsPacked m_curvesGraphsPacked;
 };
 
 #endif // CMD_PASTE_H
@@ -3,20 +3,76 @@
 #include "fftw3.h"
 #include "Logger.h"
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <qmath.h>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStandardPaths>
 
-Correlation::Correlation(int N) :
+const QString WISDOM_FILE_NAME ("fftw_wisdom");
+
+bool Correlation::m_wisdomIsImported = false;
+
+static QMutex mutexPlanner; // FFTW planner calls, and the wisdom, are not thread safe
+
+static fftw_plan planDft (int length,
+                          int howMany,
+                          fftw_complex *in,
+                          fftw_complex *out,
+                          int sign,
+                          bool &isNewWisdom)
+{
+  // A plan that is already in the wisdom is created without measuring. Only the other plans add to the wisdom.
+  // FFTW_MEASURE overwrites the arrays while planning, which is harmless since nothing has been loaded yet
+  fftw_plan plan = fftw_plan_many_dft (1, &length, howMany,
+                                       in, 0, 1, length,
+                                       out, 0, 1, length,
+                                       sign, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+  if (plan == 0) {
+
+    plan = fftw_plan_many_dft (1, &length, howMany,
+                               in, 0, 1, length,
+                               out, 0, 1, length,
+                               sign, FFTW_MEASURE);
+    isNewWisdom = true;
+  }
+
+  return plan;
+}
+
+Correlation::Correlation(int N,
+                         int numKernels) :
   m_N (N),
+  m_numKernels (numKernels),
   m_signalA ((fftw_complex *) fftw_malloc(sizeof(fftw_complex) * (2 * N - 1))),
   m_signalB ((fftw_complex *) fftw_malloc(sizeof(fftw_complex) * (2 * N - 1))),
   m_outShifted ((fftw_complex *) fftw_malloc(sizeof(fftw_complex) * (2 * N - 1))),
   m_outA ((fftw_complex *) fftw_malloc(sizeof(fftw_complex) * (2 * N - 1))),
   m_outB ((fftw_complex *) fftw_malloc(sizeof(fftw_complex) * (2 * N - 1))),
-  m_out ((fftw_complex *) fftw_malloc(sizeof(fftw_complex) * (2 * N - 1)))
+  m_out ((fftw_complex *) fftw_malloc(sizeof(fftw_complex) * (2 * N - 1))),
+  m_signalsMany (0),
+  m_outsMany (0),
+  m_outsShiftedMany (0),
+  m_planManyB (0),
+  m_planManyX (0)
 {
-  m_planA = fftw_plan_dft_1d(2 * N - 1, m_signalA, m_outA, FFTW_FORWARD, FFTW_ESTIMATE);
-  m_planB = fftw_plan_dft_1d(2 * N - 1, m_signalB, m_outB, FFTW_FORWARD, FFTW_ESTIMATE);
-  m_planX = fftw_plan_dft_1d(2 * N - 1, m_out, m_outShifted, FFTW_BACKWARD, FFTW_ESTIMATE);
+  Q_ASSERT (numKernels > 0);
+
+  QMutexLocker locker (&mutexPlanner);
+
+  importWisdom ();
+
+  int length = 2 * N - 1;
+  bool isNewWisdom = false;
+  m_planA = planDft (length, 1, m_signalA, m_outA, FFTW_FORWARD, isNewWisdom);
+  m_planB = planDft (length, 1, m_signalB, m_outB, FFTW_FORWARD, isNewWisdom);
+  m_planX = planDft (length, 1, m_out, m_outShifted, FFTW_BACKWARD, isNewWisdom);
+
+  if (isNewWisdom) {
+    exportWisdom ();
+  }
 }
 
 Correlation::~Correlation()
@@ -24,6 +80,10 @@ Correlation::~Correlation()
   fftw_destroy_plan(m_planA);
   fftw_destroy_plan(m_planB);
   fftw_destroy_plan(m_planX);
+  if (m_planManyB != 0) {
+    fftw_destroy_plan(m_planManyB);
+    fftw_destroy_plan(m_planManyX);
+  }
 
   fftw_free(m_signalA);
   fftw_free(m_signalB);
@@ -31,8 +91,11 @@ Correlation::~Correlation()
   fftw_free(m_out);
   fftw_free(m_outA);
   fftw_free(m_outB);
+  fftw_free(m_signalsMany);
+  fftw_free(m_outsMany);
+  fftw_free(m_outsShiftedMany);
 
-  fftw_cleanup();
+  // There is no fftw_cleanup here since that would discard the accumulated wisdom of every planner in the process
 }
 
 void Correlation::correlateWithShift (int N,
@@ -47,63 +110,75 @@ void Correlation::correlateWithShift (int N,
 
   Q_ASSERT (N == m_N);
 
-  // Normalize input functions so that:
-  // 1) mean is zero. This is used to compute an additive normalization constant
-  // 2) max value is 1. This is used to compute a multiplicative normalization constant
-  double sumMean1 = 0, sumMean2 = 0, max1 = 0, max2 = 0;
-  for (i = 0; i < N; i++) {
+  loadReference (function1);
+  loadKernel (function2,
+              m_signalB);
 
-    sumMean1 += function1 [i];
-    sumMean2 += function2 [i];
-    max1 = qMax (max1, function1 [i]);
-    max2 = qMax (max2, function2 [i]);
+  fftw_execute(m_planA);
+  fftw_execute(m_planB);
 
+  // Correlation in frequency space
+  fftw_complex scale = 1.0/(2.0 * N - 1.0);
+  for (i = 0; i < 2 * N - 1; i++) {
+    m_out[i] = m_outA[i] * conj(m_outB[i]) * scale;
   }
 
-  double additiveNormalization1 = sumMean1 / N;
-  double additiveNormalization2 = sumMean2 / N;
-  double multiplicativeNormalization1 = 1.0 / max1;
-  double multiplicativeNormalization2 = 1.0 / max2;
+  fftw_execute(m_planX);
 
-  // Load length N functions into length 2N+1 arrays, padding with zeros before for the first
-  // array, and with zeros after for the second array
-  for (i = 0; i < N - 1; i++) {
+  searchShiftedForMax (m_outShifted,
+                       binStartMax,
+                       corrMax);
+}
 
-    m_signalA [i] = 0.0;
-    m_signalB [i + N] = 0.0;
+void Correlation::correlateWithShiftMany (int N,
+                                          const double function1 [],
+                                          int numKernels,
+                                          const double functions2 [],
+                                          QVector<int> &binStartMax,
+                                          QVector<double> &corrMax) const
+{
+  LOG4CPP_DEBUG_S ((*mainCat)) << "Correlation::correlateWithShiftMany numKernels=" << numKernels;
+
+  Q_ASSERT (N == m_N);
+  Q_ASSERT (numKernels <= m_numKernels);
 
+  if (m_planManyB == 0) {
+    createPlansMany ();
   }
-  for (i = 0; i < N; i++) {
 
-    m_signalA [i + N - 1] = (function1 [i] - additiveNormalization1) * multiplicativeNormalization1;
-    m_signalB [i] = (function2 [i] - additiveNormalization2) * multiplicativeNormalization2;
+  int length = 2 * N - 1;
 
+  // Unused kernel slots are zeroed since the batch plan always transforms all of them
+  for (int i = numKernels * length; i < m_numKernels * length; i++) {
+    m_signalsMany [i] = 0.0;
+  }
+
+  loadReference (function1);
+  for (int kernel = 0; kernel < numKernels; kernel++) {
+    loadKernel (&functions2 [kernel * N],
+                &m_signalsMany [kernel * length]);
   }
 
   fftw_execute(m_planA);
-  fftw_execute(m_planB);
+  fftw_execute(m_planManyB);
 
-  // Correlation in frequency space
+  // Correlation in frequency space, overwriting the kernel spectra in place
   fftw_complex scale = 1.0/(2.0 * N - 1.0);
-  for (i = 0; i < 2 * N - 1; i++) {
-    m_out[i] = m_outA[i] * conj(m_outB[i]) * scale;
+  for (int kernel = 0; kernel < numKernels; kernel++) {
+    fftw_complex *outB = &m_outsMany [kernel * length];
+    for (int i = 0; i < length; i++) {
+      outB[i] = m_outA[i] * conj(outB[i]) * scale;
+    }
   }
 
-  fftw_execute(m_planX);
-
-  // Search for highest correlation. We have to account for the shift in the index. Specifically,
-  // 0 to N was mapped to the second half of the array that is 0 to 2 * N - 1
-  corrMax = 0.0;
-  for (int i0AtLeft = 0; i0AtLeft < N; i0AtLeft++) {
-
-    int i0AtCenter = (i0AtLeft + N) % (2 * N - 1);
-    fftw_complex shifted = m_outShifted [i0AtCenter];
-    double corr = qSqrt (creal (shifted) * creal (shifted) + cimag (shifted) * cimag (shifted));
+  fftw_execute(m_planManyX);
 
-    if ((i0AtLeft == 0) || (corr > corrMax)) {
-      binStartMax = i0AtLeft;
-      corrMax = corr;
-    }
+  binStartMax.resize (numKernels);
+  corrMax.resize (numKernels);
+  for (int kernel = 0; kernel < numKernels; kernel++) {
+    searchShiftedForMax (&m_outsShiftedMany [kernel * length],
+                         binStartMax [kernel],
+                         corrMax [kernel]);
   }
 }
 
@@ -120,3 +195,136 @@ void Correlation::correlateWithoutShift (int N,
     corrMax += function1 [i] * function2 [i];
   }
 }
+
+void Correlation::createPlansMany () const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Correlation::createPlansMany numKernels=" << m_numKernels;
+
+  int length = 2 * m_N - 1;
+  m_signalsMany = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * length * m_numKernels);
+  m_outsMany = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * length * m_numKernels);
+  m_outsShiftedMany = (fftw_complex *) fftw_malloc(sizeof(fftw_complex) * length * m_numKernels);
+
+  QMutexLocker locker (&mutexPlanner);
+
+  importWisdom ();
+
+  bool isNewWisdom = false;
+  m_planManyB = planDft (length, m_numKernels, m_signalsMany, m_outsMany, FFTW_FORWARD, isNewWisdom);
+  m_planManyX = planDft (length, m_numKernels, m_outsMany, m_outsShiftedMany, FFTW_BACKWARD, isNewWisdom);
+
+  if (isNewWisdom) {
+    exportWisdom ();
+  }
+}
+
+void Correlation::exportWisdom ()
+{
+  // The cache directory is only created when there is something to write into it
+  QDir ().mkpath (QFileInfo (wisdomFileName ()).path ());
+
+  QByteArray fileName = QFile::encodeName (wisdomFileName ());
+  if (!fftw_export_wisdom_to_filename (fileName.data ())) {
+
+    LOG4CPP_INFO_S ((*mainCat)) << "Correlation::exportWisdom could not write " << fileName.data ();
+  }
+}
+
+void Correlation::importWisdom ()
+{
+  if (!m_wisdomIsImported) {
+
+    m_wisdomIsImported = true;
+
+    // A missing file just means this is the first run, so the plans will be measured from scratch
+    QByteArray fileName = QFile::encodeName (wisdomFileName ());
+    if (QFile::exists (fileName)) {
+
+      bool success = fftw_import_wisdom_from_filename (fileName.data ());
+
+      LOG4CPP_INFO_S ((*mainCat)) << "Correlation::importWisdom file=" << fileName.data ()
+                                  << " success=" << (success ? "yes" : "no");
+    }
+  }
+}
+
+void Correlation::loadKernel (const double function [],
+                              fftw_complex signal []) const
+{
+  double additiveNormalization, multiplicativeNormalization;
+  normalizationConstants (function,
+                          additiveNormalization,
+                          multiplicativeNormalization);
+
+  // Load length N function into length 2N+1 array, padding with zeros after
+  int i;
+  for (i = 0; i < m_N - 1; i++) {
+    signal [i + m_N] = 0.0;
+  }
+  for (i = 0; i < m_N; i++) {
+    signal [i] = (function [i] - additiveNormalization) * multiplicativeNormalization;
+  }
+}
+
+void Correlation::loadReference (const double function []) const
+{
+  double additiveNormalization, multiplicativeNormalization;
+  normalizationConstants (function,
+                          additiveNormalization,
+                          multiplicativeNormalization);
+
+  // Load length N function into length 2N+1 array, padding with zeros before
+  int i;
+  for (i = 0; i < m_N - 1; i++) {
+    m_signalA [i] = 0.0;
+  }
+  for (i = 0; i < m_N; i++) {
+    m_signalA [i + m_N - 1] = (function [i] - additiveNormalization) * multiplicativeNormalization;
+  }
+}
+
+void Correlation::normalizationConstants (const double function [],
+                                          double &additiveNormalization,
+                                          double &multiplicativeNormalization) const
+{
+  // Normalize input function so that:
+  // 1) mean is zero. This is used to compute an additive normalization constant
+  // 2) max value is 1. This is used to compute a multiplicative normalization constant
+  double sumMean = 0, max = 0;
+  for (int i = 0; i < m_N; i++) {
+
+    sumMean += function [i];
+    max = qMax (max, function [i]);
+
+  }
+
+  additiveNormalization = sumMean / m_N;
+  multiplicativeNormalization = 1.0 / max;
+}
+
+void Correlation::searchShiftedForMax (const fftw_complex outShifted [],
+                                       int &binStartMax,
+                                       double &corrMax) const
+{
+  // Search for highest correlation. We have to account for the shift in the index. Specifically,
+  // 0 to N was mapped to the second half of the array that is 0 to 2 * N - 1
+  corrMax = 0.0;
+  for (int i0AtLeft = 0; i0AtLeft < m_N; i0AtLeft++) {
+
+    int i0AtCenter = (i0AtLeft + m_N) % (2 * m_N - 1);
+    fftw_complex shifted = outShifted [i0AtCenter];
+    double corr = qSqrt (creal (shifted) * creal (shifted) + cimag (shifted) * cimag (shifted));
+
+    if ((i0AtLeft == 0) || (corr > corrMax)) {
+      binStartMax = i0AtLeft;
+      corrMax = corr;
+    }
+  }
+}
+
+QString Correlation::wisdomFileName ()
+{
+  QString path = QStandardPaths::writableLocation (QStandardPaths::CacheLocation);
+
+  return QDir (path).filePath (WISDOM_FILE_NAME);
+}
@@ -2,13 +2,23 @@
 #define CORRELATION_H
 
 #include <fftw3.h>
+#include <QString>
+#include <QVector>
 
-/// Fast cross correlation between two functions
+/// Fast cross correlation between two functions, or between one reference function and a batch of kernel functions.
+///
+/// Plans are created with FFTW_MEASURE, which is slow the first time. To amortize that cost, FFTW wisdom is imported
+/// from a cache file before the first plan in this process is created, and exported only when a plan had to be
+/// measured, so later runs start with optimal plans. The large batch plans and buffers are only created when
+/// correlateWithShiftMany is first called. The FFTW planner is not thread safe, so all planning is serialized
 class Correlation
 {
 public:
-  /// Single constructor. Slow memory allocations are done once and then reused repeatedly.
-  Correlation(int N);
+  /// Single constructor. Slow memory allocations and planning are done once and then reused repeatedly. The
+  /// batch of kernels for correlateWithShiftMany is at most numKernels long, and its buffers and plans are created
+  /// on the first call to correlateWithShiftMany
+  Correlation(int N,
+              int numKernels = 1);
   ~Correlation();
 
   /// Return the shift in function1 that best aligns that function with function2. The functions
@@ -19,6 +29,16 @@ public:
                            int &binStartMax,
                            double &corrMax) const;
 
+  /// Batch version of correlateWithShift that correlates one reference function against numKernels kernel
+  /// functions, which are stored contiguously N values apart. The reference is transformed once, and the kernels are
+  /// transformed and inverse transformed together by a single plan. The functions are normalized internally.
+  void correlateWithShiftMany (int N,
+                               const double function1 [],
+                               int numKernels,
+                               const double functions2 [],
+                               QVector<int> &binStartMax,
+                               QVector<double> &corrMax) const;
+
   /// Return the correlation of the two functions, without any shift. The functions
   /// are normalized internally.
   void correlateWithoutShift (int N,
@@ -29,7 +49,22 @@ public:
 private:
   Correlation();
 
+  void createPlansMany () const;
+  static void exportWisdom ();
+  static void importWisdom ();
+  void loadKernel (const double function [],
+                   fftw_complex signal []) const;
+  void loadReference (const double function []) const;
+  void normalizationConstants (const double function [],
+                               double &additiveNormalization,
+                               double &multiplicativeNormalization) const;
+  void searchShiftedForMax (const fftw_complex outShifted [],
+                            int &binStartMax,
+                            double &corrMax) const;
+  static QString wisdomFileName ();
+
   int m_N;
+  int m_numKernels;
 
   fftw_complex *m_signalA;
   fftw_complex *m_signalB;
@@ -38,9 +73,18 @@ private:
   fftw_complex *m_outB;
   fftw_complex *m_out;
 
+  // Batch buffers, each with m_numKernels signals of length 2N-1 stored back to back. Null until createPlansMany
+  mutable fftw_complex *m_signalsMany;
+  mutable fftw_complex *m_outsMany;
+  mutable fftw_complex *m_outsShiftedMany;
+
   fftw_plan m_planA;
   fftw_plan m_planB;
   fftw_plan m_planX;
+  mutable fftw_plan m_planManyB; // Null until createPlansMany
+  mutable fftw_plan m_planManyX;
+
+  static bool m_wisdomIsImported; // Wisdom is imported once per process. Guarded by the planner mutex
 };
 
 #endif // CORRELATION_H
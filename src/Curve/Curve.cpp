@@ -1,26 +1,89 @@
+#include <cstring>
 #include "Curve.h"
 #include "CurvesGraphs.h"
 #include "Logger.h"
 #include "Point.h"
+#include <QDataStream>
 #include <QDebug>
+#include <QtEndian>
+#include <QVector>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 #include "Transformation.h"
 
 const QString AXIS_CURVE_NAME ("Axes");
 const QString DEFAULT_GRAPH_CURVE_NAME ("Curve1");
-const QString TAB_DELIMITER ("\t");
+
+const int BYTES_PER_VALUE_ESTIMATE = 20; // Typical formatted value plus its separator, for reserving the save buffer
+const int VALUE_PRECISION = 17; // Enough digits for every double to be read back exactly
+
+// Copy little endian doubles, which need not be aligned, such as those in a memory mapped file
+static void copyLittleEndianDoubles (const uchar *source,
+                                     int count,
+                                     double *destination)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+  memcpy (destination, source, count * sizeof (double));
+#else
+  for (int i = 0; i < count; i++) {
+    quint64 bits = qFromLittleEndian<quint64> (source + i * sizeof (double));
+    memcpy (&destination [i], &bits, sizeof (double));
+  }
+#endif
+}
 
 Curve::Curve(const QString &curveName,
              const LineStyle &lineStyle,
              const PointStyle &pointStyle) :
   m_curveName (curveName),
+  m_curveIndex (Point::curveIndexFromCurveName (curveName)),
+  m_numPoints (0),
+  m_graphVersion (0),
+  m_pointIdentifierToIndexIsValid (true),
   m_lineStyle (lineStyle),
   m_pointStyle (pointStyle)
 {
 }
 
+Curve::Curve (QXmlStreamReader &reader) :
+  m_curveName (reader.attributes ().value ("Name").toString ()),
+  m_curveIndex (Point::curveIndexFromCurveName (m_curveName)),
+  m_numPoints (0),
+  m_graphVersion (0),
+  m_pointIdentifierToIndexIsValid (false),
+  m_lineStyle (LineStyle::defaultGraphCurve (0)),
+  m_pointStyle (PointStyle::defaultGraphCurve (0))
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Curve::Curve curveName=" << m_curveName.toLatin1 ().data ();
+
+  if (m_curveName.isEmpty ()) {
+    reader.raiseError ("Curve has no name");
+    return;
+  }
+
+  while (reader.readNextStartElement ()) {
+
+    if (reader.name () == "LineStyle") {
+      m_lineStyle.loadStyle (reader);
+    } else if (reader.name () == "PointStyle") {
+      m_pointStyle.loadStyle (reader);
+    } else if (reader.name () == "Points") {
+      loadPoints (reader);
+    } else {
+      reader.skipCurrentElement ();
+    }
+  }
+}
+
 Curve::Curve (const Curve &curve) :
   m_curveName (curve.curveName ()),
-  m_points (curve.points ()),
+  m_curveIndex (curve.m_curveIndex),
+  m_chunks (curve.m_chunks),
+  m_chunksGraph (curve.m_chunksGraph),
+  m_numPoints (curve.m_numPoints),
+  m_transformation (curve.m_transformation),
+  m_graphVersion (curve.m_graphVersion),
+  m_pointIdentifierToIndexIsValid (false),
   m_lineStyle (curve.lineStyle ()),
   m_pointStyle (curve.pointStyle ())
 {
@@ -29,7 +92,14 @@ Curve::Curve (const Curve &curve) :
 Curve &Curve::operator=(const Curve &curve)
 {
   m_curveName = curve.curveName ();
-  m_points = curve.points ();
+  m_curveIndex = curve.m_curveIndex;
+  m_chunks = curve.m_chunks;
+  m_chunksGraph = curve.m_chunksGraph;
+  m_numPoints = curve.m_numPoints;
+  m_transformation = curve.m_transformation;
+  m_graphVersion = curve.m_graphVersion;
+  m_pointIdentifierToIndex.clear ();
+  m_pointIdentifierToIndexIsValid = false;
   m_lineStyle = curve.lineStyle ();
   m_pointStyle = curve.pointStyle ();
 
@@ -38,113 +108,278 @@ Curve &Curve::operator=(const Curve &curve)
 
 void Curve::addPoint (Point point)
 {
-  m_points.push_back (point);
+  Q_ASSERT (indexForPointIdentifier (point.identifier ()) < 0);
+
+  // Points are only appended to the last chunk, so earlier chunks stay shared with any copies
+  if (m_chunks.isEmpty () ||
+      (m_chunks.at (m_chunks.count () - 1)->count () >= CURVE_CHUNK_CAPACITY)) {
+
+    CurveChunkGraph chunkGraphNew;
+    chunkGraphNew.graphVersion = m_graphVersion;
+    m_chunks.push_back (QSharedDataPointer<CurveChunk> (new CurveChunk));
+    m_chunksGraph.push_back (chunkGraphNew);
+  }
+
+  int chunkIndex = m_chunks.count () - 1;
+  CurveChunk &chunk = *m_chunks [chunkIndex];
+  CurveChunkGraph &chunkGraph = m_chunksGraph [chunkIndex];
+
+  m_pointIdentifierToIndex [point.identifier ()] = chunkIndex * CURVE_CHUNK_CAPACITY + chunk.count ();
+
+  chunk.identifiers.push_back (point.identifier ());
+  chunk.xScreen.push_back (point.posScreen ().x ());
+  chunk.yScreen.push_back (point.posScreen ().y ());
+  chunkGraph.xGraph.push_back (point.posGraph ().x ());
+  chunkGraph.yGraph.push_back (point.posGraph ().y ());
+
+  ++m_numPoints;
+
+  invalidateGraphCoordinatesOfChunk (chunkIndex);
 }
 
-void Curve::applyTransformation (const Transformation &transformation)
+void Curve::appendColumns (int count,
+                           int columns,
+                           const uchar *data)
 {
-  QList<Point>::iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
+  LOG4CPP_INFO_S ((*mainCat)) << "Curve::appendColumns curveName=" << m_curveName.toLatin1 ().data ()
+                              << " count=" << count;
+
+  Q_ASSERT ((columns == CURVE_COLUMNS_SCREEN) || (columns == CURVE_COLUMNS_SCREEN_AND_GRAPH));
+
+  const uchar *xScreen = data;
+  const uchar *yScreen = xScreen + count * sizeof (double);
+  const uchar *xGraph = yScreen + count * sizeof (double);
+  const uchar *yGraph = xGraph + count * sizeof (double);
 
-    // Get current screen coordinates
-    Point &point = *itr;
-    QPointF posScreen = point.posScreen();
-    QPointF posGraph;
-    transformation.transform (posScreen,
-                              posGraph);
+  // One block of identifiers is reserved for all of the Points, rather than one identifier at a time
+  quint64 serialNext = Point::reserveIdentifierSerials (count);
 
-    // Overwrite old graph coordinates
-    point.setPosGraph (posGraph);
+  int indexFirst = 0;
+  while (indexFirst < count) {
+
+    if (m_chunks.isEmpty () ||
+        (m_chunks.at (m_chunks.count () - 1)->count () >= CURVE_CHUNK_CAPACITY)) {
+
+      CurveChunkGraph chunkGraphNew;
+      chunkGraphNew.graphVersion = m_graphVersion;
+      m_chunks.push_back (QSharedDataPointer<CurveChunk> (new CurveChunk));
+      m_chunksGraph.push_back (chunkGraphNew);
+    }
+
+    // Fill the rest of the last chunk, sizing its columns once. New graph coordinates are zero unless they are copied
+    int chunkIndex = m_chunks.count () - 1;
+    CurveChunk &chunk = *m_chunks [chunkIndex];
+    CurveChunkGraph &chunkGraph = m_chunksGraph [chunkIndex];
+    int offset = chunk.count ();
+    int countChunk = qMin (CURVE_CHUNK_CAPACITY - offset,
+                           count - indexFirst);
+    chunk.identifiers.resize (offset + countChunk);
+    chunk.xScreen.resize (offset + countChunk);
+    chunk.yScreen.resize (offset + countChunk);
+    chunkGraph.xGraph.resize (offset + countChunk);
+    chunkGraph.yGraph.resize (offset + countChunk);
+
+    for (int index = 0; index < countChunk; index++) {
+      chunk.identifiers [offset + index] = Point::identifierFromCurveIndex (m_curveIndex,
+                                                                           serialNext++);
+    }
+
+    int byteFirst = indexFirst * sizeof (double);
+    copyLittleEndianDoubles (xScreen + byteFirst, countChunk, chunk.xScreen.data () + offset);
+    copyLittleEndianDoubles (yScreen + byteFirst, countChunk, chunk.yScreen.data () + offset);
+    if (columns == CURVE_COLUMNS_SCREEN_AND_GRAPH) {
+      copyLittleEndianDoubles (xGraph + byteFirst, countChunk, chunkGraph.xGraph.data () + offset);
+      copyLittleEndianDoubles (yGraph + byteFirst, countChunk, chunkGraph.yGraph.data () + offset);
+    }
+
+    invalidateGraphCoordinatesOfChunk (chunkIndex);
+
+    indexFirst += countChunk;
+    m_numPoints += countChunk;
   }
+
+  // The identifier cache is rebuilt on the next lookup, rather than updated here one Point at a time
+  m_pointIdentifierToIndex.clear ();
+  m_pointIdentifierToIndexIsValid = false;
 }
 
-QString Curve::curveName () const
+void Curve::appendPointColumns (PointIdentifier identifier,
+                                const double *values,
+                                int columns)
 {
-  return  m_curveName;
+  if (m_chunks.isEmpty () ||
+      (m_chunks.at (m_chunks.count () - 1)->count () >= CURVE_CHUNK_CAPACITY)) {
+
+    CurveChunk *chunkNew = new CurveChunk;
+    chunkNew->identifiers.reserve (CURVE_CHUNK_CAPACITY);
+    chunkNew->xScreen.reserve (CURVE_CHUNK_CAPACITY);
+    chunkNew->yScreen.reserve (CURVE_CHUNK_CAPACITY);
+    m_chunks.push_back (QSharedDataPointer<CurveChunk> (chunkNew));
+
+    CurveChunkGraph chunkGraphNew;
+    chunkGraphNew.xGraph.reserve (CURVE_CHUNK_CAPACITY);
+    chunkGraphNew.yGraph.reserve (CURVE_CHUNK_CAPACITY);
+    m_chunksGraph.push_back (chunkGraphNew);
+  }
+
+  CurveChunk &chunk = *m_chunks [m_chunks.count () - 1];
+  CurveChunkGraph &chunkGraph = m_chunksGraph [m_chunksGraph.count () - 1];
+
+  chunk.identifiers.push_back (identifier);
+  chunk.xScreen.push_back (values [0]);
+  chunk.yScreen.push_back (values [1]);
+  chunkGraph.xGraph.push_back (columns == CURVE_COLUMNS_SCREEN_AND_GRAPH ? values [2] : 0);
+  chunkGraph.yGraph.push_back (columns == CURVE_COLUMNS_SCREEN_AND_GRAPH ? values [3] : 0);
+
+  ++m_numPoints;
 }
 
-void Curve::editPoint (const QPointF &posGraph,
-                       const QString &identifier)
+void Curve::appendPoints (const Curve &curve,
+                          QHash<PointIdentifier, bool> &identifiersAppended)
 {
-  // Search for the point with matching identifier
-  QList<Point>::iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
+  // The columns of each chunk of the other Curve are appended in blocks, and the Points keep their identifiers
+  for (int chunkIndexFrom = 0; chunkIndexFrom < curve.m_chunks.count (); chunkIndexFrom++) {
 
-    Point &point = *itr;
-    if (point.identifier () == identifier) {
+    const CurveChunk &chunkFrom = *curve.m_chunks.at (chunkIndexFrom);
+    const CurveChunkGraph &chunkGraphFrom = curve.m_chunksGraph.at (chunkIndexFrom);
+    int count = chunkFrom.count ();
 
-      point.setPosGraph (posGraph);
-      break;
+    int indexFirst = 0;
+    while (indexFirst < count) {
+
+      if (m_chunks.isEmpty () ||
+          (m_chunks.at (m_chunks.count () - 1)->count () >= CURVE_CHUNK_CAPACITY)) {
+
+        CurveChunkGraph chunkGraphNew;
+        chunkGraphNew.graphVersion = m_graphVersion;
+        m_chunks.push_back (QSharedDataPointer<CurveChunk> (new CurveChunk));
+        m_chunksGraph.push_back (chunkGraphNew);
+      }
+
+      int chunkIndex = m_chunks.count () - 1;
+      CurveChunk &chunk = *m_chunks [chunkIndex];
+      CurveChunkGraph &chunkGraph = m_chunksGraph [chunkIndex];
+      int offset = chunk.count ();
+      int countChunk = qMin (CURVE_CHUNK_CAPACITY - offset,
+                             count - indexFirst);
+
+      for (int index = indexFirst; index < indexFirst + countChunk; index++) {
+        Q_ASSERT (indexForPointIdentifier (chunkFrom.identifiers.at (index)) < 0);
+        identifiersAppended [chunkFrom.identifiers.at (index)] = true;
+      }
 
+      chunk.identifiers += chunkFrom.identifiers.mid (indexFirst, countChunk);
+      chunk.xScreen += chunkFrom.xScreen.mid (indexFirst, countChunk);
+      chunk.yScreen += chunkFrom.yScreen.mid (indexFirst, countChunk);
+      chunkGraph.xGraph += chunkGraphFrom.xGraph.mid (indexFirst, countChunk);
+      chunkGraph.yGraph += chunkGraphFrom.yGraph.mid (indexFirst, countChunk);
+
+      invalidateGraphCoordinatesOfChunk (chunkIndex);
+
+      indexFirst += countChunk;
+      m_numPoints += countChunk;
     }
   }
+
+  // The identifier cache is rebuilt on the next lookup, rather than updated here one Point at a time
+  m_pointIdentifierToIndex.clear ();
+  m_pointIdentifierToIndexIsValid = false;
 }
 
-void Curve::exportToClipboard (const QHash<QString, bool> &selectedHash,
-                               bool transformIsDefined,
-                               QTextStream &strCsv,
-                               QTextStream &strHtml,
-                               CurvesGraphs &curvesGraphs) const
+void Curve::applyTransformation (const QSharedPointer<const Transformation> &transformation)
 {
-  // This method assumes Copy is only allowed when Transformation is valid
+  // Graph coordinates are recomputed later by updateGraphCoordinates, and only if they are actually read
+  m_transformation = transformation;
+}
 
-  bool isFirst = true;
-  QList<Point>::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
+void Curve::capturePoints (const QHash<PointIdentifier, bool> &selectedHash,
+                           CurvesGraphs &curvesGraphsCaptured) const
+{
+  updateGraphCoordinates ();
 
-    const Point &point = *itr;
-    if (selectedHash.contains (point.identifier ())) {
+  Curve *curveCaptured = curvesGraphsCaptured.curveForCurveName (m_curveName);
 
-      if (isFirst) {
+  for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
 
-        // Insert headers to identify the points that follow
-        isFirst = false;
-        strCsv << "X" << TAB_DELIMITER << m_curveName << "\n";
-        strHtml << "<table>\n"
-                << "<tr><th>X</th><th>" << m_curveName << "</th></tr>\n";
-      }
+    const CurveChunk &chunk = *m_chunks.at (chunkIndex);
+    for (int index = 0; index < chunk.count (); index++) {
 
-      // Check if this curve already exists from a previously exported point
-      if (curvesGraphs.curveForCurveName (m_curveName) == 0) {
-        Curve curve(m_curveName,
-                    LineStyle::defaultAxesCurve (),
-                    PointStyle::defaultGraphCurve (curvesGraphs.numCurves ()));
-        curvesGraphs.addGraphCurveAtEnd(curve);
-      }
+      if (selectedHash.contains (chunk.identifiers.at (index))) {
 
-      double x = point.posScreen ().x (), y = point.posScreen ().y ();
-      if (transformIsDefined) {
-        x = point.posGraph ().x ();
-        y = point.posGraph ().y ();
-      }
+        if (curveCaptured == 0) {
 
-      // Add point to text going to clipboard
-      strCsv << x << TAB_DELIMITER << y << "\n";
-      strHtml << "<tr><td>" << x << "</td><td>" << y << "</td></tr>\n";
+          // First captured point from this Curve
+          curvesGraphsCaptured.addGraphCurveAtEnd (Curve (m_curveName,
+                                                          m_lineStyle,
+                                                          m_pointStyle));
+          curveCaptured = curvesGraphsCaptured.curveForCurveName (m_curveName);
+        }
 
-      // Add point to list for undo/redo
-      curvesGraphs.curveForCurveName (m_curveName)->addPoint (point);
+        curveCaptured->addPoint (pointAt (chunkIndex, index));
+      }
     }
   }
+}
+
+bool Curve::containsPoint (PointIdentifier pointIdentifier) const
+{
+  return indexForPointIdentifier (pointIdentifier) >= 0;
+}
+
+quint64 Curve::curveIndex () const
+{
+  return m_curveIndex;
+}
+
+QString Curve::curveName () const
+{
+  return  m_curveName;
+}
+
+void Curve::editPoint (const QPointF &posGraph,
+                       PointIdentifier identifier)
+{
+  int index = indexForPointIdentifier (identifier);
+  if (index >= 0) {
+
+    int chunkIndex = index / CURVE_CHUNK_CAPACITY;
+
+    // Pending graph coordinates must not later overwrite the edited value
+    updateGraphCoordinatesOfChunk (chunkIndex);
+
+    CurveChunkGraph &chunkGraph = m_chunksGraph [chunkIndex];
+    chunkGraph.xGraph [index % CURVE_CHUNK_CAPACITY] = posGraph.x ();
+    chunkGraph.yGraph [index % CURVE_CHUNK_CAPACITY] = posGraph.y ();
 
-  if (!isFirst) {
-    strHtml << "</table>\n";
   }
 }
 
-void Curve::iterateThroughCurvePoints (const Functor2wRet<const QString &, const Point&, CallbackSearchReturn> &ftorWithCallback) const
+bool Curve::graphCoordinatesAreStale () const
 {
-  QList<Point>::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
+  return !m_transformation.isNull () &&
+         m_transformation->transformIsDefined () &&
+         (m_transformation->version () != m_graphVersion);
+}
 
-    const Point &point = *itr;
+void Curve::invalidateGraphCoordinatesOfChunk (int chunkIndex)
+{
+  // Graph coordinates of graph curve points always follow from their screen coordinates, so after a screen coordinate
+  // changes the chunk is recomputed on the next read, even though the Transformation did not change. This does not
+  // apply to the axis curve, which never receives a Transformation and keeps the graph coordinates it is given
+  if (!m_transformation.isNull ()) {
 
-    CallbackSearchReturn rtn = ftorWithCallback (m_curveName, point);
+    m_chunksGraph [chunkIndex].graphVersion = 0;
+    m_graphVersion = 0;
+  }
+}
 
-    if (rtn == CALLBACK_SEARCH_RETURN_INTERRUPT) {
-      break;
-    }
+int Curve::indexForPointIdentifier (PointIdentifier pointIdentifier) const
+{
+  if (!m_pointIdentifierToIndexIsValid) {
+    rebuildPointIdentifierToIndex ();
   }
+
+  return m_pointIdentifierToIndex.value (pointIdentifier, -1);
 }
 
 LineStyle Curve::lineStyle () const
@@ -152,32 +387,154 @@ LineStyle Curve::lineStyle () const
   return m_lineStyle;
 }
 
-void Curve::movePoint (const QString &pointIdentifier,
+bool Curve::loadPointValue (const QStringRef &value,
+                            int columns,
+                            double *values,
+                            int &column,
+                            quint64 &serialNext)
+{
+  bool ok;
+  values [column++] = value.toDouble (&ok);
+
+  if (column == columns) {
+
+    appendPointColumns (Point::identifierFromCurveIndex (m_curveIndex,
+                                                         serialNext++),
+                        values,
+                        columns);
+    column = 0;
+  }
+
+  return ok;
+}
+
+void Curve::loadPoints (QXmlStreamReader &reader)
+{
+  QXmlStreamAttributes attributes = reader.attributes ();
+  int count = attributes.value ("Count").toString ().toInt ();
+  int columns = attributes.value ("Columns").toString ().toInt ();
+  if ((count < 0) ||
+      ((columns != CURVE_COLUMNS_SCREEN) && (columns != CURVE_COLUMNS_SCREEN_AND_GRAPH))) {
+    reader.raiseError (QString ("Points of curve %1 have an unknown layout").arg (m_curveName));
+    return;
+  }
+
+  int numChunks = m_chunks.count () + (count + CURVE_CHUNK_CAPACITY - 1) / CURVE_CHUNK_CAPACITY;
+  m_chunks.reserve (numChunks);
+  m_chunksGraph.reserve (numChunks);
+
+  // One block of identifiers is reserved for all of the Points, rather than one identifier at a time
+  quint64 serialNext = Point::reserveIdentifierSerials (count);
+  int numPointsBefore = m_numPoints;
+
+  // The values are parsed in place from the text of the reader. The text may arrive in more than one piece, so a
+  // value that runs up to the end of one piece is held until the next piece, or the end of the element, shows where
+  // it ends
+  double values [CURVE_COLUMNS_SCREEN_AND_GRAPH];
+  int column = 0;
+  bool ok = true;
+  QString valuePartial;
+  while (ok && !reader.atEnd ()) {
+
+    QXmlStreamReader::TokenType tokenType = reader.readNext ();
+    if (tokenType == QXmlStreamReader::Characters) {
+
+      QStringRef text = reader.text ();
+      const QChar *chars = text.unicode ();
+      int pos = 0;
+      while (ok && (pos < text.size ())) {
+
+        // A value that was cut off continues at the very start of this piece. Otherwise the separators are skipped
+        if (valuePartial.isEmpty ()) {
+          while ((pos < text.size ()) && chars [pos].isSpace ()) {
+            ++pos;
+          }
+        }
+
+        int start = pos;
+        while ((pos < text.size ()) && !chars [pos].isSpace ()) {
+          ++pos;
+        }
+
+        if (pos == text.size ()) {
+
+          valuePartial.append (chars + start, pos - start);
+
+        } else if (valuePartial.isEmpty ()) {
+
+          ok = loadPointValue (QStringRef (text.string (), text.position () + start, pos - start),
+                               columns,
+                               values,
+                               column,
+                               serialNext);
+
+        } else {
+
+          valuePartial.append (chars + start, pos - start);
+          ok = loadPointValue (QStringRef (&valuePartial),
+                               columns,
+                               values,
+                               column,
+                               serialNext);
+          valuePartial.clear ();
+        }
+      }
+
+    } else if (tokenType == QXmlStreamReader::StartElement) {
+
+      reader.skipCurrentElement (); // Nothing is nested inside the Points
+
+    } else if (tokenType == QXmlStreamReader::EndElement) {
+
+      if (!valuePartial.isEmpty ()) {
+        ok = loadPointValue (QStringRef (&valuePartial),
+                             columns,
+                             values,
+                             column,
+                             serialNext);
+      }
+      break;
+    }
+  }
+
+  if (!ok) {
+    reader.raiseError (QString ("Points of curve %1 have an invalid value").arg (m_curveName));
+  } else if ((column != 0) ||
+             (m_numPoints - numPointsBefore != count)) {
+    reader.raiseError (QString ("Curve %1 does not have the expected number of points").arg (m_curveName));
+  }
+}
+
+void Curve::movePoint (PointIdentifier pointIdentifier,
                        const QPointF &deltaScreen)
 {
-  Point *point = pointForPointIdentifier (pointIdentifier);
+  int index = indexForPointIdentifier (pointIdentifier);
+  Q_ASSERT (index >= 0);
+
+  // Only the chunk holding the point is detached from any copies
+  int chunkIndex = index / CURVE_CHUNK_CAPACITY;
+  CurveChunk &chunk = *m_chunks [chunkIndex];
+  chunk.xScreen [index % CURVE_CHUNK_CAPACITY] += deltaScreen.x ();
+  chunk.yScreen [index % CURVE_CHUNK_CAPACITY] += deltaScreen.y ();
 
-  QPointF posScreen = deltaScreen + point->posScreen ();
-  point->setPosScreen (posScreen);
+  invalidateGraphCoordinatesOfChunk (chunkIndex);
 }
 
 int Curve::numPoints () const
 {
-  return m_points.count ();
+  return m_numPoints;
 }
 
-Point *Curve::pointForPointIdentifier (const QString pointIdentifier)
+Point Curve::pointAt (int chunkIndex,
+                      int index) const
 {
-  Points::iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    Point &point = *itr;
-    if (pointIdentifier == point.identifier ()) {
-      return &point;
-    }
-  }
+  const CurveChunk &chunk = *m_chunks.at (chunkIndex);
+  const CurveChunkGraph &chunkGraph = m_chunksGraph.at (chunkIndex);
 
-  Q_ASSERT (false);
-  return 0;
+  return Point (m_curveName,
+                QPointF (chunk.xScreen.at (index), chunk.yScreen.at (index)),
+                chunk.identifiers.at (index),
+                QPointF (chunkGraph.xGraph.at (index), chunkGraph.yGraph.at (index)));
 }
 
 PointStyle Curve::pointStyle () const
@@ -185,35 +542,34 @@ PointStyle Curve::pointStyle () const
   return m_pointStyle;
 }
 
-QPointF Curve::positionGraph (const QString &pointIdentifier) const
+QPointF Curve::positionGraph (PointIdentifier pointIdentifier) const
 {
   QPointF posGraph;
 
-  // Search for point with matching identifier
-  Points::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    const Point &point = *itr;
-    if (pointIdentifier == point.identifier ()) {
-      posGraph = point.posGraph ();
-      break;
-    }
+  int index = indexForPointIdentifier (pointIdentifier);
+  if (index >= 0) {
+
+    int chunkIndex = index / CURVE_CHUNK_CAPACITY;
+    updateGraphCoordinatesOfChunk (chunkIndex);
+
+    const CurveChunkGraph &chunkGraph = m_chunksGraph.at (chunkIndex);
+    posGraph = QPointF (chunkGraph.xGraph.at (index % CURVE_CHUNK_CAPACITY),
+                        chunkGraph.yGraph.at (index % CURVE_CHUNK_CAPACITY));
   }
 
   return posGraph;
 }
 
-QPointF Curve::positionScreen (const QString &pointIdentifier) const
+QPointF Curve::positionScreen (PointIdentifier pointIdentifier) const
 {
   QPointF posScreen;
 
-  // Search for point with matching identifier
-  Points::const_iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    const Point &point = *itr;
-    if (pointIdentifier == point.identifier ()) {
-      posScreen = point.posScreen ();
-      break;
-    }
+  int index = indexForPointIdentifier (pointIdentifier);
+  if (index >= 0) {
+
+    const CurveChunk &chunk = *m_chunks.at (index / CURVE_CHUNK_CAPACITY);
+    posScreen = QPointF (chunk.xScreen.at (index % CURVE_CHUNK_CAPACITY),
+                         chunk.yScreen.at (index % CURVE_CHUNK_CAPACITY));
   }
 
   return posScreen;
@@ -221,25 +577,214 @@ QPointF Curve::positionScreen (const QString &pointIdentifier) const
 
 const Points Curve::points () const
 {
-  return m_points;
+  updateGraphCoordinates ();
+
+  Points points;
+  points.reserve (m_numPoints);
+
+  for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
+
+    int count = m_chunks.at (chunkIndex)->count ();
+    for (int index = 0; index < count; index++) {
+      points << pointAt (chunkIndex, index);
+    }
+  }
+
+  return points;
+}
+
+void Curve::positions (bool graph,
+                       QVector<double> &x,
+                       QVector<double> &y) const
+{
+  if (graph) {
+    updateGraphCoordinates ();
+  }
+
+  x.reserve (x.count () + m_numPoints);
+  y.reserve (y.count () + m_numPoints);
+
+  for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
+
+    if (graph) {
+      x += m_chunksGraph.at (chunkIndex).xGraph;
+      y += m_chunksGraph.at (chunkIndex).yGraph;
+    } else {
+      x += m_chunks.at (chunkIndex)->xScreen;
+      y += m_chunks.at (chunkIndex)->yScreen;
+    }
+  }
 }
 
-void Curve::removePoint (const QString &identifier)
+void Curve::rebuildPointIdentifierToIndex () const
 {
-  // Search for point with matching identifier
-  Points::iterator itr;
-  for (itr = m_points.begin (); itr != m_points.end (); itr++) {
-    Point point = *itr;
-    if (point.identifier () == identifier) {
-      m_points.erase (itr);
-      break;
+  m_pointIdentifierToIndex.clear ();
+  m_pointIdentifierToIndex.reserve (m_numPoints);
+
+  for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
+    reindexChunk (chunkIndex, 0);
+  }
+
+  m_pointIdentifierToIndexIsValid = true;
+}
+
+void Curve::reindexChunk (int chunkIndex,
+                          int indexStart) const
+{
+  const CurveChunk &chunk = *m_chunks.at (chunkIndex);
+  for (int index = indexStart; index < chunk.count (); index++) {
+    m_pointIdentifierToIndex [chunk.identifiers.at (index)] = chunkIndex * CURVE_CHUNK_CAPACITY + index;
+  }
+}
+
+void Curve::removePoint (PointIdentifier identifier)
+{
+  int index = indexForPointIdentifier (identifier);
+  if (index >= 0) {
+
+    int chunkIndex = index / CURVE_CHUNK_CAPACITY;
+    int indexInChunk = index % CURVE_CHUNK_CAPACITY;
+
+    m_pointIdentifierToIndex.remove (identifier);
+    --m_numPoints;
+
+    CurveChunk &chunk = *m_chunks [chunkIndex];
+    CurveChunkGraph &chunkGraph = m_chunksGraph [chunkIndex];
+    chunk.identifiers.remove (indexInChunk);
+    chunk.xScreen.remove (indexInChunk);
+    chunk.yScreen.remove (indexInChunk);
+    chunkGraph.xGraph.remove (indexInChunk);
+    chunkGraph.yGraph.remove (indexInChunk);
+
+    if (chunk.count () == 0) {
+
+      // Later chunks move down, which changes the locations of all of their points
+      m_chunks.remove (chunkIndex);
+      m_chunksGraph.remove (chunkIndex);
+      m_pointIdentifierToIndex.clear ();
+      m_pointIdentifierToIndexIsValid = false;
+
+    } else {
+
+      // Only the later points in the same chunk moved
+      reindexChunk (chunkIndex, indexInChunk);
+
+    }
+  }
+}
+
+void Curve::removePoints (const QHash<PointIdentifier, bool> &identifiers)
+{
+  CurveChunks chunksKept;
+  CurveChunksGraph chunksGraphKept;
+  chunksKept.reserve (m_chunks.count ());
+  chunksGraphKept.reserve (m_chunks.count ());
+
+  for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
+
+    // Chunks without any of the removed points are kept as is, so they stay shared with any copies
+    const CurveChunk &chunkConst = *m_chunks.at (chunkIndex);
+    int count = chunkConst.count ();
+    int indexFirst = 0;
+    while ((indexFirst < count) && !identifiers.contains (chunkConst.identifiers.at (indexFirst))) {
+      ++indexFirst;
+    }
+
+    if (indexFirst < count) {
+
+      // Compact the surviving points toward the front of every column, then drop the leftover tails
+      CurveChunk &chunk = *m_chunks [chunkIndex];
+      CurveChunkGraph &chunkGraph = m_chunksGraph [chunkIndex];
+      int indexOut = indexFirst;
+      for (int indexIn = indexFirst; indexIn < count; indexIn++) {
+        if (!identifiers.contains (chunk.identifiers.at (indexIn))) {
+          chunk.identifiers [indexOut] = chunk.identifiers.at (indexIn);
+          chunk.xScreen [indexOut] = chunk.xScreen.at (indexIn);
+          chunk.yScreen [indexOut] = chunk.yScreen.at (indexIn);
+          chunkGraph.xGraph [indexOut] = chunkGraph.xGraph.at (indexIn);
+          chunkGraph.yGraph [indexOut] = chunkGraph.yGraph.at (indexIn);
+          ++indexOut;
+        }
+      }
+
+      m_numPoints -= (count - indexOut);
+      chunk.identifiers.resize (indexOut);
+      chunk.xScreen.resize (indexOut);
+      chunk.yScreen.resize (indexOut);
+      chunkGraph.xGraph.resize (indexOut);
+      chunkGraph.yGraph.resize (indexOut);
+
+      m_pointIdentifierToIndexIsValid = false;
+    }
+
+    if (m_chunks.at (chunkIndex)->count () > 0) {
+      chunksKept.push_back (m_chunks.at (chunkIndex));
+      chunksGraphKept.push_back (m_chunksGraph.at (chunkIndex));
+    }
+  }
+
+  m_chunks = chunksKept;
+  m_chunksGraph = chunksGraphKept;
+
+  if (!m_pointIdentifierToIndexIsValid) {
+    m_pointIdentifierToIndex.clear ();
+  }
+}
+
+void Curve::saveXml (QXmlStreamWriter &stream) const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Curve::saveXml curveName=" << m_curveName.toLatin1 ().data ()
+                              << " points=" << m_numPoints;
+
+  bool isAxisCurve = (m_curveName == AXIS_CURVE_NAME);
+  int columns = (isAxisCurve ? CURVE_COLUMNS_SCREEN_AND_GRAPH : CURVE_COLUMNS_SCREEN);
+
+  stream.writeStartElement ("Curve");
+  stream.writeAttribute ("Name", m_curveName);
+  m_lineStyle.saveStyle (stream,
+                         m_curveName);
+  m_pointStyle.saveStyle (stream,
+                          m_curveName);
+
+  stream.writeStartElement ("Points");
+  stream.writeAttribute ("Count", QString::number (m_numPoints));
+  stream.writeAttribute ("Columns", QString::number (columns));
+
+  // Each chunk is formatted into a buffer that is reused, and handed to the writer before the next one, so the text
+  // of a large Curve is never held in memory all at once
+  QByteArray buffer;
+  buffer.reserve (CURVE_CHUNK_CAPACITY * columns * BYTES_PER_VALUE_ESTIMATE);
+  for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
+
+    const CurveChunk &chunk = *m_chunks.at (chunkIndex);
+    const CurveChunkGraph &chunkGraph = m_chunksGraph.at (chunkIndex);
+    buffer.resize (0);
+    for (int index = 0; index < chunk.count (); index++) {
+
+      buffer += QByteArray::number (chunk.xScreen.at (index), 'g', VALUE_PRECISION);
+      buffer += ' ';
+      buffer += QByteArray::number (chunk.yScreen.at (index), 'g', VALUE_PRECISION);
+      if (isAxisCurve) {
+        buffer += ' ';
+        buffer += QByteArray::number (chunkGraph.xGraph.at (index), 'g', VALUE_PRECISION);
+        buffer += ' ';
+        buffer += QByteArray::number (chunkGraph.yGraph.at (index), 'g', VALUE_PRECISION);
+      }
+      buffer += '\n';
     }
+
+    stream.writeCharacters (QString::fromLatin1 (buffer));
   }
+
+  stream.writeEndElement ();
+
+  stream.writeEndElement ();
 }
 
 void Curve::setCurveName (const QString &curveName)
 {
   m_curveName = curveName;
+  m_curveIndex = Point::curveIndexFromCurveName (curveName);
 }
 
 void Curve::setLineStyle (const LineStyle &lineStyle)
@@ -251,3 +796,70 @@ void Curve::setPointStyle (const PointStyle &pointStyle)
 {
   m_pointStyle = pointStyle;
 }
+
+void Curve::updateGraphCoordinates () const
+{
+  if (graphCoordinatesAreStale ()) {
+
+    for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
+      updateGraphCoordinatesOfChunk (chunkIndex);
+    }
+
+    m_graphVersion = m_transformation->version ();
+  }
+}
+
+void Curve::updateGraphCoordinatesOfChunk (int chunkIndex) const
+{
+  if (!m_transformation.isNull () &&
+      m_transformation->transformIsDefined ()) {
+
+    quint64 version = m_transformation->version ();
+    if (m_chunksGraph.at (chunkIndex).graphVersion != version) {
+
+      // Overwrite old graph coordinates in one pass over the screen coordinate columns of this chunk. The chunk itself
+      // is only read, so it stays shared with any copies
+      const CurveChunk &chunk = *m_chunks.at (chunkIndex);
+      CurveChunkGraph &chunkGraph = m_chunksGraph [chunkIndex];
+      m_transformation->transformManyColumns (chunk.count (),
+                                              chunk.xScreen.constData (),
+                                              chunk.yScreen.constData (),
+                                              chunkGraph.xGraph.data (),
+                                              chunkGraph.yGraph.data ());
+      chunkGraph.graphVersion = version;
+    }
+  }
+}
+
+void Curve::writeColumns (QDataStream &stream,
+                          int columns) const
+{
+  Q_ASSERT ((columns == CURVE_COLUMNS_SCREEN) || (columns == CURVE_COLUMNS_SCREEN_AND_GRAPH));
+  Q_ASSERT (stream.byteOrder () == QDataStream::LittleEndian);
+  Q_ASSERT (stream.floatingPointPrecision () == QDataStream::DoublePrecision);
+
+  updateGraphCoordinates ();
+
+  for (int column = 0; column < columns; column++) {
+
+    for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
+
+      const CurveChunk &chunk = *m_chunks.at (chunkIndex);
+      const CurveChunkGraph &chunkGraph = m_chunksGraph.at (chunkIndex);
+      const QVector<double> &values = (column == 0 ? chunk.xScreen :
+                                       (column == 1 ? chunk.yScreen :
+                                        (column == 2 ? chunkGraph.xGraph : chunkGraph.yGraph)));
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+      // The column is already in the layout of the file, so it is written as one block
+      stream.writeRawData ((const char *) values.constData (),
+                           values.count () * sizeof (double));
+#else
+      QVector<double>::const_iterator itrValue;
+      for (itrValue = values.constBegin (); itrValue != values.constEnd (); itrValue++) {
+        stream << *itrValue;
+      }
+#endif
+    }
+  }
+}
@@ -2,24 +2,63 @@
 #define CURVE_H
 
 #include "CallbackSearchReturn.h"
-#include "functor.h"
+#include "CurveChunk.h"
 #include "LineStyle.h"
 #include "Point.h"
 #include "PointStyle.h"
 #include <QHash>
 #include <QList>
+#include <QSharedDataPointer>
+#include <QSharedPointer>
 #include <QString>
+#include <QStringRef>
+#include <QVector>
 
 typedef QList<Point> Points;
 
+/// Hash from point identifier to the location of that Point in the Curve, encoded as
+/// chunk index * CURVE_CHUNK_CAPACITY + index within the chunk.
+typedef QHash<PointIdentifier, int> PointIdentifierToIndex;
+
+/// Implicitly shared CurveChunks, in point order.
+typedef QVector<QSharedDataPointer<CurveChunk> > CurveChunks;
+
+/// Graph coordinates of the CurveChunks, in the same order.
+typedef QVector<CurveChunkGraph> CurveChunksGraph;
+
+/// Number of saved columns for a graph curve. Only the screen coordinates are saved, since the graph coordinates
+/// follow from them.
+const int CURVE_COLUMNS_SCREEN = 2;
+
+/// Number of saved columns for the axis curve, which also saves the graph coordinates that were entered by the user.
+const int CURVE_COLUMNS_SCREEN_AND_GRAPH = 4;
+
 extern const QString AXIS_CURVE_NAME;
 extern const QString DEFAULT_GRAPH_CURVE_NAME;
 
 class CurvesGraphs;
-class QTextStream;
+class QDataStream;
+class QXmlStreamReader;
+class QXmlStreamWriter;
 class Transformation;
 
-/// Container for one set of digitized Points
+/// Container for one set of digitized Points. Points are kept in their original order, with a hash from identifier
+/// to index so the lookups by identifier (editing, moving, removing) do not scan the points.
+///
+/// The points are stored as columns (identifiers, screen x and y, graph x and y) in contiguous arrays rather than as
+/// a list of Point objects. This keeps the memory per point small, and lets applyTransformation run as one tight
+/// loop over the arrays that the compiler can vectorize. Point objects are only created on the fly, as views for
+/// the visitors and for points().
+///
+/// The columns are split into copy-on-write CurveChunks, so copies of a Curve share every chunk that has not been
+/// changed since the copy was made. The identifier hash is a cache that is not copied, and is rebuilt on the first
+/// lookup by identifier.
+///
+/// Graph coordinates are evaluated lazily. applyTransformation only records the Transformation, and the graph
+/// coordinate columns are recomputed the first time they are read afterwards, and only if the Transformation version
+/// differs from the one they were computed with. Dragging an axis point therefore no longer recomputes every point
+/// of every curve for each intermediate position. The graph columns are kept apart from the chunks (see
+/// CurveChunkGraph), so this never copies the chunks that are shared with the undo history
 class Curve
 {
 public:
@@ -28,7 +67,12 @@ public:
         const LineStyle &lineStyle,
         const PointStyle &pointStyle);
 
-  /// Copy constructor. Copying a Curve only helps for making a copy, since access to any Points inside must be via functor.
+  /// Constructor for a Curve read from a document file, with the reader at the start of the Curve element. The
+  /// Points are parsed straight into the columns, with capacity reserved from their saved count, and are given new
+  /// identifiers. Problems are reported by raising an error on the reader. See saveXml
+  Curve (QXmlStreamReader &reader);
+
+  /// Copy constructor. Copying a Curve only helps for making a copy, since access to any Points inside must be via visitor.
   Curve (const Curve &curve);
 
   /// Assignment constructor.
@@ -37,50 +81,94 @@ public:
   /// Add Point to this Curve.
   void addPoint (Point point);
 
-  /// Apply transformation that is stored and updated externally.
-  void applyTransformation (const Transformation &transformation);
+  /// Append count Points from columns of little endian doubles that follow each other in memory, such as in a memory
+  /// mapped binary document: screen x, screen y, and then graph x and graph y if columns is four. Each column is
+  /// copied into the chunks in blocks without any parsing, and the Points are given new identifiers. See
+  /// writeColumns.
+  void appendColumns (int count,
+                      int columns,
+                      const uchar *data);
+
+  /// Append all Points of the other Curve, keeping their identifiers, and add those identifiers to
+  /// identifiersAppended. The columns are copied in blocks, so restoring or pasting many Points costs one pass rather
+  /// than one addPoint per Point.
+  void appendPoints (const Curve &curve,
+                     QHash<PointIdentifier, bool> &identifiersAppended);
+
+  /// Apply transformation that is stored and updated externally. The Transformation is shared with the other Curves
+  /// of the same CurvesGraphs, and is only evaluated once the graph coordinates are needed.
+  void applyTransformation (const QSharedPointer<const Transformation> &transformation);
+
+  /// Copy the Points in this Curve whose identifiers are in the hash into the Curve with the same name in
+  /// curvesGraphsCaptured, which is added if it does not exist yet. This records points for undo without formatting
+  /// any text.
+  void capturePoints (const QHash<PointIdentifier, bool> &selectedHash,
+                      CurvesGraphs &curvesGraphsCaptured) const;
+
+  /// True if this Curve contains the specified Point.
+  bool containsPoint (PointIdentifier pointIdentifier) const;
+
+  /// Index of the name of this Curve, as held by the identifiers of its Points. See Point::curveIndexFromCurveName.
+  quint64 curveIndex () const;
 
   /// Name of this Curve.
   QString curveName () const;
 
   /// Edit the graph coordinates of an axis point. This method does not apply to a graph point
   void editPoint (const QPointF &posGraph,
-                  const QString &identifier);
+                  PointIdentifier identifier);
 
-  /// Export points in this Curve found in the specified point list.
-  void exportToClipboard (const QHash<QString, bool> &selectedHash,
-                          bool transformIsDefined,
-                          QTextStream &strCsv,
-                          QTextStream &strHtml,
-                          CurvesGraphs &curvesGraphs) const;
+  /// True if the graph coordinates are older than the last Transformation passed to applyTransformation.
+  bool graphCoordinatesAreStale () const;
 
-  /// Apply functor to Points on Curve.
-  void iterateThroughCurvePoints (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback) const;
+  /// Place of the specified Point along this Curve, or -1 if it is not in this Curve. Places increase along the Curve
+  /// but may skip values, since the chunks need not be full.
+  int indexForPointIdentifier (PointIdentifier pointIdentifier) const;
+
+  /// Apply visitor to Points on Curve. The visitor is any object with a method
+  /// CallbackSearchReturn callback (const QString &curveName, const Point &point), such as the Callback classes. The
+  /// call is resolved at compile time so it can be inlined, rather than going through a functor object per point.
+  /// Returns CALLBACK_SEARCH_RETURN_INTERRUPT if the visitor interrupted the iteration
+  template<typename Visitor>
+  CallbackSearchReturn iterateThroughCurvePoints (Visitor &visitor) const;
 
   /// Return the line style.
   LineStyle lineStyle () const;
 
   /// Translate the position of a point by the specified distance vector.
-  void movePoint (const QString &pointIdentifier,
+  void movePoint (PointIdentifier pointIdentifier,
                   const QPointF &deltaScreen);
 
   /// Number of points.
   int numPoints () const;
 
   /// Return the position, in graph coordinates, of the specified Point.
-  QPointF positionGraph (const QString &pointIdentifier) const;
+  QPointF positionGraph (PointIdentifier pointIdentifier) const;
 
   /// Return the position, in screen coordinates, of the specified Point.
-  QPointF positionScreen (const QString &pointIdentifier) const;
+  QPointF positionScreen (PointIdentifier pointIdentifier) const;
 
-  /// Return a shallow copy of the Points.
+  /// Return a copy of the Points, built from the columns.
   const Points points () const;
 
+  /// Append the positions of all Points, in order, to the x and y columns. The positions are in graph coordinates
+  /// if graph is true, and in screen coordinates otherwise. No Point objects are created.
+  void positions (bool graph,
+                  QVector<double> &x,
+                  QVector<double> &y) const;
+
   /// Return the point style.
   PointStyle pointStyle () const;
 
   /// Perform the opposite of addPointAtEnd.
-  void removePoint (const QString &identifier);
+  void removePoint (PointIdentifier identifier);
+
+  /// Remove all Points whose identifiers are in the hash, in a single pass that keeps the order of the remaining Points.
+  void removePoints (const QHash<PointIdentifier, bool> &identifiers);
+
+  /// Save the Curve, with its styles and Points, to the stream. The Points are formatted straight from the columns,
+  /// one chunk at a time, into text with one Point per line rather than an element per Point.
+  void saveXml (QXmlStreamWriter &stream) const;
 
   /// Change the curve name
   void setCurveName (const QString &curveName);
@@ -91,16 +179,78 @@ public:
   /// Set point style.
   void setPointStyle (const PointStyle &pointStyle);
 
+  /// Bring the graph coordinates up to date with the last Transformation passed to applyTransformation, if they
+  /// are stale. Reads call this automatically. Different Curves may be updated in parallel, but one Curve must not be
+  /// updated or read by two threads at once
+  void updateGraphCoordinates () const;
+
+  /// Write the coordinates of all Points to the stream as columns of doubles, one column after the other, in the
+  /// layout read by appendColumns. The graph columns are only written if columns is four.
+  void writeColumns (QDataStream &stream,
+                     int columns) const;
+
 private:
   Curve();
 
-  Point *pointForPointIdentifier (const QString pointIdentifier);
+  void appendPointColumns (PointIdentifier identifier,
+                           const double *values,
+                           int columns);
+  void invalidateGraphCoordinatesOfChunk (int chunkIndex);
+  bool loadPointValue (const QStringRef &value,
+                       int columns,
+                       double *values,
+                       int &column,
+                       quint64 &serialNext);
+  void loadPoints (QXmlStreamReader &reader);
+  Point pointAt (int chunkIndex,
+                 int index) const;
+  void rebuildPointIdentifierToIndex () const;
+  void reindexChunk (int chunkIndex,
+                     int indexStart) const;
+  void updateGraphCoordinatesOfChunk (int chunkIndex) const;
 
   QString m_curveName;
-  Points m_points;
+  quint64 m_curveIndex;
+
+  // Point columns, split into chunks, and the graph coordinates of each chunk. The graph coordinates are evaluated
+  // lazily, so they are mutable
+  CurveChunks m_chunks;
+  mutable CurveChunksGraph m_chunksGraph;
+  int m_numPoints;
+
+  // Last Transformation from applyTransformation, and the version of the Transformation that all of the chunks are
+  // known to be up to date with
+  QSharedPointer<const Transformation> m_transformation;
+  mutable quint64 m_graphVersion;
+
+  // Cache for lookups by identifier. Only valid when m_pointIdentifierToIndexIsValid is true
+  mutable PointIdentifierToIndex m_pointIdentifierToIndex;
+  mutable bool m_pointIdentifierToIndexIsValid;
 
   LineStyle m_lineStyle;
   PointStyle m_pointStyle;
 };
 
+template<typename Visitor>
+CallbackSearchReturn Curve::iterateThroughCurvePoints (Visitor &visitor) const
+{
+  updateGraphCoordinates ();
+
+  for (int chunkIndex = 0; chunkIndex < m_chunks.count (); chunkIndex++) {
+
+    int count = m_chunks.at (chunkIndex)->count ();
+    for (int index = 0; index < count; index++) {
+
+      CallbackSearchReturn rtn = visitor.callback (m_curveName,
+                                                   pointAt (chunkIndex, index));
+
+      if (rtn == CALLBACK_SEARCH_RETURN_INTERRUPT) {
+        return rtn;
+      }
+    }
+  }
+
+  return CALLBACK_SEARCH_RETURN_CONTINUE;
+}
+
 #endif // CURVE_H
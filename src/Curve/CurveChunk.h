@@ -0,0 +1,56 @@
+#ifndef CURVE_CHUNK_H
+#define CURVE_CHUNK_H
+
+#include "PointIdentifier.h"
+#include <QSharedData>
+#include <QVector>
+
+/// Maximum number of points in one CurveChunk. Small enough that detaching one chunk for an edit is cheap, and large
+/// enough that the list of chunks in each Curve stays short
+const int CURVE_CHUNK_CAPACITY = 1024;
+
+/// Block of consecutive points in a Curve, stored as columns. Entry i of every column belongs to the same point.
+///
+/// Chunks are implicitly shared through QSharedDataPointer, so copying a Curve (into an undo command or a snapshot
+/// of CurvesGraphs) only copies the chunk pointers. A chunk is copied only when a point inside it changes while it
+/// is shared, so undo history grows with the size of each edit rather than the size of the document
+class CurveChunk : public QSharedData
+{
+public:
+  /// Point identifiers.
+  QVector<PointIdentifier> identifiers;
+
+  /// Screen x coordinates.
+  QVector<double> xScreen;
+
+  /// Screen y coordinates.
+  QVector<double> yScreen;
+
+  /// Number of points in this chunk.
+  int count () const { return identifiers.count (); }
+};
+
+/// Graph coordinates of the points in the CurveChunk with the same index. For a graph curve they are a cache that is
+/// recomputed by const reads, so the Curve keeps them next to its chunks rather than inside them. Recomputing them
+/// then only replaces these columns, and never detaches the identifiers and screen coordinates that are shared with
+/// copies of the Curve
+class CurveChunkGraph
+{
+public:
+  /// Graph x coordinates.
+  QVector<double> xGraph;
+
+  /// Graph y coordinates.
+  QVector<double> yGraph;
+
+  /// Version of the Transformation that xGraph and yGraph were computed with, or zero if they were never computed.
+  quint64 graphVersion;
+
+  /// Single constructor.
+  CurveChunkGraph() :
+    graphVersion (0)
+  {
+  }
+};
+
+#endif // CURVE_CHUNK_H
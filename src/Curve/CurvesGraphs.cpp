@@ -1,46 +1,65 @@
 #include "Curve.h"
 #include "CurvesGraphs.h"
 #include "Point.h"
+#include <QtConcurrentMap>
 #include <QTextStream>
 #include "Transformation.h"
 
+// Wrapper so QtConcurrent can update one Curve per thread
+static void updateGraphCoordinatesOfCurve (const Curve *curve)
+{
+  curve->updateGraphCoordinates ();
+}
+
 CurvesGraphs::CurvesGraphs()
 {
 }
 
 void CurvesGraphs::addGraphCurveAtEnd (Curve curve)
 {
+  Q_ASSERT (!m_curveNameToIndex.contains (curve.curveName ()));
+
+  m_curveNameToIndex [curve.curveName ()] = m_curvesGraphs.count ();
+  m_curveIndexToIndex [curve.curveIndex ()] = m_curvesGraphs.count ();
   m_curvesGraphs.push_back (curve);
 }
 
 void CurvesGraphs::addPoint (const Point &point)
 {
-  QString curveName = Point::curveNameFromPointIdentifier (point.identifier());
-
-  Curve *curve = curveForCurveName (curveName);
+  Curve *curve = curveForPointIdentifier (point.identifier ());
   curve->addPoint (point);
 }
 
 void CurvesGraphs::applyTransformation (const Transformation &transformation)
 {
+  // One immutable copy is shared by all of the curves, and by their copies in the undo stack
+  QSharedPointer<const Transformation> transformationShared (new Transformation (transformation));
+
   CurveList::iterator itr;
   for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
 
     Curve &curve = *itr;
-    curve.applyTransformation (transformation);
+    curve.applyTransformation (transformationShared);
   }
 }
 
-Curve *CurvesGraphs::curveForCurveName (const QString &curveName)
+void CurvesGraphs::capturePoints (const QHash<PointIdentifier, bool> &selectedHash,
+                                  CurvesGraphs &curvesGraphsCaptured) const
 {
-  // Search for curve with matching name
-  CurveList::iterator itr;
+  CurveList::const_iterator itr;
   for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
 
-    Curve &curve = *itr;
-    if (curveName == curve.curveName ()) {
-      return &curve;
-    }
+    const Curve &curve = *itr;
+    curve.capturePoints (selectedHash,
+                         curvesGraphsCaptured);
+  }
+}
+
+Curve *CurvesGraphs::curveForCurveName (const QString &curveName)
+{
+  int index = indexForCurveName (curveName);
+  if (index >= 0) {
+    return &m_curvesGraphs [index];
   }
 
   return 0;
@@ -48,14 +67,29 @@ Curve *CurvesGraphs::curveForCurveName (const QString &curveName)
 
 const Curve *CurvesGraphs::curveForCurveName (const QString &curveName) const
 {
-  // Search for curve with matching name
-  CurveList::const_iterator itr;
-  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
+  int index = indexForCurveName (curveName);
+  if (index >= 0) {
+    return &m_curvesGraphs.at (index);
+  }
 
-    const Curve &curve = *itr;
-    if (curveName == curve.curveName ()) {
-      return &curve;
-    }
+  return 0;
+}
+
+Curve *CurvesGraphs::curveForPointIdentifier (PointIdentifier pointIdentifier)
+{
+  int index = m_curveIndexToIndex.value (Point::curveIndexFromPointIdentifier (pointIdentifier), -1);
+  if (index >= 0) {
+    return &m_curvesGraphs [index];
+  }
+
+  return 0;
+}
+
+const Curve *CurvesGraphs::curveForPointIdentifier (PointIdentifier pointIdentifier) const
+{
+  int index = m_curveIndexToIndex.value (Point::curveIndexFromPointIdentifier (pointIdentifier), -1);
+  if (index >= 0) {
+    return &m_curvesGraphs.at (index);
   }
 
   return 0;
@@ -77,56 +111,90 @@ QStringList CurvesGraphs::curvesGraphsNames () const
 
 int CurvesGraphs::curvesGraphsNumPoints (const QString &curveName) const
 {
-  // Search for curve with matching name
-  CurveList::const_iterator itr;
-  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
-
-    const Curve &curve = *itr;
-    if (curve.curveName () == curveName) {
-      return curve.numPoints ();
-    }
+  const Curve *curve = curveForCurveName (curveName);
+  if (curve != 0) {
+    return curve->numPoints ();
   }
 
   return 0;
 }
 
-void CurvesGraphs::iterateThroughCurvePoints (const QString &curveNameWanted,
-                                              const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
+int CurvesGraphs::indexForCurveName (const QString &curveName) const
 {
-  // Search for curve with matching name
+  int index = m_curveNameToIndex.value (curveName, -1);
+
+  // Curve names are only changed before a Curve is added, so the index always points at the same name
+  Q_ASSERT ((index < 0) || (m_curvesGraphs.at (index).curveName () == curveName));
+
+  return index;
+}
+
+int CurvesGraphs::numCurves () const
+{
+  return m_curvesGraphs.count ();
+}
+
+int CurvesGraphs::numPoints () const
+{
+  int count = 0;
+
   CurveList::const_iterator itr;
   for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
 
     const Curve &curve = *itr;
-    if (curve.curveName () == curveNameWanted) {
-
-      curve.iterateThroughCurvePoints (ftorWithCallback);
-      return;
-    }
+    count += curve.numPoints ();
   }
 
-  Q_ASSERT (false);
+  return count;
 }
 
-void CurvesGraphs::iterateThroughCurvesPoints (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
+void CurvesGraphs::removePoint (PointIdentifier pointIdentifier)
 {
-  CurveList::const_iterator itr;
+  Curve *curve = curveForPointIdentifier (pointIdentifier);
+  curve->removePoint (pointIdentifier);
+}
+
+void CurvesGraphs::removePoints (const QHash<PointIdentifier, bool> &identifiers)
+{
+  CurveList::iterator itr;
   for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
 
-    const Curve &curve = *itr;
-    curve.iterateThroughCurvePoints (ftorWithCallback);
+    Curve &curve = *itr;
+    curve.removePoints (identifiers);
   }
 }
 
-int CurvesGraphs::numCurves () const
+void CurvesGraphs::saveXml (QXmlStreamWriter &stream) const
 {
-  return m_curvesGraphs.count ();
+  CurveList::const_iterator itr;
+  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
+    const Curve &curve = *itr;
+    curve.saveXml (stream);
+  }
 }
 
-void CurvesGraphs::removePoint (const QString &pointIdentifier)
+void CurvesGraphs::updateGraphCoordinates () const
 {
-  QString curveName = Point::curveNameFromPointIdentifier(pointIdentifier);
+  QList<const Curve*> curvesStale;
 
-  Curve *curve = curveForCurveName (curveName);
-  curve->removePoint (pointIdentifier);
+  CurveList::const_iterator itr;
+  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
+
+    const Curve &curve = *itr;
+    if (curve.graphCoordinatesAreStale ()) {
+      curvesStale << &curve;
+    }
+  }
+
+  if (curvesStale.count () > 1) {
+
+    // Each Curve has its own columns, so the Curves can be updated independently
+    QtConcurrent::blockingMap (curvesStale,
+                               updateGraphCoordinatesOfCurve);
+
+  } else if (curvesStale.count () == 1) {
+
+    curvesStale.first ()->updateGraphCoordinates ();
+
+  }
 }
@@ -3,10 +3,13 @@
 
 #include "CallbackSearchReturn.h"
 #include "Curve.h"
+#include <QHash>
 #include <QList>
 #include <QStringList>
+#include <QtConcurrentMap>
 
 class Point;
+class QXmlStreamWriter;
 class Transformation;
 
 typedef QList<Curve> CurveList;
@@ -23,37 +26,145 @@ public:
   /// Append new Point to the specified Curve.
   void addPoint (const Point &point);
 
-  /// Apply transformation to all curves.
+  /// Apply transformation to all curves. The graph coordinates are only recomputed when they are next read, see
+  /// Curve::updateGraphCoordinates.
   void applyTransformation (const Transformation &transformation);
 
+  /// Copy the Points whose identifiers are in the hash into curvesGraphsCaptured, curve by curve. See
+  /// Curve::capturePoints.
+  void capturePoints (const QHash<PointIdentifier, bool> &selectedHash,
+                      CurvesGraphs &curvesGraphsCaptured) const;
+
   /// Return the axis or graph curve for the specified curve name.
   Curve *curveForCurveName (const QString &curveName);
 
   /// Return the axis or graph curve for the specified curve name.
   const Curve *curveForCurveName (const QString &curveName) const;
 
+  /// Return the graph curve that the specified Point belongs to, by the curve index in its identifier rather than by
+  /// name. Returns null if there is no such curve.
+  Curve *curveForPointIdentifier (PointIdentifier pointIdentifier);
+
+  /// Return the graph curve that the specified Point belongs to, by the curve index in its identifier rather than by
+  /// name. Returns null if there is no such curve.
+  const Curve *curveForPointIdentifier (PointIdentifier pointIdentifier) const;
+
   /// List of graph curve names.
   QStringList curvesGraphsNames () const;
 
   /// Point count.
   int curvesGraphsNumPoints (const QString &curveName) const;
 
-  /// Apply functor to Points in the specified axis or graph Curve.
-  void iterateThroughCurvePoints (const QString &curveNameWanted,
-                                  const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback);
+  /// Apply visitor to Points in the specified axis or graph Curve. See Curve::iterateThroughCurvePoints.
+  template<typename Visitor>
+  CallbackSearchReturn iterateThroughCurvePoints (const QString &curveNameWanted,
+                                                  Visitor &visitor) const;
+
+  /// Apply visitor to Points on all of the Curves, stopping at the first Curve in which the visitor interrupts.
+  /// Curves with stale graph coordinates are first brought up to date in parallel, one Curve per thread.
+  template<typename Visitor>
+  CallbackSearchReturn iterateThroughCurvesPoints (Visitor &visitor) const;
 
-  /// Apply functor to Points on all of the Curves.
-  void iterateThroughCurvesPoints (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback);
+  /// Read-only variant of iterateThroughCurvesPoints that visits the Curves concurrently, one Curve per thread. Each
+  /// Curve gets its own copy of the prototype visitor so the visitors need no locking, and the copies are returned
+  /// in Curve order for the caller to combine. An interrupt only ends the visit of the Curve it occurs in
+  template<typename Visitor>
+  QList<Visitor> iterateThroughCurvesPointsConcurrently (const Visitor &prototype) const;
 
   /// Current number of graphs curves.
   int numCurves () const;
 
+  /// Total number of points in all of the graph curves.
+  int numPoints () const;
+
   /// Remove the Point from its Curve.
-  void removePoint (const QString &pointIdentifier);
+  void removePoint (PointIdentifier pointIdentifier);
+
+  /// Remove all Points whose identifiers are in the hash, with one pass through each Curve.
+  void removePoints (const QHash<PointIdentifier, bool> &identifiers);
+
+  /// Save all of the graph curves to the stream. See Curve::saveXml.
+  void saveXml (QXmlStreamWriter &stream) const;
 
 private:
 
+  int indexForCurveName (const QString &curveName) const;
+  void updateGraphCoordinates () const;
+
   CurveList m_curvesGraphs;
+
+  // Hashes from curve name, and from curve index (see Point::curveIndexFromCurveName), to index in m_curvesGraphs.
+  // Curves are only appended, so entries never go stale
+  QHash<QString, int> m_curveNameToIndex;
+  QHash<quint64, int> m_curveIndexToIndex;
 };
 
+/// Visit of one Curve by one visitor, for CurvesGraphs::iterateThroughCurvesPointsConcurrently.
+template<typename Visitor>
+struct CurvesGraphsVisit
+{
+  /// Curve to visit.
+  const Curve *curve;
+
+  /// Visitor owned by the caller.
+  Visitor *visitor;
+};
+
+// Wrapper so QtConcurrent can visit one Curve per thread
+template<typename Visitor>
+void curvesGraphsVisitCurve (CurvesGraphsVisit<Visitor> &visit)
+{
+  visit.curve->iterateThroughCurvePoints (*visit.visitor);
+}
+
+template<typename Visitor>
+CallbackSearchReturn CurvesGraphs::iterateThroughCurvePoints (const QString &curveNameWanted,
+                                                              Visitor &visitor) const
+{
+  const Curve *curve = curveForCurveName (curveNameWanted);
+  Q_ASSERT (curve != 0);
+
+  return curve->iterateThroughCurvePoints (visitor);
+}
+
+template<typename Visitor>
+CallbackSearchReturn CurvesGraphs::iterateThroughCurvesPoints (Visitor &visitor) const
+{
+  updateGraphCoordinates ();
+
+  CurveList::const_iterator itr;
+  for (itr = m_curvesGraphs.begin (); itr != m_curvesGraphs.end (); itr++) {
+
+    const Curve &curve = *itr;
+    if (curve.iterateThroughCurvePoints (visitor) == CALLBACK_SEARCH_RETURN_INTERRUPT) {
+      return CALLBACK_SEARCH_RETURN_INTERRUPT;
+    }
+  }
+
+  return CALLBACK_SEARCH_RETURN_CONTINUE;
+}
+
+template<typename Visitor>
+QList<Visitor> CurvesGraphs::iterateThroughCurvesPointsConcurrently (const Visitor &prototype) const
+{
+  updateGraphCoordinates ();
+
+  QList<Visitor> visitors;
+  for (int i = 0; i < m_curvesGraphs.count (); i++) {
+    visitors << prototype;
+  }
+
+  // QList keeps each element at a fixed address, so the visits can point into it
+  QVector<CurvesGraphsVisit<Visitor> > visits (m_curvesGraphs.count ());
+  for (int i = 0; i < m_curvesGraphs.count (); i++) {
+    visits [i].curve = &m_curvesGraphs.at (i);
+    visits [i].visitor = &visitors [i];
+  }
+
+  QtConcurrent::blockingMap (visits,
+                             curvesGraphsVisitCurve<Visitor>);
+
+  return visitors;
+}
+
 #endif // CURVES_GRAPHS_H
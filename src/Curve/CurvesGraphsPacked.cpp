@@ -0,0 +1,172 @@
+#include "Curve.h"
+#include "CurvesGraphsPacked.h"
+#include <QDataStream>
+#include <QVector>
+
+// Bytes held by each uncompressed Point, which has an identifier and four coordinates
+const int BYTES_PER_POINT = sizeof (PointIdentifier) + 4 * sizeof (double);
+
+CurvesGraphsPacked::CurvesGraphsPacked() :
+  m_numPoints (0),
+  m_isCompressed (false)
+{
+}
+
+int CurvesGraphsPacked::byteCount () const
+{
+  if (m_isCompressed) {
+    return sizeof (CurvesGraphsPacked) + m_bytes.size ();
+  }
+
+  return sizeof (CurvesGraphsPacked) + m_curvesGraphs.numPoints () * BYTES_PER_POINT;
+}
+
+void CurvesGraphsPacked::clear ()
+{
+  m_curvesGraphs = CurvesGraphs ();
+  m_bytes.clear ();
+  m_numPoints = 0;
+  m_isCompressed = false;
+}
+
+void CurvesGraphsPacked::compress ()
+{
+  if (m_isCompressed) {
+    return;
+  }
+
+  QByteArray bytes;
+  QDataStream stream (&bytes, QIODevice::WriteOnly);
+  stream.setByteOrder (QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision (QDataStream::DoublePrecision);
+
+  QStringList curveNames = m_curvesGraphs.curvesGraphsNames ();
+  stream << (quint32) curveNames.count ();
+
+  QStringList::const_iterator itrName;
+  for (itrName = curveNames.begin (); itrName != curveNames.end (); itrName++) {
+
+    const Curve *curve = m_curvesGraphs.curveForCurveName (*itrName);
+    LineStyle lineStyle = curve->lineStyle ();
+    PointStyle pointStyle = curve->pointStyle ();
+
+    stream << curve->curveName ()
+           << (quint32) lineStyle.width ()
+           << (quint32) lineStyle.paletteColor ()
+           << (quint32) lineStyle.curveConnectAs ()
+           << (quint32) pointStyle.shape ()
+           << (quint32) pointStyle.radius ()
+           << (quint32) pointStyle.paletteColor ()
+           << pointStyle.lineWidth ()
+           << (quint32) curve->numPoints ();
+
+    // Each column is written in turn, since similar values next to each other compress better
+    const Points points = curve->points ();
+    Points::const_iterator itr;
+    for (itr = points.begin (); itr != points.end (); itr++) {
+      stream << itr->identifier ();
+    }
+    for (itr = points.begin (); itr != points.end (); itr++) {
+      stream << itr->posScreen ().x ();
+    }
+    for (itr = points.begin (); itr != points.end (); itr++) {
+      stream << itr->posScreen ().y ();
+    }
+    for (itr = points.begin (); itr != points.end (); itr++) {
+      stream << itr->posGraph ().x ();
+    }
+    for (itr = points.begin (); itr != points.end (); itr++) {
+      stream << itr->posGraph ().y ();
+    }
+  }
+
+  m_numPoints = m_curvesGraphs.numPoints ();
+  m_bytes = qCompress (bytes);
+  m_curvesGraphs = CurvesGraphs ();
+  m_isCompressed = true;
+}
+
+CurvesGraphs &CurvesGraphsPacked::curvesGraphs ()
+{
+  uncompress ();
+
+  return m_curvesGraphs;
+}
+
+bool CurvesGraphsPacked::isCompressed () const
+{
+  return m_isCompressed;
+}
+
+int CurvesGraphsPacked::numPoints () const
+{
+  if (m_isCompressed) {
+    return m_numPoints;
+  }
+
+  return m_curvesGraphs.numPoints ();
+}
+
+void CurvesGraphsPacked::uncompress ()
+{
+  if (!m_isCompressed) {
+    return;
+  }
+
+  QByteArray bytes = qUncompress (m_bytes);
+  QDataStream stream (bytes);
+  stream.setByteOrder (QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision (QDataStream::DoublePrecision);
+
+  quint32 curveCount;
+  stream >> curveCount;
+
+  for (quint32 curveIndex = 0; curveIndex < curveCount; curveIndex++) {
+
+    QString curveName;
+    quint32 lineWidth, lineColor, connectAs, pointShape, pointRadius, pointColor, count;
+    double pointLineWidth;
+    stream >> curveName >> lineWidth >> lineColor >> connectAs >> pointShape >> pointRadius >> pointColor
+           >> pointLineWidth >> count;
+
+    QVector<PointIdentifier> identifiers (count);
+    QVector<double> xScreen (count), yScreen (count), xGraph (count), yGraph (count);
+    for (quint32 index = 0; index < count; index++) {
+      stream >> identifiers [index];
+    }
+    for (quint32 index = 0; index < count; index++) {
+      stream >> xScreen [index];
+    }
+    for (quint32 index = 0; index < count; index++) {
+      stream >> yScreen [index];
+    }
+    for (quint32 index = 0; index < count; index++) {
+      stream >> xGraph [index];
+    }
+    for (quint32 index = 0; index < count; index++) {
+      stream >> yGraph [index];
+    }
+
+    Curve curve (curveName,
+                 LineStyle (lineWidth,
+                            (ColorPalette) lineColor,
+                            (CurveConnectAs) connectAs),
+                 PointStyle ((PointShape) pointShape,
+                             pointRadius,
+                             pointLineWidth,
+                             (ColorPalette) pointColor));
+    for (quint32 index = 0; index < count; index++) {
+      curve.addPoint (Point (curveName,
+                             QPointF (xScreen.at (index), yScreen.at (index)),
+                             identifiers.at (index),
+                             QPointF (xGraph.at (index), yGraph.at (index))));
+    }
+
+    m_curvesGraphs.addGraphCurveAtEnd (curve);
+  }
+
+  Q_ASSERT (stream.status () == QDataStream::Ok);
+
+  m_bytes.clear ();
+  m_isCompressed = false;
+}
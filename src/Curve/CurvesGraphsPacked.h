@@ -0,0 +1,45 @@
+#ifndef CURVES_GRAPHS_PACKED_H
+#define CURVES_GRAPHS_PACKED_H
+
+#include "CurvesGraphs.h"
+#include <QByteArray>
+
+/// Points captured by an undo command, such as those removed by a cut, in a form that can be compressed. While
+/// compressed, the Curves are held as a single compressed block with one column per coordinate, so the identifiers
+/// of points that were created one after another compress well. The Curves are unpacked again the next time the
+/// command needs them
+class CurvesGraphsPacked
+{
+public:
+  /// Default constructor for no Curves.
+  CurvesGraphsPacked();
+
+  /// Approximate memory used, in bytes.
+  int byteCount () const;
+
+  /// Release all of the Points, for a command that will never be undone or redone again.
+  void clear ();
+
+  /// Compress the Curves until curvesGraphs is next called.
+  void compress ();
+
+  /// Return the Curves, unpacking them first if they are compressed.
+  CurvesGraphs &curvesGraphs ();
+
+  /// True if compress has been called since the Curves were last unpacked.
+  bool isCompressed () const;
+
+  /// Total number of Points in all of the Curves.
+  int numPoints () const;
+
+private:
+
+  void uncompress ();
+
+  CurvesGraphs m_curvesGraphs;
+  QByteArray m_bytes;
+  int m_numPoints; // Only kept up to date while compressed
+  bool m_isCompressed;
+};
+
+#endif // CURVES_GRAPHS_PACKED_H
@@ -32,9 +32,9 @@ const DigitizeStateContext &DigitizeStateAbstractBase::context() const
   return m_context;
 }
 
-void DigitizeStateAbstractBase::handleContextMenuEvent (const QString &pointIdentifier)
+void DigitizeStateAbstractBase::handleContextMenuEvent (PointIdentifier pointIdentifier)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "DigitizeStateAbstractBase::handleContextMenuEvent point=" << pointIdentifier.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "DigitizeStateAbstractBase::handleContextMenuEvent point=" << Point::identifierToString (pointIdentifier).toLatin1 ().data ();
 
   QPointF posScreen = context().cmdMediator().document().positionScreen (pointIdentifier);
   QPointF posGraphBefore = context().cmdMediator().document().positionGraph (pointIdentifier);
@@ -1,6 +1,7 @@
 #ifndef DIGITIZE_STATE_ABSTRACT_BASE_H
 #define DIGITIZE_STATE_ABSTRACT_BASE_H
 
+#include "PointIdentifier.h"
 #include <QPointF>
 
 class DigitizeStateContext;
@@ -41,7 +42,7 @@ public:
   virtual void end() = 0;
 
   /// Handle a right click that was intercepted earlier. This is done in the superclass since it works the same in all states.
-  void handleContextMenuEvent (const QString &pointIdentifier);
+  void handleContextMenuEvent (PointIdentifier pointIdentifier);
 
   /// Handle a key press that was intercepted earlier.
   virtual void handleKeyPress (Qt::Key key) = 0;
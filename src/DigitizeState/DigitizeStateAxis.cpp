@@ -13,7 +13,7 @@
 #include <QMessageBox>
 #include <QTimer>
 
-const QString TEMPORARY_POINT_NAME ("temporary");
+const PointIdentifier TEMPORARY_POINT_IDENTIFIER = POINT_IDENTIFIER_INVALID;
 
 DigitizeStateAxis::DigitizeStateAxis (DigitizeStateContext &context) :
   DigitizeStateAbstractBase (context)
@@ -69,9 +69,9 @@ void DigitizeStateAxis::handleMouseRelease (QPointF posScreen)
     // Temporary point that user can see while DlgEditPoint is active
     const Curve &curveAxes = context().cmdMediator().curveAxes();
     PointStyle pointStyleAxes = curveAxes.pointStyle();
-    QGraphicsItem *item = context().mainWindow().scene().addPoint(TEMPORARY_POINT_NAME,
-                                                                  pointStyleAxes,
-                                                                  posScreen);
+    context().mainWindow().scene().addPoint(TEMPORARY_POINT_IDENTIFIER,
+                                            pointStyleAxes,
+                                            posScreen);
 
     // Ask user for coordinates
     DlgEditPoint *dlg = new DlgEditPoint (context ().mainWindow (),
@@ -82,7 +82,7 @@ void DigitizeStateAxis::handleMouseRelease (QPointF posScreen)
     delete dlg;
 
     // Remove temporary point
-    context().mainWindow().scene().removeItem (item);
+    context().mainWindow().scene().removePoint (TEMPORARY_POINT_IDENTIFIER);
 
     if (rtn == QDialog::Accepted) {
 
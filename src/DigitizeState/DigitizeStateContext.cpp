@@ -74,7 +74,7 @@ void DigitizeStateContext::completeRequestedStateTransitionIfExists ()
   }
 }
 
-void DigitizeStateContext::handleContextMenuEvent (const QString &pointIdentifier)
+void DigitizeStateContext::handleContextMenuEvent (PointIdentifier pointIdentifier)
 {
   m_states [m_currentState]->handleContextMenuEvent (pointIdentifier);
 }
@@ -33,7 +33,7 @@ public:
   CmdMediator &cmdMediator ();
 
   /// See DigitizeStateAbstractBase::handleContextMenuEvent.
-  void handleContextMenuEvent (const QString &pointIdentifier);
+  void handleContextMenuEvent (PointIdentifier pointIdentifier);
 
   /// See DigitizeStateAbstractBase::handleKeyPress.
   void handleKeyPress (Qt::Key key);
@@ -80,7 +80,7 @@ void DigitizeStateSelect::handleMouseRelease (QPointF posScreen)
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ();
 
   QPointF deltaScreen = posScreen - m_movingStart;
-  QStringList positionHasChangedIdentifers = context().mainWindow().scene().positionHasChangedPointIdentifiers();
+  PointIdentifierList positionHasChangedIdentifers = context().mainWindow().scene().positionHasChangedPointIdentifiers();
 
   bool positionHasChanged = (positionHasChangedIdentifers.count () > 0);
 
@@ -170,28 +170,12 @@ void DigitizeStateSelect::setCursorForPoints()
 {
   QCursor cursor (Qt::OpenHandCursor);
 
-  QList<QGraphicsItem*> items = context().mainWindow().scene().items();
-  QList<QGraphicsItem*>::iterator itr;
-  for (itr = items.begin (); itr != items.end (); itr++) {
-
-    QGraphicsItem *item = *itr;
-    if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE) == GRAPHICS_ITEM_TYPE_POINT) {
-      item->setCursor (cursor);
-    }
-  }
+  context().mainWindow().scene().setCursorForPoints (cursor);
 }
 
 void DigitizeStateSelect::unsetCursorForPoints()
 {
-  QList<QGraphicsItem*> items = context().mainWindow().scene().items();
-  QList<QGraphicsItem*>::iterator itr;
-  for (itr = items.begin (); itr != items.end (); itr++) {
-
-    QGraphicsItem *item = *itr;
-    if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE) == GRAPHICS_ITEM_TYPE_POINT) {
-      item->unsetCursor ();
-    }
-  }
+  context().mainWindow().scene().unsetCursorForPoints ();
 }
 
 double DigitizeStateSelect::zoomedToUnzoomedScreenX () const
@@ -1,10 +1,10 @@
 #include "DlgFilterThread.h"
 #include "DlgSettingsFilter.h"
 
-DlgFilterThread::DlgFilterThread(const QPixmap &pixmapOriginal,
+DlgFilterThread::DlgFilterThread(const QImage &imageOriginal,
                                  QRgb rgbBackground,
                                  DlgSettingsFilter &dlgSettingsFilter) :
-  m_pixmapOriginal (pixmapOriginal),
+  m_imageOriginal (imageOriginal),
   m_rgbBackground (rgbBackground),
   m_dlgSettingsFilter (dlgSettingsFilter)
 {
@@ -12,7 +12,7 @@ DlgFilterThread::DlgFilterThread(const QPixmap &pixmapOriginal,
 
 void DlgFilterThread::run ()
 {
-  m_dlgFilterWorker = new DlgFilterWorker (m_pixmapOriginal,
+  m_dlgFilterWorker = new DlgFilterWorker (m_imageOriginal,
                                            m_rgbBackground);
 
   // Connect signal to start process
@@ -2,8 +2,8 @@
 #define DLG_FILTER_THREAD_H
 
 #include "DlgFilterWorker.h"
+#include <QImage>
 #include <QObject>
-#include <QPixmap>
 #include <QThread>
 
 class DlgSettingsFilter;
@@ -15,7 +15,7 @@ class DlgFilterThread : public QThread
 
 public:
   /// Single constructor.
-  DlgFilterThread(const QPixmap &pixmapOriginal,
+  DlgFilterThread(const QImage &imageOriginal,
                   QRgb rgbBackground,
                   DlgSettingsFilter &dlgSettingsFilter);
 
@@ -30,7 +30,7 @@ signals:
 private:
   DlgFilterThread();
 
-  QPixmap m_pixmapOriginal;
+  QImage m_imageOriginal;
   QRgb m_rgbBackground;
 
   DlgSettingsFilter &m_dlgSettingsFilter;
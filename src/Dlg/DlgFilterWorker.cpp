@@ -7,9 +7,9 @@
 const int NO_DELAY = 0;
 const int COLUMNS_PER_PIECE = 5;
 
-DlgFilterWorker::DlgFilterWorker(const QPixmap &pixmapOriginal,
+DlgFilterWorker::DlgFilterWorker(const QImage &imageOriginal,
                                  QRgb rgbBackground) :
-  m_imageOriginal (pixmapOriginal.toImage()),
+  m_imageOriginal (imageOriginal),
   m_rgbBackground (rgbBackground),
   m_filterParameter (NUM_FILTER_PARAMETERS),
   m_low (-1.0),
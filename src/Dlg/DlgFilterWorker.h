@@ -6,7 +6,6 @@
 #include <QImage>
 #include <QList>
 #include <QObject>
-#include <QPixmap>
 #include <QRgb>
 #include <QTimer>
 
@@ -19,7 +18,7 @@ class DlgFilterWorker : public QObject
 
 public:
   /// Single constructor.
-  DlgFilterWorker(const QPixmap &pixmapOriginal,
+  DlgFilterWorker(const QImage &imageOriginal,
                   QRgb m_rgbBackground);
 
 public slots:
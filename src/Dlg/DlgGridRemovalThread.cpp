@@ -0,0 +1,46 @@
+#include "DlgGridRemovalThread.h"
+#include "DlgSettingsGridRemoval.h"
+
+DlgGridRemovalThread::DlgGridRemovalThread(const QImage &imageOriginal,
+                                           const QSize &sizeFull,
+                                           const DocumentModelFilter &modelFilter,
+                                           const DocumentModelCoords &modelCoords,
+                                           const Transformation &transformation,
+                                           DlgSettingsGridRemoval &dlgSettingsGridRemoval) :
+  m_imageOriginal (imageOriginal),
+  m_sizeFull (sizeFull),
+  m_modelFilter (modelFilter),
+  m_modelCoords (modelCoords),
+  m_transformation (transformation),
+  m_dlgSettingsGridRemoval (dlgSettingsGridRemoval),
+  m_dlgGridRemovalWorker (0)
+{
+}
+
+DlgGridRemovalThread::~DlgGridRemovalThread()
+{
+  // Stop the event loop so the worker, which belongs to this thread, is not in use when it is deleted
+  quit ();
+  wait ();
+
+  delete m_dlgGridRemovalWorker;
+}
+
+void DlgGridRemovalThread::run ()
+{
+  m_dlgGridRemovalWorker = new DlgGridRemovalWorker (m_imageOriginal,
+                                                     m_sizeFull,
+                                                     m_modelFilter,
+                                                     m_modelCoords,
+                                                     m_transformation);
+
+  // Connect signal to start process
+  connect (&m_dlgSettingsGridRemoval, SIGNAL (signalApplyGridRemoval (DocumentModelGridRemoval)),
+           m_dlgGridRemovalWorker, SLOT (slotNewParameters (DocumentModelGridRemoval)));
+
+  // Connect signal to return completed processing
+  connect (m_dlgGridRemovalWorker, SIGNAL (signalTransferImage (QImage)),
+           &m_dlgSettingsGridRemoval, SLOT (slotTransferImage (QImage)));
+
+  exec ();
+}
@@ -0,0 +1,45 @@
+#ifndef DLG_GRID_REMOVAL_THREAD_H
+#define DLG_GRID_REMOVAL_THREAD_H
+
+#include "DlgGridRemovalWorker.h"
+#include <QImage>
+#include <QObject>
+#include <QSize>
+#include <QThread>
+
+class DlgSettingsGridRemoval;
+
+/// Class for processing new grid removal settings. This is based on http://blog.debao.me/2013/08/how-to-use-qthread-in-the-right-way-part-1/
+class DlgGridRemovalThread : public QThread
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor.
+  DlgGridRemovalThread(const QImage &imageOriginal,
+                       const QSize &sizeFull,
+                       const DocumentModelFilter &modelFilter,
+                       const DocumentModelCoords &modelCoords,
+                       const Transformation &transformation,
+                       DlgSettingsGridRemoval &dlgSettingsGridRemoval);
+  virtual ~DlgGridRemovalThread();
+
+  /// Run this thread.
+  virtual void run();
+
+private:
+  DlgGridRemovalThread();
+
+  QImage m_imageOriginal;
+  QSize m_sizeFull;
+  DocumentModelFilter m_modelFilter;
+  DocumentModelCoords m_modelCoords;
+  Transformation m_transformation;
+
+  DlgSettingsGridRemoval &m_dlgSettingsGridRemoval;
+
+  // Worker must be created in the run method of this thread so it belongs to this thread rather than the GUI thread that called it
+  DlgGridRemovalWorker *m_dlgGridRemovalWorker;
+};
+
+#endif // DLG_GRID_REMOVAL_THREAD_H
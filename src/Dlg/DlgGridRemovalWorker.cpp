@@ -0,0 +1,66 @@
+#include "DlgGridRemovalWorker.h"
+#include "Filter.h"
+#include "Logger.h"
+
+const int NO_DELAY = 0;
+
+DlgGridRemovalWorker::DlgGridRemovalWorker(const QImage &imageOriginal,
+                                           const QSize &sizeFull,
+                                           const DocumentModelFilter &modelFilter,
+                                           const DocumentModelCoords &modelCoords,
+                                           const Transformation &transformation) :
+  m_imageFiltered (imageOriginal.width (),
+                   imageOriginal.height (),
+                   QImage::Format_RGB32),
+  m_sizeFull (sizeFull),
+  m_modelCoords (modelCoords),
+  m_transformation (transformation)
+{
+  Filter filter;
+  QRgb rgbBackground = filter.marginColor (&imageOriginal);
+  filter.filterImage (imageOriginal,
+                      m_imageFiltered,
+                      modelFilter.filterParameter(),
+                      modelFilter.low(),
+                      modelFilter.high(),
+                      rgbBackground);
+
+  m_restartTimer.setSingleShot (true);
+  connect (&m_restartTimer, SIGNAL (timeout ()), this, SLOT (slotRestartTimeout()));
+}
+
+void DlgGridRemovalWorker::slotNewParameters (DocumentModelGridRemoval modelGridRemoval)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "DlgGridRemovalWorker::slotNewParameters";
+
+  m_inputCommandQueue.push_back (modelGridRemoval);
+
+  if (!m_restartTimer.isActive()) {
+
+    // Timer is not currently active so start it up
+    m_restartTimer.start (NO_DELAY);
+  }
+}
+
+void DlgGridRemovalWorker::slotRestartTimeout ()
+{
+  if (m_inputCommandQueue.count() > 0) {
+
+    // Parameters that were superseded while waiting for this timeout are skipped
+    DocumentModelGridRemoval modelGridRemoval = m_inputCommandQueue.last();
+    m_inputCommandQueue.clear ();
+
+    // The mask is in screen coordinates of the full size image, and is sampled down to the preview resolution
+    QImage imageProcessed (m_imageFiltered);
+    m_gridRemoval.rasterizeMask (modelGridRemoval,
+                                 m_modelCoords,
+                                 m_transformation,
+                                 m_sizeFull.width (),
+                                 m_sizeFull.height ());
+    m_gridRemoval.applyMask (imageProcessed,
+                             QRectF (QPointF (0, 0),
+                                     m_sizeFull));
+
+    emit signalTransferImage (imageProcessed);
+  }
+}
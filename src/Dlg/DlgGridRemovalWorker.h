@@ -0,0 +1,56 @@
+#ifndef DLG_GRID_REMOVAL_WORKER_H
+#define DLG_GRID_REMOVAL_WORKER_H
+
+#include "DocumentModelCoords.h"
+#include "DocumentModelFilter.h"
+#include "DocumentModelGridRemoval.h"
+#include "GridRemoval.h"
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QSize>
+#include <QTimer>
+#include "Transformation.h"
+
+typedef QList<DocumentModelGridRemoval> GridRemovalCommandQueue;
+
+/// Class for processing new grid removal settings. This is based on http://blog.debao.me/2013/08/how-to-use-qworker-in-the-right-way-part-1/
+class DlgGridRemovalWorker : public QObject
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor. The original image is filtered once here, since only the grid removal settings change
+  /// while the dialog is open. The original image may be a downsampled preview of the Document image, whose full
+  /// size is needed since the grid lines are in its screen coordinates
+  DlgGridRemovalWorker(const QImage &imageOriginal,
+                       const QSize &sizeFull,
+                       const DocumentModelFilter &modelFilter,
+                       const DocumentModelCoords &modelCoords,
+                       const Transformation &transformation);
+
+public slots:
+  /// Start processing with a new set of parameters. Only the most recent set of queued parameters is processed.
+  void slotNewParameters (DocumentModelGridRemoval modelGridRemoval);
+
+private slots:
+  void slotRestartTimeout ();
+
+signals:
+  /// Send the filtered image with the grid lines removed.
+  void signalTransferImage (QImage image);
+
+private:
+  DlgGridRemovalWorker();
+
+  QImage m_imageFiltered; // Filtered before any grid removal
+  QSize m_sizeFull;
+  DocumentModelCoords m_modelCoords;
+  Transformation m_transformation;
+
+  GridRemoval m_gridRemoval; // Reused so the mask is not reallocated for each set of parameters
+  GridRemovalCommandQueue m_inputCommandQueue;
+  QTimer m_restartTimer; // Decouple slotNewParameters from the processing that this class performs
+};
+
+#endif // DLG_GRID_REMOVAL_WORKER_H
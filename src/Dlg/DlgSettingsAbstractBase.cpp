@@ -4,11 +4,15 @@
 #include "MainWindow.h"
 #include <QColor>
 #include <QComboBox>
+#include <QGraphicsPixmapItem>
+#include <QGraphicsScene>
 #include <QPushButton>
 #include <QSettings>
 #include <QSpacerItem>
 #include <QVBoxLayout>
 
+const QSize MINIMUM_PREVIEW_RESOLUTION (MINIMUM_DIALOG_WIDTH, MINIMUM_PREVIEW_HEIGHT); // Before the view is laid out
+
 DlgSettingsAbstractBase::DlgSettingsAbstractBase(const QString &title,
                                                  const QString &dialogName,
                                                  MainWindow &mainWindow) :
@@ -25,6 +29,18 @@ DlgSettingsAbstractBase::~DlgSettingsAbstractBase()
 {
 }
 
+QGraphicsPixmapItem *DlgSettingsAbstractBase::addPixmapPreview (QGraphicsScene &scenePreview,
+                                                                const QImage &imagePreview)
+{
+  QSize sizeFull = cmdMediator().document().pixmap().size ();
+
+  QGraphicsPixmapItem *item = scenePreview.addPixmap (QPixmap::fromImage (imagePreview));
+  item->setTransform (QTransform::fromScale ((double) sizeFull.width () / imagePreview.width (),
+                                             (double) sizeFull.height () / imagePreview.height ()));
+
+  return item;
+}
+
 CmdMediator &DlgSettingsAbstractBase::cmdMediator ()
 {
   Q_CHECK_PTR (m_cmdMediator);
@@ -68,6 +84,11 @@ void DlgSettingsAbstractBase::finishPanel (QWidget *subPanel)
   panelLayout->setStretch (panelLayout->count () - 1, STRETCH_OFF);
 }
 
+QImage DlgSettingsAbstractBase::imagePreview (const QWidget &viewPreview)
+{
+  return cmdMediator().document().imagePyramid().imageForSize (viewPreview.size ().expandedTo (MINIMUM_PREVIEW_RESOLUTION));
+}
+
 MainWindow &DlgSettingsAbstractBase::mainWindow ()
 {
   return m_mainWindow;
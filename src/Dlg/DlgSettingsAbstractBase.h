@@ -2,11 +2,14 @@
 #define DLG_SETTINGS_ABSTRACT_BASE_H
 
 #include <QDialog>
+#include <QImage>
 #include <QObject>
 
 class CmdMediator;
 class MainWindow;
 class QComboBox;
+class QGraphicsPixmapItem;
+class QGraphicsScene;
 
 const int MINIMUM_DIALOG_WIDTH = 350;
 const int MINIMUM_PREVIEW_HEIGHT = 200;
@@ -24,6 +27,11 @@ public:
   virtual ~DlgSettingsAbstractBase();
 
 protected:
+  /// Add a preview image from imagePreview to the preview scene. The item is scaled up to the size of the Document
+  /// image, so the scene coordinates of everything else in the preview stay in screen coordinates.
+  QGraphicsPixmapItem *addPixmapPreview (QGraphicsScene &scenePreview,
+                                         const QImage &imagePreview);
+
   /// Provide access to Document information wrapped inside CmdMediator.
   CmdMediator &cmdMediator ();
 
@@ -49,6 +57,10 @@ protected:
   /// Load settings from Document.
   virtual void load (CmdMediator &cmdMediator) = 0;
 
+  /// Return the level of the Document image pyramid that matches the size of the preview view. Previews are
+  /// computed from this image rather than from the full size image.
+  QImage imagePreview (const QWidget &viewPreview);
+
   /// Get method for MainWindow.
   MainWindow &mainWindow ();
 
@@ -400,7 +400,7 @@ void DlgSettingsCurveProperties::updateControls()
 
 void DlgSettingsCurveProperties::updatePreview()
 {
-  const QString NULL_IDENTIFIER;
+  const PointIdentifier NULL_IDENTIFIER = POINT_IDENTIFIER_INVALID;
 
   m_scenePreview->clear();
 
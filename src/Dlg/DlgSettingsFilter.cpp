@@ -164,11 +164,11 @@ QRgb DlgSettingsFilter::createThread ()
   LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsFilter::createThread";
 
   // Get background color
-  QImage image = cmdMediator().document().pixmap().toImage();
+  QImage image = imagePreview (*m_viewPreview);
   Filter filter;
   QRgb rgbBackground = filter.marginColor(&image);
 
-  m_filterThread = new DlgFilterThread (cmdMediator().document().pixmap(),
+  m_filterThread = new DlgFilterThread (image,
                                         rgbBackground,
                                         *this);
   m_filterThread->start(); // Now that thread is started, we can use signalApplyFilter
@@ -216,12 +216,12 @@ void DlgSettingsFilter::load (CmdMediator &cmdMediator)
   m_btnValue->setChecked (filterParameter == FILTER_PARAMETER_VALUE);
 
   m_scenePreview->clear();
-  m_imagePreview = cmdMediator.document().pixmap().toImage();
-  m_scenePreview->addPixmap (QPixmap::fromImage (m_imagePreview));
+  m_imagePreview = imagePreview (*m_viewPreview);
+  addPixmapPreview (*m_scenePreview,
+                    m_imagePreview);
 
   QRgb rgbBackground = createThread ();
   m_scale->setBackgroundColor (rgbBackground);
-  createThread ();
   updateHistogram();
   updatePreview(); // Needs thread initialized
   enableOk (false); // Disable Ok button since there not yet any changes
@@ -297,7 +297,8 @@ void DlgSettingsFilter::slotTransferPiece (int xLeft,
   delete itemPixmap;
 
   // Save new pixmap. Only visible change should be the area covered by the pixels in image
-  m_scenePreview->addPixmap (QPixmap::fromImage (m_imagePreview));
+  addPixmapPreview (*m_scenePreview,
+                    m_imagePreview);
 }
 
 void DlgSettingsFilter::slotValue ()
@@ -321,8 +322,8 @@ void DlgSettingsFilter::updateHistogram()
 
   m_scale->setFilterParameter (m_modelFilterAfter->filterParameter());
 
-  // Start with original image
-  QImage image = cmdMediator().document().pixmap().toImage();
+  // Start with original image, at the preview resolution since the histogram only needs the distribution of values
+  QImage image = imagePreview (*m_viewPreview);
 
   double histogramBins [HISTOGRAM_BINS];
 
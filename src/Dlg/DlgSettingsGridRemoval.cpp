@@ -1,5 +1,6 @@
 #include "CmdMediator.h"
 #include "CmdSettingsGridRemoval.h"
+#include "DlgGridRemovalThread.h"
 #include "DlgSettingsGridRemoval.h"
 #include "Logger.h"
 #include "MainWindow.h"
@@ -12,6 +13,7 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QPixmap>
 #include "ViewPreview.h"
 
 const double CLOSE_DISTANCE_MAX = 64;
@@ -28,7 +30,8 @@ DlgSettingsGridRemoval::DlgSettingsGridRemoval(MainWindow &mainWindow) :
   m_scenePreview (0),
   m_viewPreview (0),
   m_modelGridRemovalBefore (0),
-  m_modelGridRemovalAfter (0)
+  m_modelGridRemovalAfter (0),
+  m_gridRemovalThread (0)
 {
   QWidget *subPanel = createSubPanel ();
   finishPanel (subPanel);
@@ -263,6 +266,29 @@ QWidget *DlgSettingsGridRemoval::createSubPanel ()
   return subPanel;
 }
 
+void DlgSettingsGridRemoval::createThread ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::createThread";
+
+  // Flush old thread, which was created for a different document or transformation
+  if (m_gridRemovalThread != 0) {
+    delete m_gridRemovalThread;
+    m_gridRemovalThread = 0;
+  }
+
+  // Grid lines are defined in graph coordinates, so there is nothing to remove until the transformation is defined
+  if (mainWindow().transformIsDefined()) {
+
+    m_gridRemovalThread = new DlgGridRemovalThread (imagePreview (*m_viewPreview),
+                                                    cmdMediator().document().pixmap().size (),
+                                                    cmdMediator().document().modelFilter(),
+                                                    cmdMediator().document().modelCoords(),
+                                                    mainWindow().transformation(),
+                                                    *this);
+    m_gridRemovalThread->start(); // Now that thread is started, we can use signalApplyGridRemoval
+  }
+}
+
 void DlgSettingsGridRemoval::handleOk ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::handleOk";
@@ -294,6 +320,9 @@ void DlgSettingsGridRemoval::load (CmdMediator &cmdMediator)
   m_modelGridRemovalBefore = new DocumentModelGridRemoval (cmdMediator.document());
   m_modelGridRemovalAfter = new DocumentModelGridRemoval (cmdMediator.document());
 
+  // Thread is created before the controls are populated, so the preview requests triggered by populating go to it
+  createThread ();
+
   // Sanity checks. Incoming defaults must be acceptable to the local limits
   Q_ASSERT (CLOSE_DISTANCE_MIN <= m_modelGridRemovalAfter->closeDistance());
   Q_ASSERT (CLOSE_DISTANCE_MAX >= m_modelGridRemovalAfter->closeDistance());
@@ -322,11 +351,12 @@ void DlgSettingsGridRemoval::load (CmdMediator &cmdMediator)
   m_chkRemoveParallel->setChecked (m_modelGridRemovalAfter->removeParallelToAxes());
 
   m_scenePreview->clear();
-  m_scenePreview->addPixmap (cmdMediator.document().pixmap());
+  addPixmapPreview (*m_scenePreview,
+                    imagePreview (*m_viewPreview));
 
   updateControls ();
   enableOk (false); // Disable Ok button since there not yet any changes
-  updatePreview();
+  updatePreview(); // Needs thread initialized
 }
 
 void DlgSettingsGridRemoval::slotCloseDistance(const QString &)
@@ -448,6 +478,15 @@ void DlgSettingsGridRemoval::slotStopY(const QString &stopY)
   updatePreview();
 }
 
+void DlgSettingsGridRemoval::slotTransferImage (QImage image)
+{
+  // Replace the old pixmap. Unlike the filter preview, the image arrives in one piece since the mask is cheap to
+  // rasterize and apply
+  m_scenePreview->clear();
+  addPixmapPreview (*m_scenePreview,
+                    image);
+}
+
 void DlgSettingsGridRemoval::updateControls ()
 {
   m_editCloseDistance->setEnabled (m_chkRemoveGridLines->isChecked ());
@@ -493,5 +532,11 @@ void DlgSettingsGridRemoval::updateControls ()
 
 void DlgSettingsGridRemoval::updatePreview ()
 {
+  LOG4CPP_INFO_S ((*mainCat)) << "DlgSettingsGridRemoval::updatePreview";
 
+  if (m_gridRemovalThread != 0) {
+
+    // This (indirectly) updates the preview
+    emit signalApplyGridRemoval (*m_modelGridRemovalAfter);
+  }
 }
@@ -2,8 +2,10 @@
 #define DLG_SETTINGS_GRID_REMOVAL_H
 
 #include "DlgSettingsAbstractBase.h"
+#include "DocumentModelGridRemoval.h"
+#include <QImage>
 
-class DocumentModelGridRemoval;
+class DlgGridRemovalThread;
 class QCheckBox;
 class QComboBox;
 class QDoubleValidator;
@@ -25,6 +27,14 @@ public:
   virtual QWidget *createSubPanel ();
   virtual void load (CmdMediator &cmdMediator);
 
+public slots:
+  /// Receive the processed preview image, which is the filtered image with the grid lines removed.
+  void slotTransferImage (QImage image);
+
+signals:
+  /// Send grid removal parameters to DlgGridRemovalThread and DlgGridRemovalWorker for processing.
+  void signalApplyGridRemoval (DocumentModelGridRemoval modelGridRemoval);
+
 private slots:
   void slotRemoveGridLines (int);
   void slotCloseDistance(const QString &);
@@ -53,6 +63,7 @@ private:
   void createRemoveGridLinesY (QGridLayout *layoutGridLines, int &row);
   void createRemoveParallel (QGridLayout *layout, int &row);
   void createPreview (QGridLayout *layout, int &row);
+  void createThread ();
   void updateControls ();
   void updatePreview();
 
@@ -87,6 +98,8 @@ private:
 
   DocumentModelGridRemoval *m_modelGridRemovalBefore;
   DocumentModelGridRemoval *m_modelGridRemovalAfter;
+
+  DlgGridRemovalThread *m_gridRemovalThread; // Only exists while the transformation is defined
 };
 
 #endif // DLG_SETTINGS_GRID_REMOVAL_H
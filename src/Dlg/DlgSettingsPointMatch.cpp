@@ -266,7 +266,9 @@ void DlgSettingsPointMatch::load (CmdMediator &cmdMediator)
                                                                 cmdMediator.document().pixmap().height ()));
   boundary->setVisible (false);
 
-  m_scenePreview->addPixmap (cmdMediator.document().pixmap());
+  // The preview is drawn from a downsampled level, scaled back up so the box stays in full size coordinates
+  addPixmapPreview (*m_scenePreview,
+                    imagePreview (*m_viewPreview));
 
   updateControls();
   enableOk (false); // Disable Ok button since there not yet any changes
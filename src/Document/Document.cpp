@@ -1,4 +1,3 @@
-#include "CallbackAddPointsInCurvesGraphs.h"
 #include "CallbackCheckAddPointAxis.h"
 #include "CallbackCheckEditPointAxis.h"
 #include "CallbackRemovePointsInCurvesGraphs.h"
@@ -6,17 +5,104 @@
 #include "Document.h"
 #include "DocumentModelCurveProperties.h"
 #include "Logger.h"
+#include <cstring>
 #include "Point.h"
+#include <QBuffer>
+#include <QDataStream>
 #include <QDebug>
 #include <QFile>
 #include <QImage>
+#include <QImageReader>
+#include <QMap>
+#include <QtConcurrentRun>
+#include <QtEndian>
 #include <QtToString.h>
+#include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 #include "Transformation.h"
 
-Document::Document (const QImage &image) :
+const QString DOCUMENT_VERSION ("6"); // Written into the Document element, for readers of later versions
+
+// Binary format. A header with the magic bytes, version and section count is followed by the section table, and then
+// the sections. Every entry of the table has the section type, padding, and the offset and size of the section. Each
+// section starts on an 8 byte boundary so the doubles inside are aligned when the file is mapped. All numbers are
+// little endian
+const QByteArray BINARY_MAGIC ("EngaugeD");
+const quint32 BINARY_VERSION = 1;
+const int BINARY_HEADER_SIZE = 16;
+const int BINARY_SECTION_ENTRY_SIZE = 24;
+const int BINARY_ALIGNMENT = 8;
+const quint32 BINARY_SECTION_IMAGE = 1; // Original image bytes
+const quint32 BINARY_SECTION_SETTINGS = 2; // Settings models, as the xml that saveDocument writes for them
+const quint32 BINARY_SECTION_CURVE = 3; // Curve header, curve name, and then the point columns
+
+// Curve header: name size, column count, point count, line width, line color, connect as, point radius, point color,
+// point shape and point line width
+const int BINARY_CURVE_HEADER_SIZE = 48;
+
+// Journal records. A snapshot holds every Curve with its styles and Points, and a delta holds only the Points that
+// changed. Points are listed with the identifiers of the process that wrote the journal
+const quint32 JOURNAL_RECORD_SNAPSHOT = 1;
+const quint32 JOURNAL_RECORD_DELTA = 2;
+
+static qint64 alignBinary (qint64 size)
+{
+  return (size + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT * BINARY_ALIGNMENT;
+}
+
+static void writeBinaryPadding (QDataStream &stream,
+                                qint64 size)
+{
+  const char zeros [BINARY_ALIGNMENT] = {0};
+
+  int padding = alignBinary (size) - size;
+  if (padding > 0) {
+    stream.writeRawData (zeros, padding);
+  }
+}
+
+static void writeJournalCurve (QDataStream &stream,
+                               const Curve &curve)
+{
+  bool isAxis = (curve.curveName () == AXIS_CURVE_NAME);
+  LineStyle lineStyle = curve.lineStyle ();
+  PointStyle pointStyle = curve.pointStyle ();
+
+  stream << curve.curveName ()
+         << (quint32) lineStyle.width ()
+         << (quint32) lineStyle.paletteColor ()
+         << (quint32) lineStyle.curveConnectAs ()
+         << (quint32) pointStyle.shape ()
+         << (quint32) pointStyle.radius ()
+         << (quint32) pointStyle.paletteColor ()
+         << pointStyle.lineWidth ()
+         << (quint32) curve.numPoints ();
+
+  // Graph coordinates of graph points are computed from the axis points, so they are only written for axis points
+  const Points points = curve.points ();
+  Points::const_iterator itr;
+  for (itr = points.begin (); itr != points.end (); itr++) {
+
+    const Point &point = *itr;
+    stream << point.identifier ()
+           << point.posScreen ().x ()
+           << point.posScreen ().y ();
+    if (isAxis) {
+      stream << point.posGraph ().x ()
+             << point.posGraph ().y ();
+    }
+  }
+}
+
+Document::Document (const QImage &image,
+                    const QByteArray &imageBytes) :
   m_name ("untitled"),
+  m_imageBytes (imageBytes),
+  m_imageIsDecoding (false),
+  m_imagePyramidIsStarted (false),
   m_isModified (false),
+  m_pointIdentifiersChangedAll (true),
+  m_curvesJournalAll (false),
   m_curveAxes (new Curve (AXIS_CURVE_NAME,
                           LineStyle::defaultAxesCurve(),
                           PointStyle::defaultAxesCurve ()))
@@ -32,17 +118,38 @@ Document::Document (const QImage &image) :
 
 Document::Document (const QString &fileName) :
   m_name (fileName),
+  m_imageIsDecoding (false),
+  m_imagePyramidIsStarted (false),
   m_isModified (false),
+  m_pointIdentifiersChangedAll (true),
+  m_curvesJournalAll (false),
   m_curveAxes (new Curve (AXIS_CURVE_NAME,
                           LineStyle::defaultAxesCurve(),
                           PointStyle::defaultAxesCurve()))
 {
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::Document fileName=" << fileName.toLatin1 ().data ();
+
   m_successfulRead = true;
 
   QFile file(fileName);
-  if (file.isReadable ()) {
+  if (file.open (QIODevice::ReadOnly)) {
 
-    // Insert import code here
+    if (file.peek (BINARY_MAGIC.size ()) == BINARY_MAGIC) {
+
+      m_successfulRead = loadDocumentBinary (file);
+
+    } else {
+
+      // The reader pulls the file through a small buffer as it parses, so the file is never held in memory as a whole
+      QXmlStreamReader reader (&file);
+      loadDocument (reader);
+
+      if (reader.hasError ()) {
+
+        m_successfulRead = false;
+        m_reasonForUnsuccessfulRead = reader.errorString ();
+      }
+    }
 
   } else {
 
@@ -50,9 +157,12 @@ Document::Document (const QString &fileName) :
     m_reasonForUnsuccessfulRead = "Operating system says file is not readable";
   }
 
-  m_curvesGraphs.addGraphCurveAtEnd (Curve (DEFAULT_GRAPH_CURVE_NAME,
-                                            LineStyle::defaultGraphCurve(m_curvesGraphs.numCurves()),
-                                            PointStyle::defaultGraphCurve(m_curvesGraphs.numCurves())));
+  if (m_curvesGraphs.numCurves () == 0) {
+
+    m_curvesGraphs.addGraphCurveAtEnd (Curve (DEFAULT_GRAPH_CURVE_NAME,
+                                              LineStyle::defaultGraphCurve(m_curvesGraphs.numCurves()),
+                                              PointStyle::defaultGraphCurve(m_curvesGraphs.numCurves())));
+  }
 }
 
 void Document::addGraphCurveAtEnd (const QString &curveName)
@@ -64,74 +174,93 @@ void Document::addGraphCurveAtEnd (const QString &curveName)
 
 void Document::addPointAxis (const QPointF &posScreen,
                              const QPointF &posGraph,
-                             QString &identifier)
+                             PointIdentifier &identifier)
 {
   Point point (AXIS_CURVE_NAME,
                posScreen,
                posGraph);
   m_curveAxes->addPoint (point);
+  markPointIdentifierChanged (point.identifier ());
 
   identifier = point.identifier();
 
   LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointAxis"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
                               << " posGraph=" << QPointFToString (posGraph).toLatin1 ().data ()
-                              << " identifier=" << identifier.toLatin1 ().data ();
+                              << " identifier=" << Point::identifierToString (identifier).toLatin1 ().data ();
 }
 
 void Document::addPointAxis (const QPointF &posScreen,
                              const QPointF &posGraph,
-                             const QString &identifier)
+                             PointIdentifier identifier)
 {
   Point point (AXIS_CURVE_NAME,
                posScreen,
                identifier,
                posGraph);
   m_curveAxes->addPoint (point);
+  markPointIdentifierChanged (point.identifier ());
 
   LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointAxis"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
                               << " posGraph=" << QPointFToString (posGraph).toLatin1 ().data ()
-                              << " identifier=" << identifier.toLatin1 ().data ();
+                              << " identifier=" << Point::identifierToString (identifier).toLatin1 ().data ();
 }
 
 void Document::addPointGraph (const QString &curveName,
                               const QPointF &posScreen,
-                              QString &identifier)
+                              PointIdentifier &identifier)
 {
   Point point (curveName,
                posScreen);
   m_curvesGraphs.addPoint (point);
+  markPointIdentifierChanged (point.identifier ());
 
   identifier = point.identifier();
 
   LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointGraph"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
-                              << " identifier=" << identifier.toLatin1 ().data ();
+                              << " identifier=" << Point::identifierToString (identifier).toLatin1 ().data ();
 }
 
 void Document::addPointGraph (const QString &curveName,
                               const QPointF &posScreen,
-                              const QString &identifier)
+                              PointIdentifier identifier)
 {
   Point point (curveName,
                posScreen,
                identifier);
   m_curvesGraphs.addPoint (point);
+  markPointIdentifierChanged (point.identifier ());
 
   LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointGraph"
                               << " posScreen=" << QPointFToString (posScreen).toLatin1 ().data ()
-                              << " identifier=" << identifier.toLatin1 ().data ();
+                              << " identifier=" << Point::identifierToString (identifier).toLatin1 ().data ();
 }
 
-void Document::addPointsInCurvesGraphs (CurvesGraphs &curvesGraphs)
+void Document::addPointsInCurvesGraphs (const CurvesGraphs &curvesGraphs)
 {
-  CallbackAddPointsInCurvesGraphs ftor (*this);
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::addPointsInCurvesGraphs count=" << curvesGraphs.numPoints ();
+
+  // Each Curve receives all of its Points in one append, and the changed identifiers are marked once
+  QHash<PointIdentifier, bool> identifiers;
+  identifiers.reserve (curvesGraphs.numPoints ());
+
+  QStringList curveNames = curvesGraphs.curvesGraphsNames ();
+  QStringList::const_iterator itr;
+  for (itr = curveNames.begin (); itr != curveNames.end (); itr++) {
 
-  Functor2wRet<const QString &, const Point &, CallbackSearchReturn> ftorWithCallback = functor_ret (ftor,
-                                                                                                     &CallbackAddPointsInCurvesGraphs::callback);
+    const Curve *curveFrom = curvesGraphs.curveForCurveName (*itr);
+    Curve *curve = curveForCurveName (*itr);
+    Q_ASSERT (curve != 0);
 
-  curvesGraphs.iterateThroughCurvesPoints (ftorWithCallback);
+    curve->appendPoints (*curveFrom,
+                         identifiers);
+  }
+
+  if (!identifiers.isEmpty ()) {
+    markPointIdentifiersChanged (identifiers);
+  }
 }
 
 void Document::applyTransformation (const Transformation &transformation)
@@ -139,6 +268,29 @@ void Document::applyTransformation (const Transformation &transformation)
   m_curvesGraphs.applyTransformation (transformation);
 }
 
+ImagePyramid Document::buildImagePyramid (QImage image)
+{
+  // Runs in a worker thread, like decodeImage
+  return ImagePyramid (image);
+}
+
+void Document::capturePointsInCurvesGraphs (const PointIdentifierList &selected,
+                                            CurvesGraphs &curvesGraphsCaptured) const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::capturePointsInCurvesGraphs count=" << selected.count ();
+
+  // For speed, build a hash as a fast lookup table
+  QHash<PointIdentifier, bool> selectedHash;
+  selectedHash.reserve (selected.count ());
+  PointIdentifierList::const_iterator itr;
+  for (itr = selected.begin (); itr != selected.end (); itr++) {
+    selectedHash [*itr] = true;
+  }
+
+  m_curvesGraphs.capturePoints (selectedHash,
+                                curvesGraphsCaptured);
+}
+
 void Document::checkAddPointAxis (const QPointF &posScreen,
                                   const QPointF &posGraph,
                                   bool &isError,
@@ -152,15 +304,13 @@ void Document::checkAddPointAxis (const QPointF &posScreen,
                                   posScreen,
                                   posGraph);
 
-  Functor2wRet<const QString &, const Point &, CallbackSearchReturn> ftorWithCallback = functor_ret (ftor,
-                                                                                                     &CallbackCheckAddPointAxis::callback);
-  m_curveAxes->iterateThroughCurvePoints (ftorWithCallback);
+  m_curveAxes->iterateThroughCurvePoints (ftor);
 
   isError = ftor.isError ();
   errorMessage = ftor.errorMessage ();
 }
 
-void Document::checkEditPointAxis (const QString &pointIdentifier,
+void Document::checkEditPointAxis (PointIdentifier pointIdentifier,
                                    const QPointF &posScreen,
                                    const QPointF &posGraph,
                                    bool &isError,
@@ -174,14 +324,22 @@ void Document::checkEditPointAxis (const QString &pointIdentifier,
                                    posScreen,
                                    posGraph);
 
-  Functor2wRet<const QString &, const Point &, CallbackSearchReturn> ftorWithCallback = functor_ret (ftor,
-                                                                                                     &CallbackCheckEditPointAxis::callback);
-  m_curveAxes->iterateThroughCurvePoints (ftorWithCallback);
+  m_curveAxes->iterateThroughCurvePoints (ftor);
 
   isError = ftor.isError ();
   errorMessage = ftor.errorMessage ();
 }
 
+bool Document::containsPoint (PointIdentifier pointIdentifier) const
+{
+  const Curve *curve = curveForPointIdentifier (pointIdentifier);
+  if (curve != 0) {
+    return curve->containsPoint (pointIdentifier);
+  }
+
+  return false;
+}
+
 const Curve &Document::curveAxes () const
 {
   Q_CHECK_PTR (m_curveAxes);
@@ -215,6 +373,33 @@ const Curve *Document::curveForCurveName (const QString &curveName) const
   }
 }
 
+Curve *Document::curveForPointIdentifier (PointIdentifier pointIdentifier)
+{
+  // Curve indexes are compared rather than curve names, since this is called for every changed Point
+  if (Point::curveIndexFromPointIdentifier (pointIdentifier) == m_curveAxes->curveIndex ()) {
+
+    return m_curveAxes;
+
+  } else {
+
+    return m_curvesGraphs.curveForPointIdentifier (pointIdentifier);
+
+  }
+}
+
+const Curve *Document::curveForPointIdentifier (PointIdentifier pointIdentifier) const
+{
+  if (Point::curveIndexFromPointIdentifier (pointIdentifier) == m_curveAxes->curveIndex ()) {
+
+    return m_curveAxes;
+
+  } else {
+
+    return m_curvesGraphs.curveForPointIdentifier (pointIdentifier);
+
+  }
+}
+
 const CurvesGraphs &Document::curvesGraphs () const
 {
   return m_curvesGraphs;
@@ -230,15 +415,53 @@ int Document::curvesGraphsNumPoints(const QString &curveName) const
   return m_curvesGraphs.curvesGraphsNumPoints(curveName);
 }
 
+QImage Document::decodeImage (QByteArray imageBytes)
+{
+  // Runs in a worker thread, so only QImage is used here. QPixmap is restricted to the gui thread
+  return QImage::fromData (imageBytes);
+}
+
 void Document::editPointAxis (const QPointF &posGraph,
-                              const QString &identifier)
+                              PointIdentifier identifier)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Document::editPointAxis posGraph=("
                               << posGraph.x () << ", " << posGraph.y () << ") identifier="
-                              << identifier.toLatin1 ().data ();
+                              << Point::identifierToString (identifier).toLatin1 ().data ();
 
   m_curveAxes->editPoint (posGraph,
                           identifier);
+  markPointIdentifierChanged (identifier);
+}
+
+QByteArray Document::imageBytes () const
+{
+  // Images that did not come from a file, such as dragged images, are encoded once and the bytes are kept
+  if (m_imageBytes.isEmpty ()) {
+
+    QBuffer buffer (&m_imageBytes);
+    buffer.open (QIODevice::WriteOnly);
+    pixmap ().save (&buffer, "PNG");
+  }
+
+  return m_imageBytes;
+}
+
+ImagePyramid Document::imagePyramid () const
+{
+  return imagePyramidFuture ().result ();
+}
+
+QFuture<ImagePyramid> Document::imagePyramidFuture () const
+{
+  if (!m_imagePyramidIsStarted) {
+
+    // The QImage is made here since QPixmap is restricted to the gui thread
+    m_imagePyramidBuilding = QtConcurrent::run (&Document::buildImagePyramid,
+                                                pixmap ().toImage ());
+    m_imagePyramidIsStarted = true;
+  }
+
+  return m_imagePyramidBuilding;
 }
 
 bool Document::isModified () const
@@ -246,25 +469,318 @@ bool Document::isModified () const
   return m_isModified;
 }
 
-void Document::iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
+QByteArray Document::journalDelta ()
 {
-  Q_CHECK_PTR (m_curveAxes);
+  if (m_curvesJournalAll) {
 
-  m_curveAxes->iterateThroughCurvePoints (ftorWithCallback);
+    // Curves were replaced or restyled, which only happens in settings commands, so the whole Curves are recorded
+    return journalSnapshot ();
+  }
+
+  QByteArray record;
+  QDataStream stream (&record, QIODevice::WriteOnly);
+  stream.setByteOrder (QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision (QDataStream::DoublePrecision);
+
+  // Points that are still present were added, moved or edited, and the others were removed. Added and restored
+  // Points always go to the end of their Curve, both here and in replayJournalDelta, so the present Points are
+  // written in their order along each Curve, keyed by curve index and then place in the Curve
+  QList<PointIdentifier> identifiersRemoved;
+  QMap<quint64, PointIdentifier> identifiersPresent;
+  QHash<PointIdentifier, bool>::const_iterator itr;
+  for (itr = m_pointIdentifiersJournal.begin (); itr != m_pointIdentifiersJournal.end (); itr++) {
+
+    PointIdentifier identifier = itr.key ();
+    const Curve *curve = curveForPointIdentifier (identifier);
+    int index = (curve != 0) ? curve->indexForPointIdentifier (identifier) : -1;
+    if (index < 0) {
+      identifiersRemoved << identifier;
+    } else {
+      identifiersPresent [(curve->curveIndex () << 32) + (quint64) index] = identifier;
+    }
+  }
+
+  stream << JOURNAL_RECORD_DELTA
+         << (quint32) m_pointIdentifiersJournal.count ();
+
+  QList<PointIdentifier>::const_iterator itrRemoved;
+  for (itrRemoved = identifiersRemoved.begin (); itrRemoved != identifiersRemoved.end (); itrRemoved++) {
+    stream << *itrRemoved
+           << (quint8) false;
+  }
+
+  QMap<quint64, PointIdentifier>::const_iterator itrPresent;
+  for (itrPresent = identifiersPresent.begin (); itrPresent != identifiersPresent.end (); itrPresent++) {
+
+    PointIdentifier identifier = itrPresent.value ();
+    const Curve *curve = curveForPointIdentifier (identifier);
+    QPointF posScreen = curve->positionScreen (identifier);
+    stream << identifier
+           << (quint8) true
+           << curve->curveName ()
+           << posScreen.x ()
+           << posScreen.y ();
+    if (curve == m_curveAxes) {
+
+      QPointF posGraph = curve->positionGraph (identifier);
+      stream << posGraph.x ()
+             << posGraph.y ();
+    }
+  }
+
+  m_pointIdentifiersJournal.clear ();
+
+  return record;
 }
 
-void Document::iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback) const
+QByteArray Document::journalSnapshot ()
 {
-  Q_CHECK_PTR (m_curveAxes);
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::journalSnapshot";
+
+  m_pointIdentifiersJournal.clear ();
+  m_curvesJournalAll = false;
+
+  QByteArray record;
+  QDataStream stream (&record, QIODevice::WriteOnly);
+  stream.setByteOrder (QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision (QDataStream::DoublePrecision);
+
+  QStringList curveNames = m_curvesGraphs.curvesGraphsNames ();
+  stream << JOURNAL_RECORD_SNAPSHOT
+         << (quint32) (curveNames.count () + 1);
+
+  writeJournalCurve (stream,
+                     *m_curveAxes);
+  QStringList::const_iterator itr;
+  for (itr = curveNames.begin (); itr != curveNames.end (); itr++) {
+    writeJournalCurve (stream,
+                       *m_curvesGraphs.curveForCurveName (*itr));
+  }
 
-  m_curveAxes->iterateThroughCurvePoints (ftorWithCallback);
+  return record;
 }
 
-void Document::iterateThroughCurvesPointsGraphs (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback)
+void Document::loadDocument (QXmlStreamReader &reader)
 {
-  Q_CHECK_PTR (m_curveAxes);
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::loadDocument";
 
-  m_curvesGraphs.iterateThroughCurvesPoints (ftorWithCallback);
+  if (!reader.readNextStartElement () ||
+      (reader.name () != "Document")) {
+    reader.raiseError ("File is not an Engauge document");
+    return;
+  }
+
+  while (reader.readNextStartElement ()) {
+
+    if (reader.name () == "Image") {
+
+      loadImage (reader);
+
+    } else if (reader.name () == "Curve") {
+
+      // The Curve is parsed straight into its columns, and the copies below only share those columns
+      Curve curve (reader);
+      if (curve.curveName () == AXIS_CURVE_NAME) {
+        *m_curveAxes = curve;
+      } else if (m_curvesGraphs.curveForCurveName (curve.curveName ()) != 0) {
+        reader.raiseError (QString ("Document has more than one curve named %1").arg (curve.curveName ()));
+      } else {
+        m_curvesGraphs.addGraphCurveAtEnd (curve);
+      }
+
+    } else {
+
+      // The settings models do not save any contents yet, so there is nothing to read from them
+      reader.skipCurrentElement ();
+    }
+  }
+
+  if (!reader.hasError () &&
+      m_imageBytes.isEmpty ()) {
+    reader.raiseError ("Document has no image");
+  }
+}
+
+bool Document::loadDocumentBinary (QFile &file)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::loadDocumentBinary";
+
+  // The file is mapped so the point columns are copied straight from the page cache into the Curves. A file that
+  // cannot be mapped is read instead
+  qint64 size = file.size ();
+  uchar *dataMapped = file.map (0, size);
+
+  bool success;
+  if (dataMapped != 0) {
+
+    success = loadDocumentBinarySections (dataMapped,
+                                          size);
+    file.unmap (dataMapped);
+
+  } else {
+
+    QByteArray bytes = file.readAll ();
+    success = loadDocumentBinarySections ((const uchar *) bytes.constData (),
+                                          bytes.size ());
+  }
+
+  return success;
+}
+
+bool Document::loadDocumentBinarySections (const uchar *data,
+                                           qint64 size)
+{
+  if ((size < BINARY_HEADER_SIZE) ||
+      (qFromLittleEndian<quint32> (data + BINARY_MAGIC.size ()) != BINARY_VERSION)) {
+    m_reasonForUnsuccessfulRead = "Document was saved in an unsupported version of the binary format";
+    return false;
+  }
+
+  quint32 sectionCount = qFromLittleEndian<quint32> (data + 12);
+  bool isDamaged = (BINARY_HEADER_SIZE + (qint64) sectionCount * BINARY_SECTION_ENTRY_SIZE > size);
+
+  for (quint32 sectionIndex = 0; !isDamaged && (sectionIndex < sectionCount); sectionIndex++) {
+
+    const uchar *entry = data + BINARY_HEADER_SIZE + sectionIndex * BINARY_SECTION_ENTRY_SIZE;
+    quint32 type = qFromLittleEndian<quint32> (entry);
+    quint64 offset = qFromLittleEndian<quint64> (entry + 8);
+    quint64 sectionSize = qFromLittleEndian<quint64> (entry + 16);
+    if ((offset > (quint64) size) ||
+        (sectionSize > (quint64) size - offset)) {
+      isDamaged = true;
+      break;
+    }
+
+    const uchar *section = data + offset;
+    if (type == BINARY_SECTION_IMAGE) {
+
+      if (!m_imageBytes.isEmpty ()) {
+        isDamaged = true;
+        break;
+      }
+
+      // The original bytes are kept verbatim. Only the header is checked here, and the image is decoded in the
+      // background while the Curves are read
+      m_imageBytes = QByteArray ((const char *) section,
+                                 sectionSize);
+      QBuffer buffer (&m_imageBytes);
+      buffer.open (QIODevice::ReadOnly);
+      if (QImageReader::imageFormat (&buffer).isEmpty ()) {
+        m_reasonForUnsuccessfulRead = "Document image could not be decoded";
+        return false;
+      }
+
+      startImageDecoding ();
+
+    } else if (type == BINARY_SECTION_CURVE) {
+
+      if (sectionSize < (quint64) BINARY_CURVE_HEADER_SIZE) {
+        isDamaged = true;
+        break;
+      }
+
+      quint32 nameSize = qFromLittleEndian<quint32> (section);
+      int columns = qFromLittleEndian<quint32> (section + 4);
+      quint64 count = qFromLittleEndian<quint64> (section + 8);
+      quint64 pointLineWidthBits = qFromLittleEndian<quint64> (section + 40);
+      double pointLineWidth;
+      memcpy (&pointLineWidth, &pointLineWidthBits, sizeof (double));
+
+      quint64 columnsOffset = BINARY_CURVE_HEADER_SIZE + alignBinary (nameSize);
+      if (((columns != CURVE_COLUMNS_SCREEN) && (columns != CURVE_COLUMNS_SCREEN_AND_GRAPH)) ||
+          (columnsOffset > sectionSize) ||
+          (count > (sectionSize - columnsOffset) / (columns * sizeof (double)))) {
+        isDamaged = true;
+        break;
+      }
+
+      QString curveName = QString::fromUtf8 ((const char *) section + BINARY_CURVE_HEADER_SIZE,
+                                             nameSize);
+      LineStyle lineStyle (qFromLittleEndian<quint32> (section + 16),
+                           (ColorPalette) qFromLittleEndian<quint32> (section + 20),
+                           (CurveConnectAs) qFromLittleEndian<quint32> (section + 24));
+      PointStyle pointStyle ((PointShape) qFromLittleEndian<quint32> (section + 36),
+                             qFromLittleEndian<quint32> (section + 28),
+                             pointLineWidth,
+                             (ColorPalette) qFromLittleEndian<quint32> (section + 32));
+
+      Curve curve (curveName,
+                   lineStyle,
+                   pointStyle);
+      curve.appendColumns (count,
+                           columns,
+                           section + columnsOffset);
+
+      if (curveName == AXIS_CURVE_NAME) {
+        *m_curveAxes = curve;
+      } else if (m_curvesGraphs.curveForCurveName (curveName) != 0) {
+        m_reasonForUnsuccessfulRead = QString ("Document has more than one curve named %1").arg (curveName);
+        return false;
+      } else {
+        m_curvesGraphs.addGraphCurveAtEnd (curve);
+      }
+    }
+
+    // The settings models do not save any contents yet, so there is nothing to read from them. Unknown sections are
+    // skipped, so files from later versions can still be opened
+  }
+
+  if (isDamaged) {
+    m_reasonForUnsuccessfulRead = "Document is damaged";
+    return false;
+  } else if (m_imageBytes.isEmpty ()) {
+    m_reasonForUnsuccessfulRead = "Document has no image";
+    return false;
+  }
+
+  return true;
+}
+
+void Document::loadImage (QXmlStreamReader &reader)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::loadImage";
+
+  m_imageBytes = QByteArray::fromBase64 (reader.readElementText ().toLatin1 ());
+
+  // Only the header is checked here. The image is decoded in the background while the Curves are read
+  QBuffer buffer (&m_imageBytes);
+  buffer.open (QIODevice::ReadOnly);
+  if (QImageReader::imageFormat (&buffer).isEmpty ()) {
+    reader.raiseError ("Document image could not be decoded");
+  } else {
+    startImageDecoding ();
+  }
+}
+
+void Document::markPointIdentifierChanged (PointIdentifier pointIdentifier)
+{
+  if (!m_pointIdentifiersChangedAll) {
+    m_pointIdentifiersChanged [pointIdentifier] = true;
+  }
+
+  if (!m_curvesJournalAll) {
+    m_pointIdentifiersJournal [pointIdentifier] = true;
+  }
+}
+
+void Document::markPointIdentifiersChanged (const QHash<PointIdentifier, bool> &pointIdentifiers)
+{
+  if (!m_pointIdentifiersChangedAll) {
+
+    // QHash::unite would add duplicate keys, so the identifiers are inserted one by one
+    QHash<PointIdentifier, bool>::const_iterator itr;
+    for (itr = pointIdentifiers.begin (); itr != pointIdentifiers.end (); itr++) {
+      m_pointIdentifiersChanged [itr.key ()] = true;
+    }
+  }
+
+  if (!m_curvesJournalAll) {
+
+    QHash<PointIdentifier, bool>::const_iterator itr;
+    for (itr = pointIdentifiers.begin (); itr != pointIdentifiers.end (); itr++) {
+      m_pointIdentifiersJournal [itr.key ()] = true;
+    }
+  }
 }
 
 DocumentModelAxesChecker Document::modelAxesChecker() const
@@ -309,34 +825,46 @@ DocumentModelSegments Document::modelSegments() const
   return m_modelSegments;
 }
 
-void Document::movePoint (const QString &pointIdentifier,
+void Document::movePoint (PointIdentifier pointIdentifier,
                           const QPointF &deltaScreen)
 {
-  QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
-
-  Curve *curve = curveForCurveName (curveName);
+  Curve *curve = curveForPointIdentifier (pointIdentifier);
   curve->movePoint (pointIdentifier,
                     deltaScreen);
+  markPointIdentifierChanged (pointIdentifier);
 }
 
 QPixmap Document::pixmap () const
 {
+  if (m_imageIsDecoding) {
+
+    // Waits for the background decoding if it has not finished yet. The QPixmap can only be made in the gui thread
+    m_pixmap.convertFromImage (m_imageDecoding.result ());
+    m_imageIsDecoding = false;
+  }
+
   return m_pixmap;
 }
 
-QPointF Document::positionGraph (const QString &pointIdentifier) const
+const QHash<PointIdentifier, bool> &Document::pointIdentifiersChanged () const
 {
-  QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
+  return m_pointIdentifiersChanged;
+}
 
-  const Curve *curve = curveForCurveName (curveName);
-  return curve->positionGraph (pointIdentifier);
+bool Document::pointIdentifiersChangedAll () const
+{
+  return m_pointIdentifiersChangedAll;
 }
 
-QPointF Document::positionScreen (const QString &pointIdentifier) const
+QPointF Document::positionGraph (PointIdentifier pointIdentifier) const
 {
-  QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
+  const Curve *curve = curveForPointIdentifier (pointIdentifier);
+  return curve->positionGraph (pointIdentifier);
+}
 
-  const Curve *curve = curveForCurveName (curveName);
+QPointF Document::positionScreen (PointIdentifier pointIdentifier) const
+{
+  const Curve *curve = curveForPointIdentifier (pointIdentifier);
   return curve->positionScreen (pointIdentifier);
 }
 
@@ -347,36 +875,228 @@ QString Document::reasonForUnsuccessfulRead () const
   return m_reasonForUnsuccessfulRead;
 }
 
-void Document::removePointAxis (const QString &identifier)
+void Document::removePointAxis (PointIdentifier identifier)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointAxis identifier=" << identifier.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointAxis identifier=" << Point::identifierToString (identifier).toLatin1 ().data ();
 
   m_curveAxes->removePoint (identifier);
+  markPointIdentifierChanged (identifier);
 }
 
-void Document::removePointGraph (const QString &identifier)
+void Document::removePointGraph (PointIdentifier identifier)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointGraph identifier=" << identifier.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointGraph identifier=" << Point::identifierToString (identifier).toLatin1 ().data ();
 
   m_curvesGraphs.removePoint (identifier);
+  markPointIdentifierChanged (identifier);
 }
 
 void Document::removePointsInCurvesGraphs (CurvesGraphs &curvesGraphs)
 {
-  CallbackRemovePointsInCurvesGraphs ftor (*this);
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::removePointsInCurvesGraphs";
 
-  Functor2wRet<const QString &, const Point &, CallbackSearchReturn> ftorWithCallback = functor_ret (ftor,
-                                                                                                     &CallbackRemovePointsInCurvesGraphs::callback);
+  CallbackRemovePointsInCurvesGraphs ftor;
 
-  curvesGraphs.iterateThroughCurvesPoints (ftorWithCallback);
+  curvesGraphs.iterateThroughCurvesPoints (ftor);
+
+  // Removing all points at once costs one pass per Curve, rather than one search per removed point
+  if (!ftor.identifiersAxes ().isEmpty ()) {
+    m_curveAxes->removePoints (ftor.identifiersAxes ());
+    markPointIdentifiersChanged (ftor.identifiersAxes ());
+  }
+  if (!ftor.identifiersGraphs ().isEmpty ()) {
+    m_curvesGraphs.removePoints (ftor.identifiersGraphs ());
+    markPointIdentifiersChanged (ftor.identifiersGraphs ());
+  }
+}
+
+bool Document::replayJournal (const QList<QByteArray> &records)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::replayJournal records=" << records.count ();
+
+  // Journal identifiers were assigned by the process that wrote the journal, so they are mapped to new identifiers
+  QHash<PointIdentifier, PointIdentifier> identifiers;
+
+  bool success = true;
+  QList<QByteArray>::const_iterator itr;
+  for (itr = records.begin (); success && (itr != records.end ()); itr++) {
+
+    QDataStream stream (*itr);
+    stream.setByteOrder (QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision (QDataStream::DoublePrecision);
+
+    quint32 recordType;
+    stream >> recordType;
+    if (recordType == JOURNAL_RECORD_SNAPSHOT) {
+      success = replayJournalSnapshot (stream,
+                                       identifiers);
+    } else if (recordType == JOURNAL_RECORD_DELTA) {
+      success = replayJournalDelta (stream,
+                                    identifiers);
+    } else {
+      success = false;
+    }
+
+    success = success && (stream.status () == QDataStream::Ok);
+  }
+
+  if (!success) {
+    LOG4CPP_ERROR_S ((*mainCat)) << "Document::replayJournal stopped at a record that could not be read";
+  }
+
+  // The recovered changes have not been saved
+  m_isModified = true;
+  m_pointIdentifiersChangedAll = true;
+  m_pointIdentifiersChanged.clear ();
+
+  return success;
+}
+
+bool Document::replayJournalDelta (QDataStream &stream,
+                                   QHash<PointIdentifier, PointIdentifier> &identifiers)
+{
+  quint32 count;
+  stream >> count;
+
+  for (quint32 index = 0; (index < count) && (stream.status () == QDataStream::Ok); index++) {
+
+    PointIdentifier identifierJournal;
+    quint8 isPresent;
+    stream >> identifierJournal >> isPresent;
+
+    PointIdentifier identifier = identifiers.value (identifierJournal, POINT_IDENTIFIER_INVALID);
+    if (isPresent != 0) {
+
+      QString curveName;
+      double xScreen, yScreen, xGraph = 0, yGraph = 0;
+      stream >> curveName >> xScreen >> yScreen;
+      bool isAxis = (curveName == AXIS_CURVE_NAME);
+      if (isAxis) {
+        stream >> xGraph >> yGraph;
+      }
+
+      Curve *curve = curveForCurveName (curveName);
+      if (curve == 0) {
+        return false;
+      }
+
+      QPointF posScreen (xScreen, yScreen);
+      if ((identifier != POINT_IDENTIFIER_INVALID) &&
+          curve->containsPoint (identifier)) {
+
+        // Moved or edited. Moving keeps the place of the Point within its Curve
+        curve->movePoint (identifier,
+                          posScreen - curve->positionScreen (identifier));
+        if (isAxis) {
+          curve->editPoint (QPointF (xGraph, yGraph),
+                            identifier);
+        }
+
+      } else {
+
+        // Added, or restored by an undo
+        identifier = Point::identifierFromSerial (curveName,
+                                                  Point::reserveIdentifierSerials (1));
+        identifiers [identifierJournal] = identifier;
+        curve->addPoint (Point (curveName,
+                                posScreen,
+                                identifier,
+                                QPointF (xGraph, yGraph)));
+      }
+
+    } else if (identifier != POINT_IDENTIFIER_INVALID) {
+
+      Curve *curve = curveForPointIdentifier (identifier);
+      if ((curve != 0) &&
+          curve->containsPoint (identifier)) {
+        curve->removePoint (identifier);
+      }
+      identifiers.remove (identifierJournal);
+    }
+  }
+
+  return true;
+}
+
+bool Document::replayJournalSnapshot (QDataStream &stream,
+                                      QHash<PointIdentifier, PointIdentifier> &identifiers)
+{
+  identifiers.clear ();
+
+  CurvesGraphs curvesGraphs;
+  quint32 curveCount;
+  stream >> curveCount;
+
+  for (quint32 curveIndex = 0; (curveIndex < curveCount) && (stream.status () == QDataStream::Ok); curveIndex++) {
+
+    QString curveName;
+    quint32 lineWidth, lineColor, connectAs, pointShape, pointRadius, pointColor, count;
+    double pointLineWidth;
+    stream >> curveName >> lineWidth >> lineColor >> connectAs >> pointShape >> pointRadius >> pointColor
+           >> pointLineWidth >> count;
+    bool isAxis = (curveName == AXIS_CURVE_NAME);
+
+    Curve curve (curveName,
+                 LineStyle (lineWidth,
+                            (ColorPalette) lineColor,
+                            (CurveConnectAs) connectAs),
+                 PointStyle ((PointShape) pointShape,
+                             pointRadius,
+                             pointLineWidth,
+                             (ColorPalette) pointColor));
+
+    quint64 serial = Point::reserveIdentifierSerials (count);
+    for (quint32 index = 0; (index < count) && (stream.status () == QDataStream::Ok); index++) {
+
+      PointIdentifier identifierJournal;
+      double xScreen, yScreen, xGraph = 0, yGraph = 0;
+      stream >> identifierJournal >> xScreen >> yScreen;
+      if (isAxis) {
+        stream >> xGraph >> yGraph;
+      }
+
+      PointIdentifier identifier = Point::identifierFromCurveIndex (curve.curveIndex (),
+                                                                    serial + index);
+      identifiers [identifierJournal] = identifier;
+      curve.addPoint (Point (curveName,
+                             QPointF (xScreen, yScreen),
+                             identifier,
+                             QPointF (xGraph, yGraph)));
+    }
+
+    if (isAxis) {
+      *m_curveAxes = curve;
+    } else {
+      curvesGraphs.addGraphCurveAtEnd (curve);
+    }
+  }
+
+  if (stream.status () != QDataStream::Ok) {
+    return false;
+  }
+
+  m_curvesGraphs = curvesGraphs;
+
+  return true;
+}
+
+void Document::resetPointIdentifiersChanged ()
+{
+  m_pointIdentifiersChanged.clear ();
+  m_pointIdentifiersChangedAll = false;
 }
 
 void Document::saveDocument(QXmlStreamWriter &stream)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Document::saveDocument";
 
+  m_isModified = false;
+
   stream.writeStartDocument();
   stream.writeDTD("<!DOCTYPE engauge>");
+  stream.writeStartElement("Document");
+  stream.writeAttribute("Version", DOCUMENT_VERSION);
+  saveImage(stream);
   m_modelCoords.saveModel(stream);
   m_modelExport.saveModel(stream);
   m_modelFilter.saveModel(stream);
@@ -384,14 +1104,139 @@ void Document::saveDocument(QXmlStreamWriter &stream)
   m_modelGridRemoval.saveModel(stream);
   m_modelPointMatch.saveModel(stream);
   m_modelSegments.saveModel(stream);
+  m_curveAxes->saveXml(stream);
+  m_curvesGraphs.saveXml(stream);
+  stream.writeEndElement();
   stream.writeEndDocument();
 }
 
+void Document::saveDocumentBinary (QIODevice &device)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::saveDocumentBinary";
+
+  m_isModified = false;
+
+  QByteArray image = imageBytes ();
+  QByteArray settings = saveSettings ();
+
+  // The axis curve comes first, followed by the graph curves in order
+  QList<const Curve*> curves;
+  curves << m_curveAxes;
+  QStringList curveNames = m_curvesGraphs.curvesGraphsNames ();
+  QStringList::const_iterator itrName;
+  for (itrName = curveNames.begin (); itrName != curveNames.end (); itrName++) {
+    curves << m_curvesGraphs.curveForCurveName (*itrName);
+  }
+
+  // The sizes of all sections are needed for the table, which is written first
+  QList<quint32> sectionTypes;
+  QList<quint64> sectionSizes;
+  sectionTypes << BINARY_SECTION_IMAGE << BINARY_SECTION_SETTINGS;
+  sectionSizes << image.size () << settings.size ();
+  QList<const Curve*>::const_iterator itrCurve;
+  for (itrCurve = curves.begin (); itrCurve != curves.end (); itrCurve++) {
+    const Curve *curve = *itrCurve;
+    int columns = (curve == m_curveAxes ? CURVE_COLUMNS_SCREEN_AND_GRAPH : CURVE_COLUMNS_SCREEN);
+    sectionTypes << BINARY_SECTION_CURVE;
+    sectionSizes << BINARY_CURVE_HEADER_SIZE +
+                    alignBinary (curve->curveName ().toUtf8 ().size ()) +
+                    columns * curve->numPoints () * sizeof (double);
+  }
+
+  QDataStream stream (&device);
+  stream.setByteOrder (QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision (QDataStream::DoublePrecision);
+
+  // Header and section table, whose sizes are multiples of the alignment so the first section needs no padding
+  stream.writeRawData (BINARY_MAGIC.constData (),
+                       BINARY_MAGIC.size ());
+  stream << BINARY_VERSION
+         << (quint32) sectionTypes.count ();
+  quint64 offset = BINARY_HEADER_SIZE + sectionTypes.count () * BINARY_SECTION_ENTRY_SIZE;
+  for (int sectionIndex = 0; sectionIndex < sectionTypes.count (); sectionIndex++) {
+    stream << sectionTypes.at (sectionIndex)
+           << (quint32) 0
+           << offset
+           << sectionSizes.at (sectionIndex);
+    offset += alignBinary (sectionSizes.at (sectionIndex));
+  }
+
+  stream.writeRawData (image.constData (),
+                       image.size ());
+  writeBinaryPadding (stream, image.size ());
+
+  stream.writeRawData (settings.constData (),
+                       settings.size ());
+  writeBinaryPadding (stream, settings.size ());
+
+  for (itrCurve = curves.begin (); itrCurve != curves.end (); itrCurve++) {
+
+    const Curve *curve = *itrCurve;
+    int columns = (curve == m_curveAxes ? CURVE_COLUMNS_SCREEN_AND_GRAPH : CURVE_COLUMNS_SCREEN);
+    QByteArray curveName = curve->curveName ().toUtf8 ();
+    LineStyle lineStyle = curve->lineStyle ();
+    PointStyle pointStyle = curve->pointStyle ();
+
+    stream << (quint32) curveName.size ()
+           << (quint32) columns
+           << (quint64) curve->numPoints ()
+           << (quint32) lineStyle.width ()
+           << (quint32) lineStyle.paletteColor ()
+           << (quint32) lineStyle.curveConnectAs ()
+           << (quint32) pointStyle.radius ()
+           << (quint32) pointStyle.paletteColor ()
+           << (quint32) pointStyle.shape ()
+           << pointStyle.lineWidth ();
+    stream.writeRawData (curveName.constData (),
+                         curveName.size ());
+    writeBinaryPadding (stream, curveName.size ());
+
+    // Columns are multiples of eight bytes, so the next section needs no padding
+    curve->writeColumns (stream,
+                         columns);
+  }
+}
+
+void Document::saveImage (QXmlStreamWriter &stream) const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "Document::saveImage";
+
+  // The compressed image bytes are written as base64 so they are valid xml text
+  stream.writeStartElement ("Image");
+  stream.writeCharacters (QString::fromLatin1 (imageBytes ().toBase64 ()));
+  stream.writeEndElement ();
+}
+
+QByteArray Document::saveSettings ()
+{
+  QByteArray settings;
+  QXmlStreamWriter stream (&settings);
+  stream.writeStartDocument ();
+  stream.writeStartElement ("Settings");
+  m_modelCoords.saveModel (stream);
+  m_modelExport.saveModel (stream);
+  m_modelFilter.saveModel (stream);
+  m_modelAxesChecker.saveModel (stream);
+  m_modelGridRemoval.saveModel (stream);
+  m_modelPointMatch.saveModel (stream);
+  m_modelSegments.saveModel (stream);
+  stream.writeEndElement ();
+  stream.writeEndDocument ();
+
+  return settings;
+}
+
 void Document::setCurvesGraphs (const CurvesGraphs &curvesGraphs)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "Document::setCurvesGraphs";
 
   m_curvesGraphs = curvesGraphs;
+
+  // Every Point may have changed, so the changes are not listed one by one
+  m_pointIdentifiersChangedAll = true;
+  m_pointIdentifiersChanged.clear ();
+  m_curvesJournalAll = true;
+  m_pointIdentifiersJournal.clear ();
 }
 
 void Document::setModelAxesChecker(const DocumentModelAxesChecker &modelAxesChecker)
@@ -406,6 +1251,10 @@ void Document::setModelCoords (const DocumentModelCoords &modelCoords)
 
 void Document::setModelCurveProperties(const DocumentModelCurveProperties &modelCurveProperties)
 {
+  // Styles are not in the journal deltas, so the next journal record is a snapshot
+  m_curvesJournalAll = true;
+  m_pointIdentifiersJournal.clear ();
+
   LineStyles::const_iterator itrL;
   for (itrL = modelCurveProperties.lineStyles().constBegin ();
        itrL != modelCurveProperties.lineStyles().constEnd();
@@ -456,6 +1305,13 @@ void Document::setModelSegments(const DocumentModelSegments &modelSegments)
   m_modelSegments = modelSegments;
 }
 
+void Document::startImageDecoding ()
+{
+  m_imageDecoding = QtConcurrent::run (&Document::decodeImage,
+                                       m_imageBytes);
+  m_imageIsDecoding = true;
+}
+
 bool Document::successfulRead () const
 {
   return m_successfulRead;
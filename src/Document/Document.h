@@ -10,24 +10,34 @@
 #include "DocumentModelGridRemoval.h"
 #include "DocumentModelPointMatch.h"
 #include "DocumentModelSegments.h"
+#include "ImagePyramid.h"
 #include "PointStyle.h"
+#include <QByteArray>
+#include <QFuture>
+#include <QImage>
 #include <QList>
 #include <QPixmap>
 #include <QString>
 
 class Curve;
-class QImage;
+class QDataStream;
+class QFile;
+class QIODevice;
 class QTransform;
+class QXmlStreamReader;
 class QXmlStreamWriter;
 
 /// Storage of one imported image and the data attached to that image
 class Document
 {
 public:
-  /// Constructor for imported images and dragged images
-  Document (const QImage &image);
+  /// Constructor for imported images and dragged images. The original compressed bytes of an imported image file are
+  /// kept, so saving never has to encode the image again
+  Document (const QImage &image,
+            const QByteArray &imageBytes = QByteArray ());
 
-  /// Constructor for opened Documents. The specified file is opened and read
+  /// Constructor for opened Documents. The specified file is opened and read, in either the binary format of
+  /// saveDocumentBinary or the xml format of saveDocument
   Document (const QString &fileName);
 
   /// Add new graph curve to the list of existing graph curves.
@@ -39,7 +49,7 @@ public:
   /// \param identifier Identifier for new axis point
   void addPointAxis (const QPointF &posScreen,
                      const QPointF &posGraph,
-                     QString &identifier);
+                     PointIdentifier &identifier);
 
   /// Add a single axis point with the specified point identifier. Call this after checkAddPointAxis to guarantee success in this call.
   /// \param posScreen Screen coordinates from QGraphicsView
@@ -47,24 +57,29 @@ public:
   /// \param identifier Identifier for new axis point
   void addPointAxis (const QPointF &posScreen,
                      const QPointF &posGraph,
-                     const QString &identifier);
+                     PointIdentifier identifier);
 
   /// Add a single graph point with a generated point identifier.
   void addPointGraph (const QString &curveName,
                       const QPointF &posScreen,
-                      QString &identifier);
+                      PointIdentifier &identifier);
 
   /// Add a single graph point with the specified point identifer. Note that PointStyle is not applied to the point within the Document.
   void addPointGraph (const QString &curveName,
                       const QPointF &posScreen,
-                      const QString &identifier);
+                      PointIdentifier identifier);
 
   /// Add all points identified in the specified CurvesGraphs. See also removePointsInCurvesGraphs
-  void addPointsInCurvesGraphs (CurvesGraphs &curvesGraphs);
+  void addPointsInCurvesGraphs (const CurvesGraphs &curvesGraphs);
 
   /// See CurvesGraphs::applyTransformation.
   void applyTransformation (const Transformation &transformation);
 
+  /// Copy the selected graph points into curvesGraphsCaptured, so a command can later remove or restore them. See
+  /// also addPointsInCurvesGraphs and removePointsInCurvesGraphs
+  void capturePointsInCurvesGraphs (const PointIdentifierList &selected,
+                                    CurvesGraphs &curvesGraphsCaptured) const;
+
   /// Check before calling addPointAxis.
   void checkAddPointAxis (const QPointF &posScreen,
                           const QPointF &posGraph,
@@ -72,18 +87,24 @@ public:
                           QString &errorMessage);
 
   /// Check before calling editPointAxis.
-  void checkEditPointAxis (const QString &pointIdentifier,
+  void checkEditPointAxis (PointIdentifier pointIdentifier,
                            const QPointF &posScreen,
                            const QPointF &posGraph,
                            bool &isError,
                            QString &errorMessage);
 
+  /// True if the axis or graph Curve of the specified Point contains it.
+  bool containsPoint (PointIdentifier pointIdentifier) const;
+
   /// Get method for axis curve.
   const Curve &curveAxes () const;
 
   /// See CurvesGraphs::curveForCurveNames, although this also works for AXIS_CURVE_NAME.
   const Curve *curveForCurveName (const QString &curveName) const;
 
+  /// See CurvesGraphs::curveForPointIdentifier, although this also works for axis points.
+  const Curve *curveForPointIdentifier (PointIdentifier pointIdentifier) const;
+
   /// Make all Curves available, read only, for CmdAbstract classes only.
   const CurvesGraphs &curvesGraphs () const;
 
@@ -95,19 +116,39 @@ public:
 
   /// Edit the graph coordinates of a single axis point. Call this after checkAddPointAxis to guarantee success in this call
   void editPointAxis (const QPointF &posGraph,
-                      const QString &identifier);
+                      PointIdentifier identifier);
+
+  /// Return the downsampled copies of the image, for previews. This waits for imagePyramidFuture, and every copy that
+  /// is returned shares its images.
+  ImagePyramid imagePyramid () const;
+
+  /// Return the ImagePyramid as it is built in a worker thread, which is started by the first call of this or
+  /// imagePyramid. The pyramid is only built once, and the future keeps it after it finishes.
+  QFuture<ImagePyramid> imagePyramidFuture () const;
 
   /// Return true if Document has changed since last time file was saved.
   bool isModified () const;
 
   /// See Curve::iterateThroughCurvePoints, for the axes curve.
-  void iterateThroughCurvePointsAxes (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback);
+  template<typename Visitor>
+  CallbackSearchReturn iterateThroughCurvePointsAxes (Visitor &visitor) const;
 
-  /// See Curve::iterateThroughCurvePoints, for the axes curve.
-  void iterateThroughCurvePointsAxes (const Functor2wRet<const QString  &, const Point &, CallbackSearchReturn> &ftorWithCallback) const;
+  /// See CurvesGraphs::iterateThroughCurvesPoints, for all the graphs curves.
+  template<typename Visitor>
+  CallbackSearchReturn iterateThroughCurvesPointsGraphs (Visitor &visitor) const;
 
-  /// See Curve::iterateThroughCurvePoints, for all the graphs curves.
-  void iterateThroughCurvesPointsGraphs (const Functor2wRet<const QString &, const Point &, CallbackSearchReturn> &ftorWithCallback);
+  /// See CurvesGraphs::iterateThroughCurvesPointsConcurrently, for all the graphs curves.
+  template<typename Visitor>
+  QList<Visitor> iterateThroughCurvesPointsGraphsConcurrently (const Visitor &prototype) const;
+
+  /// Return a DocumentJournal record with the Points that were added, moved, edited or removed since the last call to
+  /// journalDelta or journalSnapshot, so its size is proportional to the edit. If the Curves were replaced or restyled
+  /// in the meantime, this returns a snapshot instead.
+  QByteArray journalDelta ();
+
+  /// Return a DocumentJournal record with all of the Curves, including their styles and Points, which starts the
+  /// record of changes over. Later journalDelta records refer to the Points by the identifiers in this snapshot.
+  QByteArray journalSnapshot ();
 
   /// Get method for DocumentModelAxesChecker.
   DocumentModelAxesChecker modelAxesChecker() const;
@@ -134,33 +175,56 @@ public:
   DocumentModelSegments modelSegments() const;
 
   /// See Curve::movePoint
-  void movePoint (const QString &pointIdentifier,
+  void movePoint (PointIdentifier pointIdentifier,
                   const QPointF &deltaScreen);
 
-  /// Return the image that is being digitized.
+  /// Return the image that is being digitized. For an opened Document the image is decoded in the background, and
+  /// the first call waits for the decoding to finish if necessary.
   QPixmap pixmap () const;
 
+  /// Identifiers of the Points that were added, moved, edited or removed since the last call to
+  /// resetPointIdentifiersChanged. The hash is empty when pointIdentifiersChangedAll is true.
+  const QHash<PointIdentifier, bool> &pointIdentifiersChanged () const;
+
+  /// True if all Points may have changed since the last call to resetPointIdentifiersChanged, as in a new Document or
+  /// after setCurvesGraphs. Views must then resynchronize completely rather than use pointIdentifiersChanged.
+  bool pointIdentifiersChangedAll () const;
+
   /// See Curve::positionGraph.
-  QPointF positionGraph (const QString &pointIdentifier) const;
+  QPointF positionGraph (PointIdentifier pointIdentifier) const;
 
   /// See Curve::positionScreen.
-  QPointF positionScreen (const QString &pointIdentifier) const;
+  QPointF positionScreen (PointIdentifier pointIdentifier) const;
 
   /// Return an informative text message explaining why startup loading failed. Applies if successfulRead returns false
   QString reasonForUnsuccessfulRead () const;
 
+  /// Clear the record of changed Points, once the views have been brought up to date with it.
+  void resetPointIdentifiersChanged ();
+
   /// Perform the opposite of addPointAxis.
-  void removePointAxis (const QString &identifier);
+  void removePointAxis (PointIdentifier identifier);
 
   /// Perform the opposite of addPointGraph.
-  void removePointGraph (const QString &identifier);
+  void removePointGraph (PointIdentifier identifier);
 
   /// Remove all points identified in the specified CurvesGraphs. See also addPointsInCurvesGraphs
   void removePointsInCurvesGraphs (CurvesGraphs &curvesGraphs);
 
-  /// Save document
+  /// Apply the records of a DocumentJournal, which start with a snapshot, to recover the Curves as they were when the
+  /// journal was last written. The Document is then marked as modified. Returns false if a record could not be read,
+  /// in which case the records before it have been applied.
+  bool replayJournal (const QList<QByteArray> &records);
+
+  /// Save document. The image, settings and Curves are written inside one Document element, which the constructor
+  /// that takes a file name reads back in a single pass.
   void saveDocument(QXmlStreamWriter &stream);
 
+  /// Save document in the binary format. The original image bytes, the settings models and each Curve are stored in
+  /// sections listed in a table at the start. The Points of each Curve are stored as columns of little endian
+  /// doubles, so opening the Document copies them straight from the memory mapped file.
+  void saveDocumentBinary (QIODevice &device);
+
   /// Let CmdAbstract classes overwrite CurvesGraphs.
   void setCurvesGraphs (const CurvesGraphs &curvesGraphs);
 
@@ -194,11 +258,38 @@ public:
 private:
   Document ();
 
+  static ImagePyramid buildImagePyramid (QImage image);
   Curve *curveForCurveName (const QString &curveName); // For use by Document only. External classes should use functors
+  Curve *curveForPointIdentifier (PointIdentifier pointIdentifier);
+  static QImage decodeImage (QByteArray imageBytes);
+  QByteArray imageBytes () const;
+  void loadDocument (QXmlStreamReader &reader);
+  bool loadDocumentBinary (QFile &file);
+  bool loadDocumentBinarySections (const uchar *data,
+                                   qint64 size);
+  void loadImage (QXmlStreamReader &reader);
+  void markPointIdentifierChanged (PointIdentifier pointIdentifier);
+  void markPointIdentifiersChanged (const QHash<PointIdentifier, bool> &pointIdentifiers);
+  bool replayJournalDelta (QDataStream &stream,
+                           QHash<PointIdentifier, PointIdentifier> &identifiers);
+  bool replayJournalSnapshot (QDataStream &stream,
+                              QHash<PointIdentifier, PointIdentifier> &identifiers);
+  void saveImage (QXmlStreamWriter &stream) const;
+  QByteArray saveSettings ();
+  void startImageDecoding ();
 
   // Metadata
   QString m_name;
-  QPixmap m_pixmap;
+
+  // Image, and its compressed bytes. The bytes are the original file contents when there is one, and otherwise an
+  // encoding that is made on the first save. An opened image is decoded in the background into m_imageDecoding, and
+  // is moved into m_pixmap when it is first needed
+  mutable QPixmap m_pixmap;
+  mutable QByteArray m_imageBytes;
+  QFuture<QImage> m_imageDecoding;
+  mutable bool m_imageIsDecoding;
+  mutable QFuture<ImagePyramid> m_imagePyramidBuilding; // Not started until imagePyramidFuture is first called
+  mutable bool m_imagePyramidIsStarted;
 
   // Read variables
   bool m_successfulRead;
@@ -207,6 +298,14 @@ private:
   // Dirty flag
   bool m_isModified;
 
+  // Points changed since the views were last brought up to date, so the views only need to visit those Points
+  QHash<PointIdentifier, bool> m_pointIdentifiersChanged;
+  bool m_pointIdentifiersChangedAll;
+
+  // Same for the next journal record. This is kept apart since the views reset theirs in the middle of each command
+  QHash<PointIdentifier, bool> m_pointIdentifiersJournal;
+  bool m_curvesJournalAll;
+
   // Curves
   Curve *m_curveAxes;
   CurvesGraphs m_curvesGraphs;
@@ -222,4 +321,24 @@ private:
   DocumentModelSegments m_modelSegments;
 };
 
+template<typename Visitor>
+CallbackSearchReturn Document::iterateThroughCurvePointsAxes (Visitor &visitor) const
+{
+  Q_CHECK_PTR (m_curveAxes);
+
+  return m_curveAxes->iterateThroughCurvePoints (visitor);
+}
+
+template<typename Visitor>
+CallbackSearchReturn Document::iterateThroughCurvesPointsGraphs (Visitor &visitor) const
+{
+  return m_curvesGraphs.iterateThroughCurvesPoints (visitor);
+}
+
+template<typename Visitor>
+QList<Visitor> Document::iterateThroughCurvesPointsGraphsConcurrently (const Visitor &prototype) const
+{
+  return m_curvesGraphs.iterateThroughCurvesPointsConcurrently (prototype);
+}
+
 #endif // DOCUMENT_H
@@ -0,0 +1,233 @@
+#include "DocumentJournal.h"
+#include "Logger.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtConcurrentRun>
+
+// Header with the magic bytes, version, padding, and the size and modification time of the Document file. Records
+// follow, each with its size and checksum. All numbers are little endian
+const QByteArray JOURNAL_MAGIC ("EngaugeJ");
+const quint32 JOURNAL_VERSION = 1;
+
+const QString JOURNAL_SUFFIX (".journal"); // Appended to the Document file name
+const QString JOURNAL_SUFFIX_TEMPORARY (".tmp"); // Appended to the journal file name while compacting
+
+const qint64 JOURNAL_COMPACTION_MINIMUM = 1024 * 1024; // Small journals are not worth compacting
+
+DocumentJournal::DocumentJournal(const QString &fileNameDocument,
+                                 const QByteArray &snapshot,
+                                 QObject *parent) :
+  QObject (parent),
+  m_fileNameDocument (fileNameDocument),
+  m_fileName (fileNameForDocument (fileNameDocument)),
+  m_isCompacting (false),
+  m_bytesSnapshot (0),
+  m_bytesSinceSnapshot (0)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "DocumentJournal::DocumentJournal fileName=" << m_fileName.toLatin1 ().data ();
+
+  connect (&m_watcherCompaction, SIGNAL (finished ()), this, SLOT (slotCompactionFinished ()));
+
+  // The first snapshot is written like any later one, so opening or saving a large Document does not wait for it
+  compact (snapshot);
+}
+
+DocumentJournal::~DocumentJournal()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "DocumentJournal::~DocumentJournal fileName=" << m_fileName.toLatin1 ().data ();
+
+  m_watcherCompaction.waitForFinished ();
+
+  m_file.close ();
+  QFile::remove (m_fileName + JOURNAL_SUFFIX_TEMPORARY);
+  QFile::remove (m_fileName);
+}
+
+void DocumentJournal::append (const QByteArray &record)
+{
+  QByteArray recordFramed = frameRecord (record);
+  m_bytesSinceSnapshot += recordFramed.size ();
+
+  if (m_isCompacting) {
+    m_recordsPending += recordFramed;
+  }
+
+  // Until the new snapshot replaces it, the current journal keeps receiving every record so it stays complete
+  if (m_file.isOpen ()) {
+    if ((m_file.write (recordFramed) != recordFramed.size ()) ||
+        !m_file.flush ()) {
+
+      LOG4CPP_ERROR_S ((*mainCat)) << "DocumentJournal::append failed. error="
+                                   << m_file.errorString ().toLatin1 ().data ();
+    }
+  }
+}
+
+void DocumentJournal::compact (const QByteArray &snapshot)
+{
+  if (m_isCompacting) {
+    return;
+  }
+
+  LOG4CPP_INFO_S ((*mainCat)) << "DocumentJournal::compact bytes=" << snapshot.size ();
+
+  m_isCompacting = true;
+  m_recordsPending.clear ();
+  m_bytesSnapshot = snapshot.size ();
+  m_bytesSinceSnapshot = 0;
+
+  m_watcherCompaction.setFuture (QtConcurrent::run (&DocumentJournal::writeFile,
+                                                    m_fileName + JOURNAL_SUFFIX_TEMPORARY,
+                                                    header (m_fileNameDocument) + frameRecord (snapshot)));
+}
+
+QString DocumentJournal::fileNameForDocument (const QString &fileNameDocument)
+{
+  return fileNameDocument + JOURNAL_SUFFIX;
+}
+
+QByteArray DocumentJournal::frameRecord (const QByteArray &record)
+{
+  QByteArray recordFramed;
+  QDataStream stream (&recordFramed, QIODevice::WriteOnly);
+  stream.setByteOrder (QDataStream::LittleEndian);
+
+  stream << (quint32) record.size ()
+         << (quint32) qChecksum (record.constData (), record.size ());
+  stream.writeRawData (record.constData (),
+                       record.size ());
+
+  return recordFramed;
+}
+
+QByteArray DocumentJournal::header (const QString &fileNameDocument)
+{
+  QFileInfo fileInfo (fileNameDocument);
+
+  QByteArray bytes;
+  QDataStream stream (&bytes, QIODevice::WriteOnly);
+  stream.setByteOrder (QDataStream::LittleEndian);
+
+  stream.writeRawData (JOURNAL_MAGIC.constData (),
+                       JOURNAL_MAGIC.size ());
+  stream << JOURNAL_VERSION
+         << (quint32) 0
+         << (qint64) fileInfo.size ()
+         << (qint64) fileInfo.lastModified ().toMSecsSinceEpoch ();
+
+  return bytes;
+}
+
+bool DocumentJournal::isDueForCompaction () const
+{
+  return !m_isCompacting &&
+      (m_bytesSinceSnapshot > qMax (JOURNAL_COMPACTION_MINIMUM, m_bytesSnapshot));
+}
+
+bool DocumentJournal::readRecords (const QString &fileNameDocument,
+                                   QList<QByteArray> &records)
+{
+  QString fileName = fileNameForDocument (fileNameDocument);
+
+  // QFile::rename does not replace an existing file, so the journal is briefly missing while it is being replaced. The
+  // temporary file is complete at that point, and a partially written one fails the checksum of its snapshot
+  if (!QFile::exists (fileName)) {
+    fileName += JOURNAL_SUFFIX_TEMPORARY;
+  }
+
+  return readRecordsFromFile (fileName,
+                              fileNameDocument,
+                              records);
+}
+
+bool DocumentJournal::readRecordsFromFile (const QString &fileName,
+                                           const QString &fileNameDocument,
+                                           QList<QByteArray> &records)
+{
+  records.clear ();
+
+  QFile file (fileName);
+  if (!file.open (QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  LOG4CPP_INFO_S ((*mainCat)) << "DocumentJournal::readRecordsFromFile fileName=" << file.fileName ().toLatin1 ().data ();
+
+  QByteArray headerExpected = header (fileNameDocument);
+  if (file.read (headerExpected.size ()) != headerExpected) {
+
+    LOG4CPP_INFO_S ((*mainCat)) << "DocumentJournal::readRecordsFromFile ignoring journal of another version of the document";
+    return false;
+  }
+
+  QDataStream stream (&file);
+  stream.setByteOrder (QDataStream::LittleEndian);
+
+  while (!stream.atEnd ()) {
+
+    quint32 size, checksum;
+    stream >> size >> checksum;
+    if ((stream.status () != QDataStream::Ok) ||
+        (size > file.bytesAvailable ())) {
+      break;
+    }
+
+    QByteArray record (size, 0);
+    if ((stream.readRawData (record.data (), size) != (int) size) ||
+        (qChecksum (record.constData (), size) != checksum)) {
+      break;
+    }
+
+    records << record;
+  }
+
+  return !records.isEmpty ();
+}
+
+void DocumentJournal::slotCompactionFinished ()
+{
+  m_isCompacting = false;
+
+  QString fileNameTemporary = m_fileName + JOURNAL_SUFFIX_TEMPORARY;
+
+  // Carry over the records that were appended while the snapshot was being written
+  QFile fileTemporary (fileNameTemporary);
+  bool success = m_watcherCompaction.result () &&
+                 fileTemporary.open (QIODevice::WriteOnly | QIODevice::Append) &&
+                 (fileTemporary.write (m_recordsPending) == m_recordsPending.size ());
+  fileTemporary.close ();
+  m_recordsPending.clear ();
+
+  if (!success) {
+
+    // The current journal, if there is one, is still complete so it is kept
+    LOG4CPP_ERROR_S ((*mainCat)) << "DocumentJournal::slotCompactionFinished could not write "
+                                 << fileNameTemporary.toLatin1 ().data ();
+    QFile::remove (fileNameTemporary);
+    return;
+  }
+
+  // QFile::rename does not replace an existing file. A crash between the two steps leaves only the complete temporary
+  // file, which readRecords falls back to
+  m_file.close ();
+  QFile::remove (m_fileName);
+  m_file.setFileName (m_fileName);
+  if (!QFile::rename (fileNameTemporary, m_fileName) ||
+      !m_file.open (QIODevice::WriteOnly | QIODevice::Append)) {
+
+    LOG4CPP_ERROR_S ((*mainCat)) << "DocumentJournal::slotCompactionFinished could not replace "
+                                 << m_fileName.toLatin1 ().data ();
+  }
+}
+
+bool DocumentJournal::writeFile (QString fileName,
+                                 QByteArray bytes)
+{
+  // Runs in a worker thread
+  QFile file (fileName);
+
+  return file.open (QIODevice::WriteOnly) &&
+      (file.write (bytes) == bytes.size ()) &&
+      file.flush ();
+}
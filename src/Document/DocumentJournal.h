@@ -0,0 +1,88 @@
+#ifndef DOCUMENT_JOURNAL_H
+#define DOCUMENT_JOURNAL_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+/// Append-only journal that is kept next to a saved Document file, so the changes made since the last save survive a
+/// crash.
+///
+/// The journal starts with a snapshot of the Curves (see Document::journalSnapshot), and each command that is done,
+/// undone or redone appends one record with just the Points it changed (see Document::journalDelta), so the cost of
+/// each autosave is proportional to the edit. Once the appended records outgrow the snapshot, the journal is
+/// compacted by writing a new snapshot to a temporary file in a background thread, which then replaces the journal.
+/// Records appended in the meantime are kept in memory and carried over.
+///
+/// The journal is removed when it is deleted, which happens when the Document is saved, closed or replaced. A journal
+/// that is found when the Document file is opened therefore holds changes that were lost, and is replayed with
+/// Document::replayJournal. The header records the size and modification time of the Document file, so a journal
+/// for a different version of the file is ignored
+class DocumentJournal : public QObject
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor. Any earlier journal of the Document file is replaced once the snapshot has been written.
+  DocumentJournal(const QString &fileNameDocument,
+                  const QByteArray &snapshot,
+                  QObject *parent);
+
+  /// Wait for any compaction to finish, and then remove the journal.
+  virtual ~DocumentJournal();
+
+  /// Append one record, and flush it to the file.
+  void append (const QByteArray &record);
+
+  /// Write the snapshot into a new journal in the background, unless that is already being done.
+  void compact (const QByteArray &snapshot);
+
+  /// Name of the journal file for the specified Document file.
+  static QString fileNameForDocument (const QString &fileNameDocument);
+
+  /// True if the records appended since the last snapshot take more space than the snapshot, so compacting the
+  /// journal costs no more than the appends already did.
+  bool isDueForCompaction () const;
+
+  /// Read the records from the journal of the specified Document file. Returns false if there is no journal, or if
+  /// it belongs to a different version of the Document file. A record that was only partially written before a crash
+  /// ends the records. If the crash happened while the journal was being replaced, the new journal is read from the
+  /// temporary file.
+  static bool readRecords (const QString &fileNameDocument,
+                           QList<QByteArray> &records);
+
+private slots:
+  void slotCompactionFinished ();
+
+private:
+  DocumentJournal();
+
+  static QByteArray frameRecord (const QByteArray &record);
+  static QByteArray header (const QString &fileNameDocument);
+  static bool readRecordsFromFile (const QString &fileName,
+                                   const QString &fileNameDocument,
+                                   QList<QByteArray> &records);
+  static bool writeFile (QString fileName,
+                         QByteArray bytes);
+
+  QString m_fileNameDocument;
+  QString m_fileName;
+
+  // Journal that records are appended to. It is closed until the first snapshot has been written
+  QFile m_file;
+
+  // Background compaction, and the framed records that were appended while it was running. The flag stays set until
+  // the finished signal has been handled, since the records are only carried over then
+  QFutureWatcher<bool> m_watcherCompaction;
+  bool m_isCompacting;
+  QByteArray m_recordsPending;
+
+  // Sizes that decide when to compact again
+  qint64 m_bytesSnapshot;
+  qint64 m_bytesSinceSnapshot;
+};
+
+#endif // DOCUMENT_JOURNAL_H
@@ -0,0 +1,68 @@
+#include "ImagePyramid.h"
+#include "Logger.h"
+
+const int MINIMUM_LEVEL_SIZE = 64; // Levels are added until the width or height would drop below this
+
+ImagePyramid::ImagePyramid()
+{
+}
+
+ImagePyramid::ImagePyramid(const QImage &image)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "ImagePyramid::ImagePyramid";
+
+  // Each level is filtered down from the previous level, which is much cheaper than from the full size image
+  QImage level = image;
+  m_levels << level;
+  while ((level.width () / 2 >= MINIMUM_LEVEL_SIZE) &&
+         (level.height () / 2 >= MINIMUM_LEVEL_SIZE)) {
+
+    level = level.scaled (level.width () / 2,
+                          level.height () / 2,
+                          Qt::IgnoreAspectRatio,
+                          Qt::SmoothTransformation);
+    m_levels << level;
+  }
+}
+
+QImage ImagePyramid::imageForSize (const QSize &sizeView) const
+{
+  if (m_levels.isEmpty ()) {
+    return QImage ();
+  }
+
+  // A level that is fit into the view is shown at one pixel per screen pixel or better when it is at least as
+  // wide, or at least as tall, as the view
+  int level = 0;
+  while ((level + 1 < m_levels.count ()) &&
+         ((m_levels.at (level + 1).width () >= sizeView.width ()) ||
+          (m_levels.at (level + 1).height () >= sizeView.height ()))) {
+    ++level;
+  }
+
+  return m_levels.at (level);
+}
+
+QImage ImagePyramid::imageFull () const
+{
+  if (m_levels.isEmpty ()) {
+    return QImage ();
+  }
+
+  return m_levels.first ();
+}
+
+QImage ImagePyramid::imageLevel (int level) const
+{
+  return m_levels.at (level);
+}
+
+bool ImagePyramid::isEmpty () const
+{
+  return m_levels.isEmpty ();
+}
+
+int ImagePyramid::numLevels () const
+{
+  return m_levels.count ();
+}
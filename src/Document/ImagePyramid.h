@@ -0,0 +1,45 @@
+#ifndef IMAGE_PYRAMID_H
+#define IMAGE_PYRAMID_H
+
+#include <QImage>
+#include <QList>
+#include <QSize>
+
+/// Downsampled copies of the Document image, each half the size of the previous one, for previews that are much
+/// smaller than the image.
+///
+/// The Document builds its pyramid once, in a worker thread, when it is first asked for. The images and the list are
+/// implicitly shared and reference counted by Qt, so copies of the pyramid, such as those held by the settings
+/// dialogs, their worker threads and the background items of the main window, share the same pixels instead of each
+/// holding their own copy of the image
+class ImagePyramid
+{
+public:
+  /// Default constructor for an empty pyramid.
+  ImagePyramid();
+
+  /// Constructor that builds all levels from the full size image.
+  ImagePyramid(const QImage &image);
+
+  /// Full size image, which is level zero.
+  QImage imageFull () const;
+
+  /// Return the smallest level that still has at least one pixel per screen pixel when it is fit into a view of the
+  /// specified size.
+  QImage imageForSize (const QSize &sizeView) const;
+
+  /// Return the specified level, where level zero is the full size image.
+  QImage imageLevel (int level) const;
+
+  /// True if there are no levels.
+  bool isEmpty () const;
+
+  /// Number of levels, including the full size image.
+  int numLevels () const;
+
+private:
+
+  QList<QImage> m_levels; // Level zero is the full size image
+};
+
+#endif // IMAGE_PYRAMID_H
@@ -1,38 +1,115 @@
 #include "CurvesGraphs.h"
 #include "ExportToClipboard.h"
 #include <QStringList>
-#include <QTextStream>
+
+const char TAB_DELIMITER = '\t';
+
+// Estimates of the bytes per point, so each rendering allocates its buffer once for typical coordinates
+const int CSV_BYTES_PER_POINT = 24;
+const int HTML_BYTES_PER_POINT = 48;
 
 ExportToClipboard::ExportToClipboard()
 {
 }
 
-void ExportToClipboard::exportToClipboard (const QStringList &selected,
-                                           bool transformIsDefined,
-                                           QTextStream &strCsv,
-                                           QTextStream &strHtml,
-                                           CurvesGraphs &curvesGraphs) const
+void ExportToClipboard::appendNumber (QByteArray &bytes,
+                                      double value) const
 {
-  // For speed, build a hash as a fast lookup table
-  QHash<QString, bool> selectedHash;
-  QStringList::const_iterator itrH;
-  for (itrH = selected.begin (); itrH != selected.end (); itrH++) {
-    QString pointIdentifier = *itrH;
-    selectedHash [pointIdentifier] = false;
-  }
+  // Same notation and precision as the QTextStream default, which was used originally, and independent of the locale
+  bytes += QByteArray::number (value, 'g', 6);
+}
 
-  // Export
-  QStringList curveNames = curvesGraphs.curvesGraphsNames();
+MimePointsCurves ExportToClipboard::exportCoordinates (const CurvesGraphs &curvesGraphsCaptured,
+                                                       bool transformIsDefined) const
+{
+  MimePointsCurves curves;
+
+  QStringList curveNames = curvesGraphsCaptured.curvesGraphsNames();
   QStringList::const_iterator itrC;
   for (itrC = curveNames.begin(); itrC != curveNames.end (); itrC++) {
 
-    QString curveName = *itrC;
-    const Curve *curve = curvesGraphs.curveForCurveName(curveName);
+    const Curve *curve = curvesGraphsCaptured.curveForCurveName(*itrC);
     Q_CHECK_PTR (curve);
-    curve->exportToClipboard (selectedHash,
-                              transformIsDefined,
-                              strCsv,
-                              strHtml,
-                              curvesGraphs);
+
+    if (curve->numPoints () > 0) {
+
+      MimePointsCurve mimeCurve;
+      mimeCurve.curveName = curve->curveName ();
+      curve->positions (transformIsDefined,
+                        mimeCurve.x,
+                        mimeCurve.y);
+
+      curves << mimeCurve;
+    }
   }
+
+  return curves;
+}
+
+QByteArray ExportToClipboard::exportCsv (const MimePointsCurves &curves) const
+{
+  int numPoints = 0;
+  MimePointsCurves::const_iterator itrC;
+  for (itrC = curves.begin(); itrC != curves.end (); itrC++) {
+    numPoints += itrC->x.count ();
+  }
+
+  // Rows are appended straight to the bytes, without an intermediate QString per row or for the whole text
+  QByteArray csv;
+  csv.reserve (numPoints * CSV_BYTES_PER_POINT);
+
+  for (itrC = curves.begin(); itrC != curves.end (); itrC++) {
+
+    const MimePointsCurve &curve = *itrC;
+
+    // Insert headers to identify the points that follow
+    csv += "X";
+    csv += TAB_DELIMITER;
+    csv += curve.curveName.toUtf8 ();
+    csv += '\n';
+
+    for (int i = 0; i < curve.x.count (); i++) {
+
+      appendNumber (csv, curve.x.at (i));
+      csv += TAB_DELIMITER;
+      appendNumber (csv, curve.y.at (i));
+      csv += '\n';
+    }
+  }
+
+  return csv;
+}
+
+QByteArray ExportToClipboard::exportHtml (const MimePointsCurves &curves) const
+{
+  int numPoints = 0;
+  MimePointsCurves::const_iterator itrC;
+  for (itrC = curves.begin(); itrC != curves.end (); itrC++) {
+    numPoints += itrC->x.count ();
+  }
+
+  QByteArray html;
+  html.reserve (numPoints * HTML_BYTES_PER_POINT);
+
+  for (itrC = curves.begin(); itrC != curves.end (); itrC++) {
+
+    const MimePointsCurve &curve = *itrC;
+
+    html += "<table>\n<tr><th>X</th><th>";
+    html += curve.curveName.toHtmlEscaped ().toUtf8 ();
+    html += "</th></tr>\n";
+
+    for (int i = 0; i < curve.x.count (); i++) {
+
+      html += "<tr><td>";
+      appendNumber (html, curve.x.at (i));
+      html += "</td><td>";
+      appendNumber (html, curve.y.at (i));
+      html += "</td></tr>\n";
+    }
+
+    html += "</table>\n";
+  }
+
+  return html;
 }
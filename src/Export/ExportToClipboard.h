@@ -1,9 +1,10 @@
 #ifndef EXPORT_TO_CLIPBOARD_H
 #define EXPORT_TO_CLIPBOARD_H
 
+#include "MimePointsCurve.h"
+#include <QByteArray>
+
 class CurvesGraphs;
-class QStringList;
-class QTextStream;
 
 /// Strategy class for exporting to the clipboard. This strategy is external to the Document class so that class is simpler.
 class ExportToClipboard
@@ -12,12 +13,21 @@ public:
   /// Single constructor.
   ExportToClipboard();
 
-  /// Export, curve-by-curve, raw data points to a string that will be copied to the clipboard.
-  void exportToClipboard (const QStringList &selected,
-                          bool transformIsDefined,
-                          QTextStream &strCsv,
-                          QTextStream &strHtml,
-                          CurvesGraphs &curvesGraphs) const;
+  /// Snapshot, curve-by-curve, the coordinates of the points previously captured by
+  /// Document::capturePointsInCurvesGraphs. These are graph coordinates if the transform is defined, and screen
+  /// coordinates otherwise. No text is formatted here; MimePoints does that when a format is requested.
+  MimePointsCurves exportCoordinates (const CurvesGraphs &curvesGraphsCaptured,
+                                      bool transformIsDefined) const;
+
+  /// Render the coordinates as tab-delimited text, with a header line before each curve.
+  QByteArray exportCsv (const MimePointsCurves &curves) const;
+
+  /// Render the coordinates as html, with one table per curve.
+  QByteArray exportHtml (const MimePointsCurves &curves) const;
+
+private:
+  void appendNumber (QByteArray &bytes,
+                     double value) const;
 };
 
 #endif // EXPORT_TO_CLIPBOARD_H
@@ -0,0 +1,161 @@
+#include "GraphicsBackground.h"
+#include "Logger.h"
+#include <qmath.h>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QStyleOptionGraphicsItem>
+
+const int TILE_SIZE = 256; // Width and height of each tile, in pixels of its level
+
+static qint64 tilesSerialNext = 1; // Items are only created and painted in the gui thread
+
+GraphicsBackground::GraphicsBackground(const QImage &image) :
+  m_image (image),
+  m_tilesSerial (tilesSerialNext++)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsBackground::GraphicsBackground"
+                              << " width=" << image.width ()
+                              << " height=" << image.height ();
+
+  // Exposed rectangle is needed to pick the visible tiles
+  setFlag (QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+GraphicsBackground::~GraphicsBackground()
+{
+}
+
+QRectF GraphicsBackground::boundingRect () const
+{
+  return QRectF (0,
+                 0,
+                 m_image.width (),
+                 m_image.height ());
+}
+
+const QImage &GraphicsBackground::image () const
+{
+  return m_image;
+}
+
+void GraphicsBackground::invalidateTiles ()
+{
+  m_tilesSerial = tilesSerialNext++;
+  update ();
+}
+
+QImage GraphicsBackground::levelImage (int level) const
+{
+  if (level == 0) {
+    return m_image;
+  }
+
+  return m_imagePyramid.imageLevel (level);
+}
+
+int GraphicsBackground::levelForScale (double scale) const
+{
+  // Each level halves the resolution, so the level with at least one image pixel per screen pixel is used
+  int level = 0;
+  if (scale > 0) {
+    while ((level + 1 < m_imagePyramid.numLevels ()) && (scale <= 0.5 / qPow (2.0, level))) {
+      ++level;
+    }
+  }
+
+  return level;
+}
+
+void GraphicsBackground::paint (QPainter *painter,
+                                const QStyleOptionGraphicsItem *option,
+                                QWidget * /* widget */)
+{
+  if (m_image.isNull ()) {
+    return;
+  }
+
+  double scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform (painter->worldTransform ());
+  int level = levelForScale (scale);
+  QImage image = levelImage (level);
+
+  // Size of one pixel of the level, in item coordinates. Rounding while halving makes this slightly different
+  // in each direction
+  double pixelWidth = (double) m_image.width () / image.width ();
+  double pixelHeight = (double) m_image.height () / image.height ();
+
+  QRectF exposed = option->exposedRect & boundingRect ();
+  if (exposed.isEmpty ()) {
+    return;
+  }
+
+  // Smoothing, when the view asks for it, only applies when zoomed out, so zoomed in pixels stay sharp
+  painter->setRenderHint (QPainter::SmoothPixmapTransform,
+                          painter->testRenderHint (QPainter::SmoothPixmapTransform) && (scale < 1.0));
+
+  int columnMin = qMax (0, qFloor (exposed.left () / (pixelWidth * TILE_SIZE)));
+  int columnMax = qMin ((image.width () - 1) / TILE_SIZE, qFloor (exposed.right () / (pixelWidth * TILE_SIZE)));
+  int rowMin = qMax (0, qFloor (exposed.top () / (pixelHeight * TILE_SIZE)));
+  int rowMax = qMin ((image.height () - 1) / TILE_SIZE, qFloor (exposed.bottom () / (pixelHeight * TILE_SIZE)));
+
+  for (int row = rowMin; row <= rowMax; row++) {
+    for (int column = columnMin; column <= columnMax; column++) {
+
+      QPixmap pixmap = tile (level,
+                             column,
+                             row);
+      QRectF target (column * TILE_SIZE * pixelWidth,
+                     row * TILE_SIZE * pixelHeight,
+                     pixmap.width () * pixelWidth,
+                     pixmap.height () * pixelHeight);
+
+      painter->drawPixmap (target,
+                           pixmap,
+                           QRectF (pixmap.rect ()));
+    }
+  }
+}
+
+void GraphicsBackground::setImagePyramid (const ImagePyramid &imagePyramid)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsBackground::setImagePyramid levels=" << imagePyramid.numLevels ();
+
+  // Level zero of the pyramid has the same pixels, so the cached tiles stay valid
+  m_imagePyramid = imagePyramid;
+  m_image = imagePyramid.imageFull ();
+  update ();
+}
+
+QPixmap GraphicsBackground::tile (int level,
+                                  int column,
+                                  int row) const
+{
+  QString key = QString ("GraphicsBackground %1 %2 %3 %4")
+                .arg (m_tilesSerial)
+                .arg (level)
+                .arg (column)
+                .arg (row);
+
+  QPixmap pixmap;
+  if (!QPixmapCache::find (key, &pixmap)) {
+
+    // Tiles on the right and bottom edges are clipped to the image
+    QImage image = levelImage (level);
+    int x = column * TILE_SIZE;
+    int y = row * TILE_SIZE;
+    pixmap = QPixmap::fromImage (tileImage (image,
+                                            QRect (x,
+                                                   y,
+                                                   qMin (TILE_SIZE, image.width () - x),
+                                                   qMin (TILE_SIZE, image.height () - y))));
+
+    QPixmapCache::insert (key, pixmap);
+  }
+
+  return pixmap;
+}
+
+QImage GraphicsBackground::tileImage (const QImage &imageLevel,
+                                      const QRect &rectTile) const
+{
+  return imageLevel.copy (rectTile);
+}
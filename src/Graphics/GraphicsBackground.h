@@ -0,0 +1,66 @@
+#ifndef GRAPHICS_BACKGROUND_H
+#define GRAPHICS_BACKGROUND_H
+
+#include "ImagePyramid.h"
+#include <QGraphicsObject>
+#include <QImage>
+#include <QPixmap>
+
+/// Graphics item that draws a background image, which may be much larger than the screen, in tiles.
+///
+/// The levels come from the ImagePyramid of the Document, which holds the full resolution image and images that are
+/// each half the size of the previous one, so all background items and the settings dialogs share one pyramid. The
+/// pyramid is built in a worker thread and handed over with setImagePyramid, and until then only the full resolution
+/// image is painted. Painting picks the level whose resolution is closest above the zoom, and converts only the tiles of that level
+/// that are inside the exposed rectangle into pixmaps, which are kept in QPixmapCache. So a zoomed out view does not
+/// resample the whole image on every frame, and only the visible tiles are held as pixmaps.
+///
+/// Subclasses can change the tiles by overriding tileImage, and call invalidateTiles when they would change
+class GraphicsBackground : public QGraphicsObject
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor.
+  GraphicsBackground(const QImage &image);
+  virtual ~GraphicsBackground();
+
+  /// Bounding rectangle of the full resolution image.
+  virtual QRectF boundingRect () const;
+
+  /// Full resolution image, which is level zero.
+  const QImage &image () const;
+
+  /// Draw the tiles inside the exposed rectangle.
+  virtual void paint (QPainter *painter,
+                      const QStyleOptionGraphicsItem *option,
+                      QWidget *widget);
+
+  /// Paint from the levels of the pyramid, once it has been built. Its full resolution image replaces the one that
+  /// was passed to the constructor.
+  void setImagePyramid (const ImagePyramid &imagePyramid);
+
+protected:
+  /// Discard the cached tiles, so they are made again by tileImage the next time they are painted.
+  void invalidateTiles ();
+
+  /// Return the image of one tile, given the image of its level and the rectangle of the tile within that image.
+  /// The default is the unmodified part of the level image
+  virtual QImage tileImage (const QImage &imageLevel,
+                            const QRect &rectTile) const;
+
+private:
+  GraphicsBackground();
+
+  QImage levelImage (int level) const;
+  int levelForScale (double scale) const;
+  QPixmap tile (int level,
+                int column,
+                int row) const;
+
+  ImagePyramid m_imagePyramid; // Empty until setImagePyramid is called
+  QImage m_image; // Full resolution image, which is level zero
+  qint64 m_tilesSerial; // Part of the cache key of each tile, so invalidated tiles are never found again
+};
+
+#endif // GRAPHICS_BACKGROUND_H
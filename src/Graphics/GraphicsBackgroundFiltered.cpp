@@ -0,0 +1,75 @@
+#include "Filter.h"
+#include "GraphicsBackgroundFiltered.h"
+#include "Logger.h"
+
+GraphicsBackgroundFiltered::GraphicsBackgroundFiltered(const QImage &imageUnfiltered,
+                                                       FilterParameter filterParameter,
+                                                       double low,
+                                                       double high,
+                                                       const GridRemoval &gridRemoval) :
+  GraphicsBackground (imageUnfiltered),
+  m_filterParameter (filterParameter),
+  m_low (low),
+  m_high (high),
+  m_gridRemoval (gridRemoval)
+{
+  Filter filter;
+  m_rgbBackground = filter.marginColor (&imageUnfiltered);
+}
+
+QImage GraphicsBackgroundFiltered::imageFiltered () const
+{
+  if (m_imageFiltered.isNull ()) {
+
+    LOG4CPP_INFO_S ((*mainCat)) << "GraphicsBackgroundFiltered::imageFiltered";
+
+    m_imageFiltered = tileImage (image (),
+                                 image ().rect ());
+  }
+
+  return m_imageFiltered;
+}
+
+void GraphicsBackgroundFiltered::setFilter (FilterParameter filterParameter,
+                                            double low,
+                                            double high,
+                                            const GridRemoval &gridRemoval)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsBackgroundFiltered::setFilter";
+
+  m_filterParameter = filterParameter;
+  m_low = low;
+  m_high = high;
+  m_gridRemoval = gridRemoval;
+
+  m_imageFiltered = QImage ();
+  invalidateTiles ();
+}
+
+QImage GraphicsBackgroundFiltered::tileImage (const QImage &imageLevel,
+                                              const QRect &rectTile) const
+{
+  QImage imageTileUnfiltered = imageLevel.copy (rectTile);
+  QImage imageTileFiltered (rectTile.width (),
+                            rectTile.height (),
+                            QImage::Format_RGB32);
+
+  Filter filter;
+  filter.filterImage (imageTileUnfiltered,
+                      imageTileFiltered,
+                      m_filterParameter,
+                      m_low,
+                      m_high,
+                      m_rgbBackground);
+
+  // The mask has full resolution, so the tile rectangle is scaled up from its level
+  double scaleX = (double) image ().width () / imageLevel.width ();
+  double scaleY = (double) image ().height () / imageLevel.height ();
+  m_gridRemoval.applyMask (imageTileFiltered,
+                           QRectF (rectTile.x () * scaleX,
+                                   rectTile.y () * scaleY,
+                                   rectTile.width () * scaleX,
+                                   rectTile.height () * scaleY));
+
+  return imageTileFiltered;
+}
@@ -0,0 +1,52 @@
+#ifndef GRAPHICS_BACKGROUND_FILTERED_H
+#define GRAPHICS_BACKGROUND_FILTERED_H
+
+#include "FilterParameter.h"
+#include "GraphicsBackground.h"
+#include "GridRemoval.h"
+#include <QRgb>
+
+/// Background item that shows the filtered image, with the grid lines removed.
+///
+/// Nothing is filtered up front. Each tile is filtered from the same tile of the original image when it is first
+/// painted, and changing the filter settings only discards the tiles, so just the visible ones are filtered again.
+/// Zoomed out tiles are filtered from the lower resolution levels of the original image, which are the same levels that
+/// the unfiltered background shows
+class GraphicsBackgroundFiltered : public GraphicsBackground
+{
+public:
+  /// Single constructor.
+  GraphicsBackgroundFiltered(const QImage &imageUnfiltered,
+                             FilterParameter filterParameter,
+                             double low,
+                             double high,
+                             const GridRemoval &gridRemoval);
+
+  /// Return the full resolution filtered image, such as for segment extraction. It is made on the first call after
+  /// construction or setFilter.
+  QImage imageFiltered () const;
+
+  /// Apply new filter settings. The visible tiles are filtered again when they are painted.
+  void setFilter (FilterParameter filterParameter,
+                  double low,
+                  double high,
+                  const GridRemoval &gridRemoval);
+
+protected:
+  /// Filter one tile of the original image.
+  virtual QImage tileImage (const QImage &imageLevel,
+                            const QRect &rectTile) const;
+
+private:
+  GraphicsBackgroundFiltered();
+
+  FilterParameter m_filterParameter;
+  double m_low;
+  double m_high;
+  GridRemoval m_gridRemoval;
+  QRgb m_rgbBackground; // Margin color of the original image, which does not depend on the filter settings
+
+  mutable QImage m_imageFiltered; // Null until imageFiltered is called
+};
+
+#endif // GRAPHICS_BACKGROUND_FILTERED_H
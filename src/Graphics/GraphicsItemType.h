@@ -5,6 +5,7 @@
 enum GraphicsItemType {
   GRAPHICS_ITEM_TYPE_IMAGE,
   GRAPHICS_ITEM_TYPE_POINT,
+  GRAPHICS_ITEM_TYPE_POINTS_BATCH,
   GRAPHICS_ITEM_TYPE_SEGMENT
 };
 
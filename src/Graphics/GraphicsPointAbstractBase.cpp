@@ -1,9 +1,15 @@
 #include "GraphicsPointAbstractBase.h"
 
-GraphicsPointAbstractBase::GraphicsPointAbstractBase()
+GraphicsPointAbstractBase::GraphicsPointAbstractBase(PointIdentifier identifier) :
+  m_identifier (identifier)
 {
 }
 
 GraphicsPointAbstractBase::~GraphicsPointAbstractBase()
 {
 }
+
+PointIdentifier GraphicsPointAbstractBase::identifier () const
+{
+  return m_identifier;
+}
@@ -1,6 +1,7 @@
 #ifndef GRAPHICS_POINT_ABSTRACT_BASE_H
 #define GRAPHICS_POINT_ABSTRACT_BASE_H
 
+#include "PointIdentifier.h"
 #include <QPointF>
 #include <QString>
 
@@ -17,16 +18,25 @@
 ///    rows/columns disappearing
 /// This dual-line approach is better than using QGraphicsItem::ItemIgnoresTransformations to prevent horrible
 /// aliasing problems, since that approach involves complicated transformation matrix manipulations
+///
+/// The identifier is also kept as a member, so the item change notifications that keep the selected and moved sets
+/// of GraphicsScene up to date do not have to decode the data item
 class GraphicsPointAbstractBase
 {
 public:
   /// Single constructor.
-  GraphicsPointAbstractBase();
+  GraphicsPointAbstractBase(PointIdentifier identifier);
   virtual ~GraphicsPointAbstractBase();
 
+  /// Identifier of the Point that this item represents.
+  PointIdentifier identifier () const;
+
 private:
+  GraphicsPointAbstractBase();
+
   void removeOverrideCursor ();
 
+  PointIdentifier m_identifier;
 };
 
 #endif // GRAPHICS_POINT_ABSTRACT_BASE_H
@@ -1,25 +1,27 @@
 #include "DataKey.h"
 #include "GraphicsItemType.h"
 #include "GraphicsPointCircle.h"
+#include "GraphicsScene.h"
 #include "Logger.h"
+#include "Point.h"
 #include <QGraphicsEllipseItem>
 #include <QGraphicsScene>
 #include <QGraphicsSceneContextMenuEvent>
 #include <QPen>
 #include "QtToString.h"
 
-GraphicsPointCircle::GraphicsPointCircle(const QString &identifier,
+GraphicsPointCircle::GraphicsPointCircle(PointIdentifier identifier,
                                          const QPointF &posScreen,
                                          const QColor &color,
                                          unsigned int radius,
                                          double lineWidth) :
-  GraphicsPointAbstractBase (),
+  GraphicsPointAbstractBase (identifier),
   QGraphicsEllipseItem (QRect (posScreen.x () - radius,
                                posScreen.y () - radius,
                                2 * radius + 1,
                                2 * radius + 1))
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsPointCircle::GraphicsPointCircle identifier=" << identifier.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsPointCircle::GraphicsPointCircle identifier=" << Point::identifierToString (identifier).toLatin1 ().data ();
 
   const double ZERO_WIDTH = 0.0;
 
@@ -43,13 +45,25 @@ GraphicsPointCircle::GraphicsPointCircle(const QString &identifier,
 QVariant GraphicsPointCircle::itemChange(GraphicsItemChange change,
                                          const QVariant &value)
 {
+  // Items outside of a GraphicsScene, or not yet added to one, have nobody to notify
+  GraphicsScene *graphicsScene = dynamic_cast<GraphicsScene*> (scene ());
+
   if (change == QGraphicsItem::ItemPositionHasChanged) {
 
     LOG4CPP_DEBUG_S ((*mainCat)) << "GraphicsPointCircle::itemChange"
-                                 << " identifier=" << data (DATA_KEY_IDENTIFIER).toString().toLatin1().data()
+                                 << " identifier=" << Point::identifierToString (identifier ()).toLatin1().data()
                                  << " positionHasChanged";
 
-    setData (DATA_KEY_POSITION_HAS_CHANGED, QVariant (true));
+    if (graphicsScene != 0) {
+      graphicsScene->notifyPointMoved (identifier ());
+    }
+
+  } else if (change == QGraphicsItem::ItemSelectedHasChanged) {
+
+    if (graphicsScene != 0) {
+      graphicsScene->notifyPointSelected (identifier (),
+                                          value.toBool ());
+    }
   }
 
   return QGraphicsItem::itemChange(change,
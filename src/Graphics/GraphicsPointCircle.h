@@ -2,6 +2,7 @@
 #define GRAPHICS_POINT_CIRCLE_H
 
 #include "GraphicsPointAbstractBase.h"
+#include "PointIdentifier.h"
 #include <QGraphicsEllipseItem>
 #include <QPointF>
 
@@ -10,13 +11,14 @@ class GraphicsPointCircle : public GraphicsPointAbstractBase, public QGraphicsEl
 {
 public:
   /// Single constructor.
-  GraphicsPointCircle(const QString &identifier,
+  GraphicsPointCircle(PointIdentifier identifier,
                       const QPointF &posScreen,
                       const QColor &color,
                       unsigned int radius,
                       double lineWidth);
 
-  /// Intercept moves by dragging so moved items can be identified. This replaces unreliable hit tests.
+  /// Intercept moves by dragging so moved items can be identified, and selection changes, by notifying the
+  /// GraphicsScene. This replaces unreliable hit tests and scans of all items.
   QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
 private:
@@ -1,20 +1,22 @@
 #include "DataKey.h"
 #include "GraphicsItemType.h"
 #include "GraphicsPointPolygon.h"
+#include "GraphicsScene.h"
 #include "Logger.h"
+#include "Point.h"
 #include <QGraphicsSceneContextMenuEvent>
 #include <QPen>
 #include "QtToString.h"
 
-GraphicsPointPolygon::GraphicsPointPolygon(const QString &identifier,
+GraphicsPointPolygon::GraphicsPointPolygon(PointIdentifier identifier,
                                            const QPointF &posScreen,
                                            const QColor &color,
                                            const QPolygonF &polygon,
                                            double lineWidth) :
-  GraphicsPointAbstractBase (),
+  GraphicsPointAbstractBase (identifier),
   QGraphicsPolygonItem (polygon)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsPointPolygon::GraphicsPointPolygon identifier=" << identifier.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsPointPolygon::GraphicsPointPolygon identifier=" << Point::identifierToString (identifier).toLatin1 ().data ();
 
   const double ZERO_WIDTH = 0.0;
 
@@ -38,13 +40,25 @@ GraphicsPointPolygon::GraphicsPointPolygon(const QString &identifier,
 QVariant GraphicsPointPolygon::itemChange(GraphicsItemChange change,
                                           const QVariant &value)
 {
+  // Items outside of a GraphicsScene, or not yet added to one, have nobody to notify
+  GraphicsScene *graphicsScene = dynamic_cast<GraphicsScene*> (scene ());
+
   if (change == QGraphicsItem::ItemPositionHasChanged) {
 
     LOG4CPP_DEBUG_S ((*mainCat)) << "GraphicsPointPolygon::itemChange"
-                                 << " identifier=" << data (DATA_KEY_IDENTIFIER).toString().toLatin1().data()
+                                 << " identifier=" << Point::identifierToString (identifier ()).toLatin1().data()
                                  << " positionHasChanged";
 
-    setData (DATA_KEY_POSITION_HAS_CHANGED, QVariant (true));
+    if (graphicsScene != 0) {
+      graphicsScene->notifyPointMoved (identifier ());
+    }
+
+  } else if (change == QGraphicsItem::ItemSelectedHasChanged) {
+
+    if (graphicsScene != 0) {
+      graphicsScene->notifyPointSelected (identifier (),
+                                          value.toBool ());
+    }
   }
 
   return QGraphicsItem::itemChange(change,
@@ -2,6 +2,7 @@
 #define GRAPHICS_POINT_POLYGON_H
 
 #include "GraphicsPointAbstractBase.h"
+#include "PointIdentifier.h"
 #include <QGraphicsPolygonItem>
 #include <QPolygonF>
 
@@ -10,13 +11,14 @@ class GraphicsPointPolygon : public GraphicsPointAbstractBase, public QGraphicsP
 {
 public:
   /// Single constructor.
-  GraphicsPointPolygon(const QString &identifier,
+  GraphicsPointPolygon(PointIdentifier identifier,
                        const QPointF &posScreen,
                        const QColor &color,
                        const QPolygonF &polygon,
                        double lineWidth);
 
-  /// Intercept moves by dragging so moved items can be identified. This replaces unreliable hit tests.
+  /// Intercept moves by dragging so moved items can be identified, and selection changes, by notifying the
+  /// GraphicsScene. This replaces unreliable hit tests and scans of all items.
   QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
 private:
@@ -0,0 +1,382 @@
+#include "DataKey.h"
+#include "EnumsToQt.h"
+#include "GraphicsItemType.h"
+#include "GraphicsPointsBatch.h"
+#include <qmath.h>
+#include <QPainter>
+#include <QPen>
+#include <QPixmapCache>
+#include <QPolygonF>
+#include <QStyleOptionGraphicsItem>
+#include <QTransform>
+
+const double CELL_SIZE = 64; // Width and height of each grid cell, in scene pixels
+const int GLYPH_SCALE_STEPS = 16; // Zoom levels are rounded to this fraction, so nearby levels share a glyph
+const double MARKER_GLYPH_PIXELS = 4; // Below this glyph width in pixels the simple markers are drawn
+const double MARKER_WIDTH = 2; // Width of a simple marker in pixels
+
+GraphicsPointsBatch::GraphicsPointsBatch(const QString &curveName,
+                                         const PointStyle &pointStyle) :
+  m_curveName (curveName),
+  m_pointStyle (pointStyle)
+{
+  // Exposed rectangle is needed for culling. The promoted items, not this item, receive the mouse presses
+  setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINTS_BATCH);
+  setFlag (QGraphicsItem::ItemUsesExtendedStyleOption);
+  setAcceptedMouseButtons (Qt::NoButton);
+}
+
+void GraphicsPointsBatch::addPoint (PointIdentifier identifier,
+                                    const QPointF &posScreen)
+{
+  Q_ASSERT (!m_positions.contains (identifier));
+
+  if (m_positions.isEmpty ()) {
+
+    prepareGeometryChange ();
+    m_boundsPositions = QRectF (posScreen, QSizeF (0, 0));
+
+  } else if ((posScreen.x () < m_boundsPositions.left ()) ||
+             (posScreen.x () > m_boundsPositions.right ()) ||
+             (posScreen.y () < m_boundsPositions.top ()) ||
+             (posScreen.y () > m_boundsPositions.bottom ())) {
+
+    prepareGeometryChange ();
+    m_boundsPositions.setLeft (qMin (m_boundsPositions.left (), posScreen.x ()));
+    m_boundsPositions.setRight (qMax (m_boundsPositions.right (), posScreen.x ()));
+    m_boundsPositions.setTop (qMin (m_boundsPositions.top (), posScreen.y ()));
+    m_boundsPositions.setBottom (qMax (m_boundsPositions.bottom (), posScreen.y ()));
+  }
+
+  m_positions [identifier] = posScreen;
+  addToCell (identifier,
+             posScreen);
+
+  double extent = glyphExtent ();
+  update (QRectF (posScreen.x () - extent,
+                  posScreen.y () - extent,
+                  2 * extent,
+                  2 * extent));
+}
+
+void GraphicsPointsBatch::addToCell (PointIdentifier identifier,
+                                     const QPointF &posScreen)
+{
+  m_cells [cellKey (cellColumn (posScreen.x ()),
+                    cellRow (posScreen.y ()))] << identifier;
+}
+
+QRectF GraphicsPointsBatch::boundingRect () const
+{
+  if (m_positions.isEmpty ()) {
+    return QRectF ();
+  }
+
+  double extent = glyphExtent ();
+  return m_boundsPositions.adjusted (-extent,
+                                     -extent,
+                                     extent,
+                                     extent);
+}
+
+quint64 GraphicsPointsBatch::cellKey (int column,
+                                      int row) const
+{
+  return (((quint64) (quint32) column) << 32) | ((quint64) (quint32) row);
+}
+
+int GraphicsPointsBatch::cellColumn (double x) const
+{
+  return qFloor (x / CELL_SIZE);
+}
+
+int GraphicsPointsBatch::cellRow (double y) const
+{
+  return qFloor (y / CELL_SIZE);
+}
+
+bool GraphicsPointsBatch::containsPoint (PointIdentifier identifier) const
+{
+  return m_positions.contains (identifier);
+}
+
+QString GraphicsPointsBatch::curveName () const
+{
+  return m_curveName;
+}
+
+QPixmap GraphicsPointsBatch::glyph (double scale) const
+{
+  double scaleRounded = qMax (1, qRound (scale * GLYPH_SCALE_STEPS)) / (double) GLYPH_SCALE_STEPS;
+
+  QString key = QString ("GraphicsPointsBatch %1 %2 %3 %4 %5")
+                .arg (m_pointStyle.shape ())
+                .arg (m_pointStyle.radius ())
+                .arg (m_pointStyle.lineWidth ())
+                .arg (m_pointStyle.paletteColor ())
+                .arg (scaleRounded);
+
+  QPixmap pixmap;
+  if (!QPixmapCache::find (key, &pixmap)) {
+
+    // Render the glyph the same way GraphicsPointPolygon draws a Point, including its zero width shadow
+    int size = qCeil (2 * glyphExtent () * scaleRounded) + 2;
+
+    pixmap = QPixmap (size, size);
+    pixmap.fill (Qt::transparent);
+
+    QColor color = ColorPaletteToQColor (m_pointStyle.paletteColor ());
+    const double ZERO_WIDTH = 0.0;
+
+    QPainter painter (&pixmap);
+    painter.translate (size / 2.0,
+                       size / 2.0);
+    painter.scale (scaleRounded,
+                   scaleRounded);
+
+    QPen pens [2] = {QPen (QBrush (color), m_pointStyle.lineWidth ()),
+                     QPen (QBrush (color), ZERO_WIDTH)};
+    for (int i = 0; i < 2; i++) {
+
+      painter.setPen (pens [i]);
+      if (m_pointStyle.isCircle ()) {
+        painter.drawEllipse (QPointF (0, 0),
+                             m_pointStyle.radius (),
+                             m_pointStyle.radius ());
+      } else {
+        painter.drawPolygon (m_pointStyle.polygon ());
+      }
+    }
+
+    painter.end ();
+
+    QPixmapCache::insert (key, pixmap);
+  }
+
+  return pixmap;
+}
+
+double GraphicsPointsBatch::glyphExtent () const
+{
+  // Half of the glyph width, in scene pixels
+  return m_pointStyle.radius () + m_pointStyle.lineWidth () / 2.0;
+}
+
+PointIdentifierList GraphicsPointsBatch::identifiers () const
+{
+  return m_positions.keys ();
+}
+
+void GraphicsPointsBatch::movePoint (PointIdentifier identifier,
+                                     const QPointF &posScreen)
+{
+  // Removing the Point also forgets that it is promoted, so its promoted item would be drawn over the glyph
+  bool isPromoted = m_promoted.contains (identifier);
+
+  removePoint (identifier);
+  addPoint (identifier,
+            posScreen);
+
+  if (isPromoted) {
+    m_promoted [identifier] = true;
+  }
+}
+
+void GraphicsPointsBatch::paint (QPainter *painter,
+                                 const QStyleOptionGraphicsItem *option,
+                                 QWidget * /* widget */)
+{
+  double extent = glyphExtent ();
+  QRectF exposed = option->exposedRect.adjusted (-extent,
+                                                 -extent,
+                                                 extent,
+                                                 extent);
+
+  QTransform transform = painter->worldTransform ();
+  double scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform (transform);
+
+  // Collect the device positions of the Points in the exposed rectangle, from its cells or, if there are more cells
+  // than Points, from all of the Points
+  QPolygonF positionsDevice;
+
+  int columnMin = cellColumn (exposed.left ());
+  int columnMax = cellColumn (exposed.right ());
+  int rowMin = cellRow (exposed.top ());
+  int rowMax = cellRow (exposed.bottom ());
+  qint64 numCells = ((qint64) (columnMax - columnMin + 1)) * (rowMax - rowMin + 1);
+
+  if (numCells > m_cells.count ()) {
+
+    QHash<PointIdentifier, QPointF>::const_iterator itr;
+    for (itr = m_positions.begin (); itr != m_positions.end (); itr++) {
+      if (exposed.contains (itr.value ()) && !m_promoted.contains (itr.key ())) {
+        positionsDevice << transform.map (itr.value ());
+      }
+    }
+
+  } else {
+
+    for (int column = columnMin; column <= columnMax; column++) {
+      for (int row = rowMin; row <= rowMax; row++) {
+
+        QHash<quint64, PointIdentifierList >::const_iterator itrCell = m_cells.constFind (cellKey (column, row));
+        if (itrCell != m_cells.constEnd ()) {
+
+          PointIdentifierList::const_iterator itr;
+          for (itr = itrCell.value ().begin (); itr != itrCell.value ().end (); itr++) {
+            if (!m_promoted.contains (*itr)) {
+              positionsDevice << transform.map (m_positions.value (*itr));
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (positionsDevice.isEmpty ()) {
+    return;
+  }
+
+  // Draw in device pixels, so the glyphs are blitted without scaling
+  painter->save ();
+  painter->setWorldTransform (QTransform ());
+
+  if (2 * extent * scale < MARKER_GLYPH_PIXELS) {
+
+    // Zoomed out so far that the glyph shapes could not be told apart
+    QPen pen (ColorPaletteToQColor (m_pointStyle.paletteColor ()));
+    pen.setWidthF (MARKER_WIDTH);
+    pen.setCosmetic (true);
+    painter->setPen (pen);
+    painter->drawPoints (positionsDevice);
+
+  } else {
+
+    QPixmap pixmap = glyph (scale);
+    QPointF offset (pixmap.width () / 2.0,
+                    pixmap.height () / 2.0);
+
+    QPolygonF::const_iterator itr;
+    for (itr = positionsDevice.begin (); itr != positionsDevice.end (); itr++) {
+      painter->drawPixmap (*itr - offset,
+                           pixmap);
+    }
+  }
+
+  painter->restore ();
+}
+
+PointIdentifier GraphicsPointsBatch::pointIdentifierAt (const QPointF &posScreen) const
+{
+  double extent = glyphExtent ();
+
+  PointIdentifier identifierClosest = POINT_IDENTIFIER_INVALID;
+  double distanceSquaredClosest = 0;
+
+  QRectF rect (posScreen.x () - extent,
+               posScreen.y () - extent,
+               2 * extent,
+               2 * extent);
+  PointIdentifierList candidates = pointIdentifiersInRect (rect);
+  PointIdentifierList::const_iterator itr;
+  for (itr = candidates.begin (); itr != candidates.end (); itr++) {
+
+    QPointF delta = m_positions.value (*itr) - posScreen;
+    double distanceSquared = delta.x () * delta.x () + delta.y () * delta.y ();
+    if ((identifierClosest == POINT_IDENTIFIER_INVALID) || (distanceSquared < distanceSquaredClosest)) {
+
+      identifierClosest = *itr;
+      distanceSquaredClosest = distanceSquared;
+    }
+  }
+
+  return identifierClosest;
+}
+
+PointIdentifierList GraphicsPointsBatch::pointIdentifiersInRect (const QRectF &rect) const
+{
+  PointIdentifierList identifiers;
+
+  for (int column = cellColumn (rect.left ()); column <= cellColumn (rect.right ()); column++) {
+    for (int row = cellRow (rect.top ()); row <= cellRow (rect.bottom ()); row++) {
+
+      QHash<quint64, PointIdentifierList >::const_iterator itrCell = m_cells.constFind (cellKey (column, row));
+      if (itrCell != m_cells.constEnd ()) {
+
+        PointIdentifierList::const_iterator itr;
+        for (itr = itrCell.value ().begin (); itr != itrCell.value ().end (); itr++) {
+          if (rect.contains (m_positions.value (*itr)) && !m_promoted.contains (*itr)) {
+            identifiers << *itr;
+          }
+        }
+      }
+    }
+  }
+
+  return identifiers;
+}
+
+PointStyle GraphicsPointsBatch::pointStyle () const
+{
+  return m_pointStyle;
+}
+
+QPointF GraphicsPointsBatch::positionScreen (PointIdentifier identifier) const
+{
+  return m_positions.value (identifier);
+}
+
+void GraphicsPointsBatch::removeFromCell (PointIdentifier identifier,
+                                          const QPointF &posScreen)
+{
+  quint64 key = cellKey (cellColumn (posScreen.x ()),
+                         cellRow (posScreen.y ()));
+
+  PointIdentifierList &cell = m_cells [key];
+  cell.removeOne (identifier);
+  if (cell.isEmpty ()) {
+    m_cells.remove (key);
+  }
+}
+
+void GraphicsPointsBatch::removePoint (PointIdentifier identifier)
+{
+  if (m_positions.contains (identifier)) {
+
+    QPointF posScreen = m_positions.take (identifier);
+    removeFromCell (identifier,
+                    posScreen);
+    m_promoted.remove (identifier);
+
+    double extent = glyphExtent ();
+    update (QRectF (posScreen.x () - extent,
+                    posScreen.y () - extent,
+                    2 * extent,
+                    2 * extent));
+  }
+}
+
+void GraphicsPointsBatch::setPointPromoted (PointIdentifier identifier,
+                                            bool isPromoted)
+{
+  if (isPromoted) {
+    m_promoted [identifier] = true;
+  } else {
+    m_promoted.remove (identifier);
+  }
+
+  QPointF posScreen = m_positions.value (identifier);
+  double extent = glyphExtent ();
+  update (QRectF (posScreen.x () - extent,
+                  posScreen.y () - extent,
+                  2 * extent,
+                  2 * extent));
+}
+
+void GraphicsPointsBatch::setPointStyle (const PointStyle &pointStyle)
+{
+  // The glyph extent, and therefore the bounding rectangle, depends on the style
+  prepareGeometryChange ();
+  m_pointStyle = pointStyle;
+  update ();
+}
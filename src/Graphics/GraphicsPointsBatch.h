@@ -0,0 +1,106 @@
+#ifndef GRAPHICS_POINTS_BATCH_H
+#define GRAPHICS_POINTS_BATCH_H
+
+#include "PointIdentifier.h"
+#include "PointStyle.h"
+#include <QGraphicsItem>
+#include <QHash>
+#include <QPixmap>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+
+/// Graphics item that draws all of the Points of one Curve in a single paint call, so the scene does not hold one
+/// item, polygon, pen and tooltip per Point.
+///
+/// Points are kept in a grid of cells so painting only visits the cells inside the exposed rectangle, and so hit
+/// tests are cheap. Each Point is drawn by blitting a glyph pixmap that is rendered once per PointStyle and zoom
+/// level and kept in QPixmapCache. When zoomed out so far that the glyphs would be a few pixels wide, each Point is
+/// drawn as a simple marker instead.
+///
+/// Points that need to be selected or dragged are promoted by GraphicsScene to their own GraphicsPointPolygon item.
+/// This item skips promoted Points, so they are not drawn twice
+class GraphicsPointsBatch : public QGraphicsItem
+{
+public:
+  /// Single constructor.
+  GraphicsPointsBatch(const QString &curveName,
+                      const PointStyle &pointStyle);
+
+  /// Add a Point.
+  void addPoint (PointIdentifier identifier,
+                 const QPointF &posScreen);
+
+  /// Bounding rectangle of all Points, including the extent of their glyphs.
+  virtual QRectF boundingRect () const;
+
+  /// True if the Point belongs to this item.
+  bool containsPoint (PointIdentifier identifier) const;
+
+  /// Name of the Curve whose Points are drawn.
+  QString curveName () const;
+
+  /// Identifiers of all the Points.
+  PointIdentifierList identifiers () const;
+
+  /// Move a Point.
+  void movePoint (PointIdentifier identifier,
+                  const QPointF &posScreen);
+
+  /// Draw the Points inside the exposed rectangle, except the promoted Points.
+  virtual void paint (QPainter *painter,
+                      const QStyleOptionGraphicsItem *option,
+                      QWidget *widget);
+
+  /// Return the Point whose glyph covers the position, or POINT_IDENTIFIER_INVALID if there is none. Of several
+  /// candidates the closest is returned.
+  PointIdentifier pointIdentifierAt (const QPointF &posScreen) const;
+
+  /// Return the Points whose positions are inside the rectangle.
+  PointIdentifierList pointIdentifiersInRect (const QRectF &rect) const;
+
+  /// Return the position of a Point.
+  QPointF positionScreen (PointIdentifier identifier) const;
+
+  /// Point style of the glyphs.
+  PointStyle pointStyle () const;
+
+  /// Remove a Point.
+  void removePoint (PointIdentifier identifier);
+
+  /// Mark a Point as promoted to its own item, or no longer promoted.
+  void setPointPromoted (PointIdentifier identifier,
+                         bool isPromoted);
+
+  /// Change the point style of the glyphs.
+  void setPointStyle (const PointStyle &pointStyle);
+
+private:
+  GraphicsPointsBatch();
+
+  void addToCell (PointIdentifier identifier,
+                  const QPointF &posScreen);
+  quint64 cellKey (int column,
+                   int row) const;
+  int cellColumn (double x) const;
+  int cellRow (double y) const;
+  QPixmap glyph (double scale) const;
+  double glyphExtent () const;
+  void removeFromCell (PointIdentifier identifier,
+                       const QPointF &posScreen);
+
+  QString m_curveName;
+  PointStyle m_pointStyle;
+
+  // Positions of all Points, and the same Points grouped by grid cell
+  QHash<PointIdentifier, QPointF> m_positions;
+  QHash<quint64, PointIdentifierList > m_cells;
+
+  // Points that currently have their own item
+  QHash<PointIdentifier, bool> m_promoted;
+
+  // Bounding rectangle of the positions. It only grows, which is harmless since painting is culled by cell
+  QRectF m_boundsPositions;
+};
+
+#endif // GRAPHICS_POINTS_BATCH_H
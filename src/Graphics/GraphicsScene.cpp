@@ -7,34 +7,134 @@
 #include "GraphicsItemType.h"
 #include "GraphicsPointAbstractBase.h"
 #include "GraphicsPointPolygon.h"
+#include "GraphicsPointsBatch.h"
 #include "GraphicsScene.h"
 #include "Logger.h"
 #include "MainWindow.h"
 #include "PointStyle.h"
 #include <QApplication>
 #include <QGraphicsItem>
+#include <QGraphicsSceneHelpEvent>
+#include <QGraphicsSceneMouseEvent>
+#include <QToolTip>
 #include "QtToString.h"
 
+const double Z_VALUE_PROMOTED_POINT = 1; // Promoted items are drawn above the batch items
+
 GraphicsScene::GraphicsScene(MainWindow *mainWindow) :
-  QGraphicsScene(mainWindow)
+  QGraphicsScene(mainWindow),
+  m_showPoints (true),
+  m_showPointsAll (true),
+  m_pointsHaveCursor (false)
 {
 }
 
-QGraphicsItem *GraphicsScene::addPoint (const QString &identifier,
-                                        const PointStyle &pointStyle,
-                                        const QPointF &posScreen)
+void GraphicsScene::addPoint (PointIdentifier identifier,
+                              const PointStyle &pointStyle,
+                              const QPointF &posScreen)
 {
-  GraphicsPointPolygon *item = new GraphicsPointPolygon (identifier,
-                                                         posScreen,
-                                                         ColorPaletteToQColor (pointStyle.paletteColor ()),
-                                                         pointStyle.polygon (),
-                                                         pointStyle.lineWidth());
-  addItem (item);
+  quint64 curveIndex = Point::curveIndexFromPointIdentifier (identifier);
 
-  item->setToolTip (identifier);
-  item->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
+  GraphicsPointsBatch *batch = m_curveIndexToBatch.value (curveIndex);
+  if (batch == 0) {
+
+    const QString &curveName = Point::curveNameFromPointIdentifier (identifier);
+    batch = new GraphicsPointsBatch (curveName,
+                                     pointStyle);
+    addItem (batch);
+    batch->setVisible (curveIsShown (curveName));
+
+    m_curveIndexToBatch [curveIndex] = batch;
+
+  } else {
+
+    // Curve properties may have changed since the batch was created
+    PointStyle pointStyleBatch = batch->pointStyle ();
+    if ((pointStyleBatch.shape () != pointStyle.shape ()) ||
+        (pointStyleBatch.radius () != pointStyle.radius ()) ||
+        (pointStyleBatch.lineWidth () != pointStyle.lineWidth ()) ||
+        (pointStyleBatch.paletteColor () != pointStyle.paletteColor ())) {
+
+      batch->setPointStyle (pointStyle);
+    }
+  }
+
+  batch->addPoint (identifier,
+                   posScreen);
+}
+
+PointIdentifier GraphicsScene::batchedPointIdentifierAt (const QPointF &posScreen) const
+{
+  QHash<quint64, GraphicsPointsBatch*>::const_iterator itr;
+  for (itr = m_curveIndexToBatch.begin (); itr != m_curveIndexToBatch.end (); itr++) {
+
+    GraphicsPointsBatch *batch = itr.value ();
+    if (batch->isVisible ()) {
+
+      PointIdentifier identifier = batch->pointIdentifierAt (posScreen);
+      if (identifier != POINT_IDENTIFIER_INVALID) {
+        return identifier;
+      }
+    }
+  }
+
+  return POINT_IDENTIFIER_INVALID;
+}
+
+bool GraphicsScene::containsPoint (PointIdentifier identifier) const
+{
+  GraphicsPointsBatch *batch = m_curveIndexToBatch.value (Point::curveIndexFromPointIdentifier (identifier));
+
+  return (batch != 0) && batch->containsPoint (identifier);
+}
+
+bool GraphicsScene::curveIsShown (const QString &curveName) const
+{
+  return m_showPoints && (m_showPointsAll || (curveName == m_showPointsCurveName));
+}
+
+void GraphicsScene::demotePoint (PointIdentifier identifier)
+{
+  // The item is taken out of the sets first, so the notifications it may send while being removed are ignored
+  QGraphicsItem *item = m_pointIdentifierToGraphicsItem.take (identifier);
+  if (item != 0) {
+
+    quint64 curveIndex = Point::curveIndexFromPointIdentifier (identifier);
+    m_curveIndexToGraphicsItems [curveIndex].remove (identifier);
+    m_pointIdentifiersSelected.remove (identifier);
+    m_pointIdentifiersMoved.remove (identifier);
+
+    // The item may have been dragged, so its position is copied back into the batch
+    GraphicsPointsBatch *batch = m_curveIndexToBatch.value (curveIndex);
+    if ((batch != 0) && batch->containsPoint (identifier)) {
+
+      if (batch->positionScreen (identifier) != item->pos ()) {
+        batch->movePoint (identifier,
+                          item->pos ());
+      }
+      batch->setPointPromoted (identifier,
+                               false);
+    }
 
-  return item;
+    removeItem (item);
+    delete item;
+  }
+}
+
+void GraphicsScene::demoteUnselectedPoints ()
+{
+  PointIdentifierList unselected;
+  PointIdentifierToGraphicsItem::const_iterator itr;
+  for (itr = m_pointIdentifierToGraphicsItem.begin (); itr != m_pointIdentifierToGraphicsItem.end (); itr++) {
+    if (!m_pointIdentifiersSelected.contains (itr.key ())) {
+      unselected << itr.key ();
+    }
+  }
+
+  PointIdentifierList::const_iterator itrU;
+  for (itrU = unselected.begin (); itrU != unselected.end (); itrU++) {
+    demotePoint (*itrU);
+  }
 }
 
 QString GraphicsScene::dumpCursors () const
@@ -51,7 +151,25 @@ QString GraphicsScene::dumpCursors () const
   return dump;
 }
 
-const QGraphicsPixmapItem *GraphicsScene::image () const
+void GraphicsScene::helpEvent (QGraphicsSceneHelpEvent *event)
+{
+  // Promoted items have their own tooltips, but batched Points are only found by position
+  PointIdentifier identifier = batchedPointIdentifierAt (event->scenePos ());
+  if (identifier != POINT_IDENTIFIER_INVALID) {
+
+    QToolTip::showText (event->screenPos (),
+                        Point::identifierToString (identifier),
+                        event->widget ());
+    event->setAccepted (true);
+
+  } else {
+
+    QGraphicsScene::helpEvent (event);
+
+  }
+}
+
+const QGraphicsItem *GraphicsScene::image () const
 {
   QList<QGraphicsItem*> items = QGraphicsScene::items();
   QList<QGraphicsItem*>::iterator itr;
@@ -60,7 +178,7 @@ const QGraphicsPixmapItem *GraphicsScene::image () const
     QGraphicsItem* item = *itr;
     if (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_IMAGE) {
 
-      return (QGraphicsPixmapItem *) item;
+      return item;
     }
   }
 
@@ -68,159 +186,271 @@ const QGraphicsPixmapItem *GraphicsScene::image () const
   return 0;
 }
 
-PointIdentifierToGraphicsItem GraphicsScene::mapPointIdentifierToGraphicsItem ()
+PointIdentifierToGraphicsItem GraphicsScene::mapPointIdentifierToGraphicsItem () const
 {
-  PointIdentifierToGraphicsItem map;
+  return m_pointIdentifierToGraphicsItem;
+}
 
-  QList<QGraphicsItem*> items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::iterator itr;
-  for (itr = items.begin(); itr != items.end(); itr++) {
+void GraphicsScene::mousePressEvent (QGraphicsSceneMouseEvent *event)
+{
+  demoteUnselectedPoints ();
 
-    QGraphicsItem* item = *itr;
+  // Promote before the press is handled, so the new item receives it and can be selected and dragged right away
+  PointIdentifier identifier = batchedPointIdentifierAt (event->scenePos ());
+  if (identifier != POINT_IDENTIFIER_INVALID) {
+    promotePoint (identifier);
+  }
 
-    // Skip the image and only consider the Points
-    bool isPoint = (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT);
-    if (isPoint) {
+  QGraphicsScene::mousePressEvent (event);
+}
 
-      QString identifier = item->data (DATA_KEY_IDENTIFIER).toString ();
+void GraphicsScene::movePoint (PointIdentifier identifier,
+                               const QPointF &posScreen)
+{
+  // After a drag the promoted item is already in place, but the batch is not, so each is checked separately
+  GraphicsPointsBatch *batch = m_curveIndexToBatch.value (Point::curveIndexFromPointIdentifier (identifier));
+  if ((batch != 0) &&
+      batch->containsPoint (identifier) &&
+      (batch->positionScreen (identifier) != posScreen)) {
+
+    batch->movePoint (identifier,
+                      posScreen);
+  }
 
-      // Mark item as Not Wanted
-      item->setData (DATA_KEY_WANTED, false);
+  QGraphicsItem *item = m_pointIdentifierToGraphicsItem.value (identifier);
+  if ((item != 0) && (item->pos () != posScreen)) {
+    item->setPos (posScreen);
+  }
+}
 
-      map [identifier] = item;
+void GraphicsScene::notifyPointMoved (PointIdentifier identifier)
+{
+  // Items that are not indexed, such as those still being added, are ignored
+  if (m_pointIdentifierToGraphicsItem.contains (identifier)) {
+    m_pointIdentifiersMoved [identifier] = true;
+  }
+}
 
-    }
+void GraphicsScene::notifyPointSelected (PointIdentifier identifier,
+                                         bool isSelected)
+{
+  if (!isSelected) {
+    m_pointIdentifiersSelected.remove (identifier);
+  } else if (m_pointIdentifierToGraphicsItem.contains (identifier)) {
+    m_pointIdentifiersSelected [identifier] = true;
   }
+}
+
+PointIdentifierList GraphicsScene::positionHasChangedPointIdentifiers () const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::positionHasChangedPointIdentifiers"
+                              << " moved=" << m_pointIdentifiersMoved.count ();
 
-  return map;
+  return m_pointIdentifiersMoved.keys ();
 }
 
-QStringList GraphicsScene::positionHasChangedPointIdentifiers () const
+void GraphicsScene::promotePoint (PointIdentifier identifier)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::positionHasChangedPointIdentifiers";
+  if (m_pointIdentifierToGraphicsItem.contains (identifier)) {
+    return;
+  }
 
-  QStringList movedIds;
+  quint64 curveIndex = Point::curveIndexFromPointIdentifier (identifier);
+  GraphicsPointsBatch *batch = m_curveIndexToBatch.value (curveIndex);
+  if ((batch == 0) || !batch->containsPoint (identifier)) {
+    return;
+  }
 
-  const QList<QGraphicsItem*> &items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::const_iterator itr;
-  for (itr = items.begin(); itr != items.end(); itr++) {
+  PointStyle pointStyle = batch->pointStyle ();
+  GraphicsPointPolygon *item = new GraphicsPointPolygon (identifier,
+                                                         batch->positionScreen (identifier),
+                                                         ColorPaletteToQColor (pointStyle.paletteColor ()),
+                                                         pointStyle.polygon (),
+                                                         pointStyle.lineWidth());
+  addItem (item);
 
-    const QGraphicsItem *item = *itr;
+  item->setToolTip (Point::identifierToString (identifier));
+  item->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_POINT);
+  item->setZValue (Z_VALUE_PROMOTED_POINT);
 
-    // Skip the image and only keep the Points
-    bool isPoint = (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT);
-    if (isPoint) {
+  item->setVisible (batch->isVisible ());
+  if (m_pointsHaveCursor) {
+    item->setCursor (m_pointsCursor);
+  }
 
-      QString identifier = item->data (DATA_KEY_IDENTIFIER).toString ();
-      bool positionHasChanged = item->data (DATA_KEY_POSITION_HAS_CHANGED).toBool ();
+  m_pointIdentifierToGraphicsItem [identifier] = item;
+  m_curveIndexToGraphicsItems [curveIndex] [identifier] = item;
 
-      LOG4CPP_DEBUG_S ((*mainCat)) << "GraphicsScene::positionHasChangedPointIdentifiers"
-                                   << " identifier=" << identifier.toLatin1().data()
-                                   << " positionHasChanged=" << (positionHasChanged ? "yes" : "no");
+  batch->setPointPromoted (identifier,
+                           true);
+}
 
-      if (isPoint && positionHasChanged) {
+void GraphicsScene::promotePointsInRect (const QRectF &rect)
+{
+  QHash<quint64, GraphicsPointsBatch*>::const_iterator itr;
+  for (itr = m_curveIndexToBatch.begin (); itr != m_curveIndexToBatch.end (); itr++) {
 
-        // Add Point to the list
-        movedIds << item->data(DATA_KEY_IDENTIFIER).toString ();
+    GraphicsPointsBatch *batch = itr.value ();
+    if (batch->isVisible ()) {
 
+      PointIdentifierList identifiers = batch->pointIdentifiersInRect (rect);
+      PointIdentifierList::const_iterator itrP;
+      for (itrP = identifiers.begin (); itrP != identifiers.end (); itrP++) {
+        promotePoint (*itrP);
       }
     }
   }
-
-  return  movedIds;
 }
-QStringList GraphicsScene::selectedPointIdentifiers () const
+
+void GraphicsScene::removePoint (PointIdentifier identifier)
 {
-  QStringList selectedIds;
+  demotePoint (identifier);
 
-  const QList<QGraphicsItem*> &items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::const_iterator itr;
-  for (itr = items.begin(); itr != items.end(); itr++) {
+  GraphicsPointsBatch *batch = m_curveIndexToBatch.value (Point::curveIndexFromPointIdentifier (identifier));
+  if (batch != 0) {
+    batch->removePoint (identifier);
+  }
+}
+
+void GraphicsScene::resetPositionHasChanged ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::resetPositionHasChanged";
 
-    const QGraphicsItem* item = *itr;
+  m_pointIdentifiersMoved.clear ();
+}
 
-    // Skip the image and only keep the Points
-    bool isPoint = (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT);
-    bool isSelected = item->isSelected ();
-    if (isPoint && isSelected) {
+PointIdentifierList GraphicsScene::selectedPointIdentifiers () const
+{
+  return m_pointIdentifiersSelected.keys ();
+}
 
-      // Add Point to the list
-      selectedIds << item->data(DATA_KEY_IDENTIFIER).toString ();
+void GraphicsScene::setCursorForPoints (const QCursor &cursor)
+{
+  m_pointsHaveCursor = true;
+  m_pointsCursor = cursor;
 
-    }
+  PointIdentifierToGraphicsItem::const_iterator itr;
+  for (itr = m_pointIdentifierToGraphicsItem.begin (); itr != m_pointIdentifierToGraphicsItem.end (); itr++) {
+    itr.value ()->setCursor (cursor);
   }
-
-  return  selectedIds;
 }
 
 void GraphicsScene::showPoints (bool show,
                                 bool showAll,
                                 const QString &curveNameWanted)
 {
-  const QList<QGraphicsItem*> &items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::const_iterator itr;
-  for (itr = items.begin(); itr != items.end(); itr++) {
+  m_showPoints = show;
+  m_showPointsAll = showAll;
+  m_showPointsCurveName = curveNameWanted;
 
-    QGraphicsItem* item = *itr;
+  QHash<quint64, GraphicsPointsBatch*>::const_iterator itrC;
+  for (itrC = m_curveIndexToBatch.begin (); itrC != m_curveIndexToBatch.end (); itrC++) {
 
-    // Skip the image and only process the Points
-    bool isPoint = (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT);
-    if (isPoint) {
+    // Skip the Curves whose visibility does not change. The batch is visible exactly when its Curve was shown
+    GraphicsPointsBatch *batch = itrC.value ();
+    bool showThisCurve = curveIsShown (batch->curveName ());
+    if (showThisCurve != batch->isVisible ()) {
 
-      bool showThisPoint = show;
-      if (show && !showAll) {
-        QString identifier = item->data (DATA_KEY_IDENTIFIER).toString ();
-        QString curveNameGot = Point::curveNameFromPointIdentifier (identifier);
+      batch->setVisible (showThisCurve);
 
-        showThisPoint = (curveNameWanted == curveNameGot);
+      const PointIdentifierToGraphicsItem &items = m_curveIndexToGraphicsItems [itrC.key ()];
+      PointIdentifierToGraphicsItem::const_iterator itrP;
+      for (itrP = items.begin (); itrP != items.end (); itrP++) {
+        itrP.value ()->setVisible (showThisCurve);
       }
+    }
+  }
+}
 
-      item->setVisible (showThisPoint);
+void GraphicsScene::unsetCursorForPoints ()
+{
+  m_pointsHaveCursor = false;
 
-    }
+  PointIdentifierToGraphicsItem::const_iterator itr;
+  for (itr = m_pointIdentifierToGraphicsItem.begin (); itr != m_pointIdentifierToGraphicsItem.end (); itr++) {
+    itr.value ()->unsetCursor ();
   }
 }
 
 void GraphicsScene::updateAfterCommand (CmdMediator &cmdMediator)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateAfterCommand";
+  Document &document = cmdMediator.document ();
+
+  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsScene::updateAfterCommand"
+                              << " changed=" << (document.pointIdentifiersChangedAll () ?
+                                                   QString ("all") :
+                                                   QString::number (document.pointIdentifiersChanged ().count ())).toLatin1 ().data ();
 
+  if (document.pointIdentifiersChangedAll ()) {
+    updateAfterCommandAll (document);
+  } else {
+    updateAfterCommandChanged (document);
+  }
+
+  document.resetPointIdentifiersChanged ();
+}
+
+void GraphicsScene::updateAfterCommandAll (const Document &document)
+{
   // First pass:
-  // 1) Create map from point identifier to graphics item
-  // 2) Mark all points as Not Wanted (this is done by while creating the map)
-  PointIdentifierToGraphicsItem pointIdentifierToGraphicsItem = mapPointIdentifierToGraphicsItem();
+  // 1) Collect the identifiers of the points in the scene. Every point starts out as Not Wanted
+  QHash<PointIdentifier, bool> pointIdentifiersUnseen;
+  QHash<quint64, GraphicsPointsBatch*>::const_iterator itrC;
+  for (itrC = m_curveIndexToBatch.begin (); itrC != m_curveIndexToBatch.end (); itrC++) {
+
+    PointIdentifierList identifiers = itrC.value ()->identifiers ();
+    PointIdentifierList::const_iterator itrP;
+    for (itrP = identifiers.begin (); itrP != identifiers.end (); itrP++) {
+      pointIdentifiersUnseen [*itrP] = true;
+    }
+  }
 
-  CallbackSceneUpdateAfterCommand ftor (pointIdentifierToGraphicsItem,
+  CallbackSceneUpdateAfterCommand ftor (pointIdentifiersUnseen,
                                         *this,
-                                        cmdMediator.document ());
+                                        document);
 
-  Functor2wRet<const QString &, const Point&, CallbackSearchReturn> ftorWithCallback = functor_ret (ftor,
-                                                                                                    &CallbackSceneUpdateAfterCommand::callback);
   // Next pass:
-  // 1) Existing points that are found in the map are marked as Wanted
-  // 2) Add new points that were just created in the Document. The new points are marked as Wanted
-  cmdMediator.iterateThroughCurvePointsAxes (ftorWithCallback);
-  cmdMediator.iterateThroughCurvesPointsGraphs (ftorWithCallback);
+  // 1) Existing points that are found are taken out of the unseen set, since they are Wanted
+  // 2) Add new points that were just created in the Document
+  document.iterateThroughCurvePointsAxes (ftor);
+  document.iterateThroughCurvesPointsGraphs (ftor);
 
   // Next pass:
   // 1) Remove points that were just removed from the Document
-  QList<QGraphicsItem*> items = QGraphicsScene::items();
-  QList<QGraphicsItem*>::iterator itrG = items.begin ();
-  while (itrG != items.end()) {
+  QHash<PointIdentifier, bool>::const_iterator itr;
+  for (itr = pointIdentifiersUnseen.begin (); itr != pointIdentifiersUnseen.end (); itr++) {
+    removePoint (itr.key ());
+  }
+}
 
-    QGraphicsItem* item = *itrG;
+void GraphicsScene::updateAfterCommandChanged (const Document &document)
+{
+  // Only the changed points are visited, so a single point edit does not depend on the size of the Document
+  const QHash<PointIdentifier, bool> &changed = document.pointIdentifiersChanged ();
+  QHash<PointIdentifier, bool>::const_iterator itr;
+  for (itr = changed.begin (); itr != changed.end (); itr++) {
 
-    bool isWanted = item->data (DATA_KEY_WANTED).toBool ();
-    bool isPoint = (item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt () == GRAPHICS_ITEM_TYPE_POINT);
-    if (isPoint && !isWanted) {
+    PointIdentifier identifier = itr.key ();
 
-      removeItem (item);
-      itrG = items.erase (itrG);
+    if (!document.containsPoint (identifier)) {
 
-    } else {
+      // Point was removed from the Document
+      removePoint (identifier);
 
-      ++itrG;
+    } else if (!containsPoint (identifier)) {
+
+      // Point was added to the Document
+      const Curve *curve = document.curveForPointIdentifier (identifier);
+      Q_CHECK_PTR (curve);
+      addPoint (identifier,
+                curve->pointStyle (),
+                document.positionScreen (identifier));
+
+    } else {
 
+      // Point was moved or edited
+      movePoint (identifier,
+                 document.positionScreen (identifier));
     }
   }
 }
@@ -3,59 +3,135 @@
 
 #include "CmdMediator.h"
 #include "PointIdentifierToGraphicsItem.h"
+#include <QCursor>
 #include <QGraphicsScene>
+#include <QHash>
 #include <QStringList>
 
 class CmdMediator;
 class Curve;
 class CurvesGraphs;
 class DocumentModelCurveProperties;
+class GraphicsPointsBatch;
 class MainWindow;
 class PointStyle;
 class QGraphicsItem;
 
 /// Add Point handling to generic QGraphicsScene. The primary task is to update the graphics items to stay in
 /// sync with the Points in the Document.
+///
+/// The Points of each Curve are drawn by one GraphicsPointsBatch item. A Point gets its own selectable and movable
+/// item only when it is promoted, which happens when it is clicked or inside the rubber band, and it goes back to the
+/// batch once it is no longer selected. The promoted items are indexed by identifier and by curve, and the selected
+/// and moved items are tracked as they change through notifications from the items, so queries and bulk changes
+/// never scan all of the scene items
 class GraphicsScene : public QGraphicsScene
 {
 public:
   /// Single constructor.
   GraphicsScene(MainWindow *mainWindow);
 
-  /// Add one QGraphicsItem-based object that represents one Point.
-  QGraphicsItem *addPoint (const QString &identifier,
-                           const PointStyle &pointStyle,
-                           const QPointF &posScreen);
+  /// Add one Point to the batch item of its Curve.
+  void addPoint (PointIdentifier identifier,
+                 const PointStyle &pointStyle,
+                 const QPointF &posScreen);
+
+  /// True if the Point is in the scene.
+  bool containsPoint (PointIdentifier identifier) const;
 
   /// Dump all important cursors
   QString dumpCursors () const;
 
-  /// Create a map from Point identifier to graphics item in the scene. Typically the map lives only briefly and
-  /// gets regenerated whenever it is needed.
-  PointIdentifierToGraphicsItem mapPointIdentifierToGraphicsItem ();
+  /// Map from Point identifier to graphics item, for the promoted Points. The map is kept up to date as points are
+  /// promoted and demoted, so this does not visit the items.
+  PointIdentifierToGraphicsItem mapPointIdentifierToGraphicsItem () const;
+
+  /// Move a Point, and its promoted item if there is one.
+  void movePoint (PointIdentifier identifier,
+                  const QPointF &posScreen);
+
+  /// Record that the item of the specified Point has moved. Called by the point items.
+  void notifyPointMoved (PointIdentifier identifier);
+
+  /// Record that the item of the specified Point has been selected or unselected. Called by the point items.
+  void notifyPointSelected (PointIdentifier identifier,
+                            bool isSelected);
 
   /// Return a list of identifiers for the points that have moved since the last call to resetPositionHasChanged.
-  QStringList positionHasChangedPointIdentifiers () const;
+  PointIdentifierList positionHasChangedPointIdentifiers () const;
+
+  /// Give the Point its own selectable and movable item, if it does not have one already.
+  void promotePoint (PointIdentifier identifier);
+
+  /// Promote the visible Points inside the rectangle, so a rubber band selection can select them.
+  void promotePointsInRect (const QRectF &rect);
+
+  /// Remove the Point, and its promoted item if there is one.
+  void removePoint (PointIdentifier identifier);
 
   /// Reset positionHasChanged flag for all items. Typically this is done as part of mousePressEvent.
   void resetPositionHasChanged();
 
   /// Return a list of identifiers for the currently selected points.
-  QStringList selectedPointIdentifiers () const;
+  PointIdentifierList selectedPointIdentifiers () const;
+
+  /// Apply the cursor to all promoted point items, including those promoted later, until unsetCursorForPoints is
+  /// called.
+  void setCursorForPoints (const QCursor &cursor);
 
-  /// Show or hide all the Points in the Curves (if showAll is true) or just the selected Curve (if showAll is false);
+  /// Show or hide all the Points in the Curves (if showAll is true) or just the selected Curve (if showAll is false).
+  /// Only the items of Curves whose visibility changes are visited
   void showPoints (bool show,
                    bool showAll = false,
                    const QString &curveName = "");
 
-  /// Update the Curves and their Points after executing a command.
+  /// Opposite of setCursorForPoints.
+  void unsetCursorForPoints ();
+
+  /// Update the Curves and their Points after executing a command. Only the items of the Points that the Document
+  /// reports as changed are visited, unless the Document reports that all Points may have changed.
   void updateAfterCommand (CmdMediator &cmdMediator);
 
   /// Update curve properties after settings changed.
   void updateCurveProperties(const DocumentModelCurveProperties &modelCurveProperties);
 
+protected:
+  /// Show the tooltip of a batched Point.
+  virtual void helpEvent (QGraphicsSceneHelpEvent *event);
+
+  /// Demote the Points that are no longer selected, and promote the Point under the cursor so it can be selected
+  /// and dragged.
+  virtual void mousePressEvent (QGraphicsSceneMouseEvent *event);
+
 private:
-  const QGraphicsPixmapItem *image () const;
+  PointIdentifier batchedPointIdentifierAt (const QPointF &posScreen) const;
+  bool curveIsShown (const QString &curveName) const;
+  void demotePoint (PointIdentifier identifier);
+  void demoteUnselectedPoints ();
+  const QGraphicsItem *image () const;
+  void updateAfterCommandAll (const Document &document);
+  void updateAfterCommandChanged (const Document &document);
+
+  // Batch item of each Curve, created when its first Point is added. Keyed by the curve index in the identifiers (see
+  // Point::curveIndexFromPointIdentifier), so finding the batch of a Point does not resolve its curve name
+  QHash<quint64, GraphicsPointsBatch*> m_curveIndexToBatch;
+
+  // Items of the promoted Points, by identifier and by curve index, maintained by promotePoint and demotePoint
+  PointIdentifierToGraphicsItem m_pointIdentifierToGraphicsItem;
+  QHash<quint64, PointIdentifierToGraphicsItem> m_curveIndexToGraphicsItems;
+
+  // Points whose items are selected, and whose items moved since resetPositionHasChanged
+  QHash<PointIdentifier, bool> m_pointIdentifiersSelected;
+  QHash<PointIdentifier, bool> m_pointIdentifiersMoved;
+
+  // Arguments of the last showPoints call, which also apply to items added afterwards
+  bool m_showPoints;
+  bool m_showPointsAll;
+  QString m_showPointsCurveName;
+
+  // Cursor from setCursorForPoints, which also applies to items added afterwards
+  bool m_pointsHaveCursor;
+  QCursor m_pointsCursor;
 };
 
 #endif // GRAPHICS_SCENE_H
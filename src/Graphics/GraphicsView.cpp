@@ -1,5 +1,6 @@
 #include "DataKey.h"
 #include "GraphicsItemType.h"
+#include "GraphicsScene.h"
 #include "GraphicsView.h"
 #include "Logger.h"
 #include "MainWindow.h"
@@ -13,14 +14,16 @@
 #include <QMouseEvent>
 #include <QScrollBar>
 #include "QtToString.h"
+#include "ViewRenderQuality.h"
 
 extern const QString AXIS_CURVE_NAME;
 
 GraphicsView::GraphicsView(QGraphicsScene *scene,
                            MainWindow &mainWindow) :
-  QGraphicsView (scene)
+  QGraphicsView (scene),
+  m_renderQuality (0)
 {
-  connect (this, SIGNAL (signalContextMenuEvent (QString)), &mainWindow, SLOT (slotContextMenuEvent (QString)));
+  connect (this, SIGNAL (signalContextMenuEvent (PointIdentifier)), &mainWindow, SLOT (slotContextMenuEvent (PointIdentifier)));
   connect (this, SIGNAL (signalDraggedImage (QImage)), &mainWindow, SLOT (slotFileImportDraggedImage (QImage)));
   connect (this, SIGNAL (signalDraggedImageUrl (QUrl)), &mainWindow, SLOT (slotFileImportDraggedImageUrl (QUrl)));
   connect (this, SIGNAL (signalKeyPress (Qt::Key)), &mainWindow, SLOT (slotKeyPress (Qt::Key)));
@@ -28,11 +31,16 @@ GraphicsView::GraphicsView(QGraphicsScene *scene,
   connect (this, SIGNAL (signalMouseMove(QPointF)), &mainWindow, SLOT (slotMouseMove (QPointF)));
   connect (this, SIGNAL (signalMousePress (QPointF)), &mainWindow, SLOT (slotMousePress (QPointF)));
   connect (this, SIGNAL (signalMouseRelease (QPointF)), &mainWindow, SLOT (slotMouseRelease (QPointF)));
+  connect (this, SIGNAL (rubberBandChanged (QRect, QPointF, QPointF)), this, SLOT (slotRubberBandChanged (QRect, QPointF, QPointF)));
 
   setMouseTracking (true);
   setAcceptDrops (true);
   setEnabled (true);
   setBackgroundBrush (QBrush (QColor (Qt::gray)));
+
+  // Full quality smooths the zoomed out background. Interactions fall back to fast rendering
+  setRenderHint (QPainter::SmoothPixmapTransform);
+  m_renderQuality = new ViewRenderQuality (*this);
   verticalScrollBar()->setCursor (QCursor (Qt::ArrowCursor));
   horizontalScrollBar()->setCursor (QCursor (Qt::ArrowCursor));
 
@@ -60,7 +68,7 @@ void GraphicsView::contextMenuEvent (QContextMenuEvent *event)
   if (items.count () == 1) {
 
     QGraphicsItem *item = items.first ();
-    QString pointIdentifier = item->data (DATA_KEY_IDENTIFIER).toString ();
+    PointIdentifier pointIdentifier = item->data (DATA_KEY_IDENTIFIER).toULongLong ();
     GraphicsItemType type = (GraphicsItemType) item->data (DATA_KEY_GRAPHICS_ITEM_TYPE).toInt ();
     QString curveName = Point::curveNameFromPointIdentifier (pointIdentifier);
 
@@ -195,6 +203,11 @@ void GraphicsView::mouseMoveEvent (QMouseEvent *event)
 
   emit signalMouseMove (posScreen);
 
+  // Moving with a button down drags points or the rubber band
+  if (event->buttons () != Qt::NoButton) {
+    m_renderQuality->startInteraction ();
+  }
+
   QGraphicsView::mouseMoveEvent (event);
 }
 
@@ -235,15 +248,27 @@ void GraphicsView::mouseReleaseEvent (QMouseEvent *event)
   QGraphicsView::mouseReleaseEvent (event);
 }
 
-void GraphicsView::resetPositionHasChangedFlags()
+void GraphicsView::paintEvent (QPaintEvent *event)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "GraphicsView::resetPositionHasChangedFlags";
+  // Scrolling and zooming both change the viewport transform
+  if (viewportTransform () != m_transformPainted) {
 
-  QList<QGraphicsItem*> items = scene()->items ();
-  QList<QGraphicsItem*>::const_iterator itr;
-  for (itr = items.begin (); itr != items.end (); itr++) {
+    m_transformPainted = viewportTransform ();
+    m_renderQuality->startInteraction ();
+  }
 
-    QGraphicsItem *item = *itr;
-    item->setData (DATA_KEY_POSITION_HAS_CHANGED, false);
+  QGraphicsView::paintEvent (event);
+}
+
+void GraphicsView::slotRubberBandChanged (QRect rubberBandRect,
+                                          QPointF fromScenePoint,
+                                          QPointF toScenePoint)
+{
+  // This is emitted before the selection area is applied, so the batched Points inside the rubber band are promoted
+  // in time to be selected. The empty rectangle at the end of the drag is ignored
+  GraphicsScene *graphicsScene = dynamic_cast<GraphicsScene*> (scene ());
+  if (!rubberBandRect.isNull () && (graphicsScene != 0)) {
+    graphicsScene->promotePointsInRect (QRectF (fromScenePoint,
+                                                toScenePoint).normalized ());
   }
 }
@@ -1,13 +1,16 @@
 #ifndef GRAPHICSVIEW_H
 #define GRAPHICSVIEW_H
 
+#include "PointIdentifier.h"
 #include <QGraphicsView>
 #include <QImage>
+#include <QTransform>
 #include <QUrl>
 
 class MainWindow;
 class QGraphicsPixmapItem;
 class QGraphicsScene;
+class ViewRenderQuality;
 
 /// QGraphicsView class with event handling added. Typically the events are sent to the active digitizing state.
 class GraphicsView : public QGraphicsView
@@ -47,12 +50,12 @@ public:
   /// Intercept mouse release events to move one or more Points.
   virtual void mouseReleaseEvent (QMouseEvent *event);
 
-  /// Prepare for possible item moves after mousePressEvent.
-  void resetPositionHasChangedFlags();
+  /// Intercept paint events to render quickly while the view is panned or zoomed.
+  virtual void paintEvent (QPaintEvent *event);
 
 signals:
   /// Send right click on axis point to MainWindow for editing.
-  void signalContextMenuEvent (QString pointIdentifier);
+  void signalContextMenuEvent (PointIdentifier pointIdentifier);
 
   /// Send dragged image to MainWindow for import. This typically comes from dragging a file
   void signalDraggedImage (QImage);
@@ -75,10 +78,18 @@ signals:
   /// Send mouse release to MainWindow for moving Points.
   void signalMouseRelease (QPointF);
 
+private slots:
+  void slotRubberBandChanged (QRect rubberBandRect,
+                              QPointF fromScenePoint,
+                              QPointF toScenePoint);
+
 private:
   GraphicsView();
 
   bool inBounds (const QPointF &posScreen);
+
+  ViewRenderQuality *m_renderQuality;
+  QTransform m_transformPainted; // Viewport transform of the last paint, for detecting pans and zooms
 };
 
 #endif // GRAPHICSVIEW_H
@@ -4,13 +4,20 @@
 #include "Logger.h"
 #include <QDebug>
 #include <QPixmap>
+#include <qmath.h>
 #include "QtToString.h"
 #include "Transformation.h"
 
 const int MIN_STEP_PIXELS = 5;
 const double PEAK_HALF_WIDTH = 4;
-
-GridClassifier::GridClassifier()
+const int PEAK_HALF_WIDTH_FINE = 3; // Fine bins are one pixel wide, so fine pickets are narrow like the grid lines
+const int NUM_PICKET_FENCE_STEPS = NUM_HISTOGRAM_BINS - MIN_STEP_PIXELS; // Candidate steps in searchStartStepSpace
+
+GridClassifier::GridClassifier(bool isCoarseToFine) :
+  m_isCoarseToFine (isCoarseToFine),
+  m_correlation (NUM_HISTOGRAM_BINS,
+                 NUM_PICKET_FENCE_STEPS),
+  m_numHistogramBinsFine (0)
 {
 }
 
@@ -36,7 +43,7 @@ void GridClassifier::classify (const QPixmap &originalPixmap,
                                 xMax,
                                 yMin,
                                 yMax);
-  initializeHistogramBins ();
+  initializeHistogramBins (image);
   populateHistogramBins (image,
                          transformation,
                          xMin,
@@ -55,6 +62,30 @@ void GridClassifier::classify (const QPixmap &originalPixmap,
                         binStepX,
                         binStartY,
                         binStepY);
+
+  if (m_isCoarseToFine) {
+
+    // Refine start and step around the coarse values. Count is still searched in the coarse histogram, since
+    // it is an integer and does not benefit from the extra resolution
+    double binStartFineX, binStepFineX, binStartFineY, binStepFineY;
+    refineStartStep (m_binsFineX,
+                     binStartX,
+                     binStepX,
+                     binStartFineX,
+                     binStepFineX);
+    refineStartStep (m_binsFineY,
+                     binStartY,
+                     binStepY,
+                     binStartFineY,
+                     binStepFineY);
+
+    // Convert from fine bins back to graph coordinates
+    startX = xMin + binStartFineX / (m_numHistogramBinsFine - 1.0) * (xMax - xMin);
+    startY = yMin + binStartFineY / (m_numHistogramBinsFine - 1.0) * (yMax - yMin);
+    stepX = binStepFineX / (m_numHistogramBinsFine - 1.0) * (xMax - xMin);
+    stepY = binStepFineY / (m_numHistogramBinsFine - 1.0) * (yMax - yMin);
+  }
+
   searchCountSpace (m_binsX,
                     binStartX,
                     binStepX,
@@ -94,7 +125,34 @@ void GridClassifier::computeGraphCoordinateLimits (const QImage &image,
   Q_ASSERT (yMin < yMax);
 }
 
-void GridClassifier::initializeHistogramBins ()
+double GridClassifier::correlatePicketFenceFine (const HistogramBins &binsFine,
+                                                 const HistogramBins &binsFineSums,
+                                                 int binStart,
+                                                 int binStep) const
+{
+  // Only the bins under the pickets contribute to the correlation, so rather than loading a full picket fence
+  // the triangular pickets are visited directly
+  int numBins = binsFine.size ();
+  double corr = 0.0;
+  for (int binPicket = binStart; binPicket - PEAK_HALF_WIDTH_FINE < numBins; binPicket += binStep) {
+    for (int offset = 1 - PEAK_HALF_WIDTH_FINE; offset < PEAK_HALF_WIDTH_FINE; offset++) {
+
+      int bin = binPicket + offset;
+      if (0 <= bin && bin < numBins) {
+        corr += binsFine [bin] * (1.0 - (double) qAbs (offset) / PEAK_HALF_WIDTH_FINE);
+      }
+    }
+  }
+
+  // Normalize the picket fence to zero mean like Correlation does. The area under each triangular picket is
+  // PEAK_HALF_WIDTH_FINE, so the mean is that area per step, and it applies to the bins from the first picket onward
+  double picketFenceMean = (double) PEAK_HALF_WIDTH_FINE / binStep;
+  corr -= picketFenceMean * (binsFineSums [numBins] - binsFineSums [binStart]);
+
+  return corr;
+}
+
+void GridClassifier::initializeHistogramBins (const QImage &image)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GridClassifier::initializeHistogramBins";
 
@@ -102,6 +160,15 @@ void GridClassifier::initializeHistogramBins ()
     m_binsX [bin] = 0;
     m_binsY [bin] = 0;
   }
+
+  if (m_isCoarseToFine) {
+
+    // One fine bin per pixel along the longest side of the image
+    m_numHistogramBinsFine = qMax (NUM_HISTOGRAM_BINS,
+                                   qMax (image.width (), image.height ()));
+    m_binsFineX.fill (0, m_numHistogramBinsFine);
+    m_binsFineY.fill (0, m_numHistogramBinsFine);
+  }
 }
 
 void GridClassifier::loadPicketFence (double picketFence [NUM_HISTOGRAM_BINS],
@@ -142,6 +209,23 @@ void GridClassifier::loadPicketFence (double picketFence [NUM_HISTOGRAM_BINS],
   }
 }
 
+double GridClassifier::parabolicPeakOffset (double corrLeft,
+                                            double corrCenter,
+                                            double corrRight) const
+{
+  // Fit a parabola through the three samples and return the offset of its vertex from the center sample
+  double denominator = corrLeft - 2.0 * corrCenter + corrRight;
+  if (denominator >= 0) {
+
+    // Not a peak, so there is nothing to interpolate
+    return 0.0;
+  }
+
+  double offset = 0.5 * (corrLeft - corrRight) / denominator;
+
+  return qMax (-0.5, qMin (0.5, offset));
+}
+
 void GridClassifier::populateHistogramBins (const QImage &image,
                                             const Transformation &transformation,
                                             double xMin,
@@ -154,7 +238,12 @@ void GridClassifier::populateHistogramBins (const QImage &image,
   Filter filter;
   QRgb rgbBackground = filter.marginColor (&image);
 
+  // Pixels are gathered one column at a time and then transformed in one batch
+  QVector<QPointF> positions (image.height ());
+
   for (int x = 0; x < image.width(); x++) {
+
+    int count = 0;
     for (int y = 0; y < image.height(); y++) {
 
       QColor pixel = image.pixel (x, y);
@@ -163,22 +252,113 @@ void GridClassifier::populateHistogramBins (const QImage &image,
       if (!filter.colorCompare (rgbBackground,
                                 pixel.rgb ())) {
 
-        // Add this pixel to histograms
-        QPointF posGraph;
-        transformation.transform (QPointF (x, y), posGraph);
-        int binX = (NUM_HISTOGRAM_BINS - 1.0) * (posGraph.x() - xMin) / (xMax - xMin);
-        int binY = (NUM_HISTOGRAM_BINS - 1.0) * (posGraph.y() - yMin) / (yMax - yMin);
+        positions [count++] = QPointF (x, y);
+      }
+    }
+
+    transformation.transformMany (count,
+                                  positions.constData (),
+                                  positions.data ());
 
-        Q_ASSERT (binX < NUM_HISTOGRAM_BINS);
-        Q_ASSERT (binY < NUM_HISTOGRAM_BINS);
+    for (int i = 0; i < count; i++) {
 
-        ++m_binsX [binX];
-        ++m_binsY [binY];
+      // Add this pixel to histograms
+      const QPointF &posGraph = positions [i];
+      int binX = (NUM_HISTOGRAM_BINS - 1.0) * (posGraph.x() - xMin) / (xMax - xMin);
+      int binY = (NUM_HISTOGRAM_BINS - 1.0) * (posGraph.y() - yMin) / (yMax - yMin);
+
+      Q_ASSERT (binX < NUM_HISTOGRAM_BINS);
+      Q_ASSERT (binY < NUM_HISTOGRAM_BINS);
+
+      ++m_binsX [binX];
+      ++m_binsY [binY];
+
+      if (m_isCoarseToFine) {
+
+        int binFineX = (m_numHistogramBinsFine - 1.0) * (posGraph.x() - xMin) / (xMax - xMin);
+        int binFineY = (m_numHistogramBinsFine - 1.0) * (posGraph.y() - yMin) / (yMax - yMin);
+
+        ++m_binsFineX [binFineX];
+        ++m_binsFineY [binFineY];
       }
     }
   }
 }
 
+void GridClassifier::refineStartStep (const HistogramBins &binsFine,
+                                      double binStartCoarse,
+                                      double binStepCoarse,
+                                      double &binStartFine,
+                                      double &binStepFine) const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GridClassifier::refineStartStep";
+
+  int numBins = binsFine.size ();
+  double binsFinePerBinCoarse = (numBins - 1.0) / (NUM_HISTOGRAM_BINS - 1.0);
+
+  // Search window covers one coarse bin on either side of the coarse start and step. Steps are kept wide
+  // enough that neighboring pickets never overlap
+  int halfWidth = qMax (1, qCeil (binsFinePerBinCoarse));
+  int binStartCenter = qRound (binStartCoarse * binsFinePerBinCoarse);
+  int binStepCenter = qRound (binStepCoarse * binsFinePerBinCoarse);
+  int binStartLow = qMax (0, binStartCenter - halfWidth);
+  int binStartHigh = qMin (numBins - 1, binStartCenter + halfWidth);
+  int binStepLow = qMax (2 * PEAK_HALF_WIDTH_FINE, binStepCenter - halfWidth);
+  int binStepHigh = qMax (binStepLow, binStepCenter + halfWidth);
+
+  // Normalize histogram to zero mean, and precompute the running sums so the picket fence mean can be
+  // subtracted without visiting every bin
+  double sumMean = 0;
+  for (int bin = 0; bin < numBins; bin++) {
+    sumMean += binsFine [bin];
+  }
+
+  HistogramBins binsZeroMean (numBins), binsZeroMeanSums (numBins + 1);
+  binsZeroMeanSums [0] = 0;
+  for (int bin = 0; bin < numBins; bin++) {
+    binsZeroMean [bin] = binsFine [bin] - sumMean / numBins;
+    binsZeroMeanSums [bin + 1] = binsZeroMeanSums [bin] + binsZeroMean [bin];
+  }
+
+  // Correlate every (start,step) combination in the window
+  int numStarts = binStartHigh - binStartLow + 1;
+  int numSteps = binStepHigh - binStepLow + 1;
+  QVector<double> corrs (numStarts * numSteps);
+  int indexStartMax = 0, indexStepMax = 0;
+  for (int indexStep = 0; indexStep < numSteps; indexStep++) {
+    for (int indexStart = 0; indexStart < numStarts; indexStart++) {
+
+      double corr = correlatePicketFenceFine (binsZeroMean,
+                                              binsZeroMeanSums,
+                                              binStartLow + indexStart,
+                                              binStepLow + indexStep);
+      corrs [indexStep * numStarts + indexStart] = corr;
+
+      if (corr > corrs [indexStepMax * numStarts + indexStartMax]) {
+        indexStartMax = indexStart;
+        indexStepMax = indexStep;
+      }
+    }
+  }
+
+  // Sub-bin interpolation of the peak, separately along start and step. A peak on the edge of the window
+  // is not interpolated in that direction
+  double offsetStart = 0, offsetStep = 0;
+  if (0 < indexStartMax && indexStartMax < numStarts - 1) {
+    offsetStart = parabolicPeakOffset (corrs [indexStepMax * numStarts + indexStartMax - 1],
+                                       corrs [indexStepMax * numStarts + indexStartMax],
+                                       corrs [indexStepMax * numStarts + indexStartMax + 1]);
+  }
+  if (0 < indexStepMax && indexStepMax < numSteps - 1) {
+    offsetStep = parabolicPeakOffset (corrs [(indexStepMax - 1) * numStarts + indexStartMax],
+                                      corrs [indexStepMax * numStarts + indexStartMax],
+                                      corrs [(indexStepMax + 1) * numStarts + indexStartMax]);
+  }
+
+  binStartFine = binStartLow + indexStartMax + offsetStart;
+  binStepFine = binStepLow + indexStepMax + offsetStep;
+}
+
 void GridClassifier::searchCountSpace (double bins [NUM_HISTOGRAM_BINS],
                                        double binStart,
                                        double binStep,
@@ -187,7 +367,6 @@ void GridClassifier::searchCountSpace (double bins [NUM_HISTOGRAM_BINS],
   LOG4CPP_INFO_S ((*mainCat)) << "GridClassifier::searchCountSpace";
 
   // Loop though the space of possible counts
-  Correlation correlation (NUM_HISTOGRAM_BINS);
   double picketFence [NUM_HISTOGRAM_BINS];
   double corr, corrMax;
   bool isFirst = true;
@@ -200,7 +379,7 @@ void GridClassifier::searchCountSpace (double bins [NUM_HISTOGRAM_BINS],
                      count,
                      true);
 
-    correlation.correlateWithoutShift (NUM_HISTOGRAM_BINS,
+    m_correlation.correlateWithoutShift (NUM_HISTOGRAM_BINS,
                                        bins,
                                        picketFence,
                                        corr);
@@ -228,41 +407,50 @@ void GridClassifier::searchStartStepSpace (double xMin,
 {
   LOG4CPP_INFO_S ((*mainCat)) << "GridClassifier::searchStartStepSpace";
 
-  // Loop though the space of possible gridlines using the independent variables (start,step).
-  Correlation correlation (NUM_HISTOGRAM_BINS);
-  double picketFence [NUM_HISTOGRAM_BINS];
-  int binStartX, binStartY;
-  double corrX, corrY, corrXMax, corrYMax;
-  bool isFirst = true;
+  // Loop though the space of possible gridlines using the independent variables (start,step). Every candidate
+  // step gets its own picket fence, and all of them are correlated against each histogram in one batch
+  QVector<double> picketFences (NUM_PICKET_FENCE_STEPS * NUM_HISTOGRAM_BINS);
   for (int binStep = MIN_STEP_PIXELS; binStep < NUM_HISTOGRAM_BINS; binStep++) {
 
     const int BIN_START = 0;
-    loadPicketFence (picketFence,
+    loadPicketFence (&picketFences [(binStep - MIN_STEP_PIXELS) * NUM_HISTOGRAM_BINS],
                      BIN_START,
                      binStep,
                      0,
                      false);
+  }
+
+  QVector<int> binStartsX, binStartsY;
+  QVector<double> corrsX, corrsY;
+  m_correlation.correlateWithShiftMany (NUM_HISTOGRAM_BINS,
+                                        m_binsX,
+                                        NUM_PICKET_FENCE_STEPS,
+                                        picketFences.constData (),
+                                        binStartsX,
+                                        corrsX);
+  m_correlation.correlateWithShiftMany (NUM_HISTOGRAM_BINS,
+                                        m_binsY,
+                                        NUM_PICKET_FENCE_STEPS,
+                                        picketFences.constData (),
+                                        binStartsY,
+                                        corrsY);
+
+  double corrXMax, corrYMax;
+  bool isFirst = true;
+  for (int binStep = MIN_STEP_PIXELS; binStep < NUM_HISTOGRAM_BINS; binStep++) {
+
+    int kernel = binStep - MIN_STEP_PIXELS;
 
-    correlation.correlateWithShift (NUM_HISTOGRAM_BINS,
-                                    m_binsX,
-                                    picketFence,
-                                    binStartX,
-                                    corrX);
-    correlation.correlateWithShift (NUM_HISTOGRAM_BINS,
-                                    m_binsY,
-                                    picketFence,
-                                    binStartY,
-                                    corrY);
-    if (isFirst || (corrX > corrXMax)) {
-      binStartXMax = binStartX;
+    if (isFirst || (corrsX [kernel] > corrXMax)) {
+      binStartXMax = binStartsX [kernel];
       binStepXMax = binStep;
-      corrXMax = corrX;
+      corrXMax = corrsX [kernel];
     }
 
-    if (isFirst || (corrY > corrYMax)) {
-      binStartYMax = binStartY;
+    if (isFirst || (corrsY [kernel] > corrYMax)) {
+      binStartYMax = binStartsY [kernel];
       binStepYMax = binStep;
-      corrYMax = corrY;
+      corrYMax = corrsY [kernel];
     }
     isFirst = false;
   }
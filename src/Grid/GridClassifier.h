@@ -1,13 +1,20 @@
 #ifndef GRID_CLASSIFIER_H
 #define GRID_CLASSIFIER_H
 
+#include "Correlation.h"
+#include <QVector>
+
+class QImage;
 class QPixmap;
 class Transformation;
 
 // Number of histogram bins could be so large that each bin corresponds to one pixel, but computation time may then be
-// too slow when doing the correleations later on
+// too slow when doing the correleations later on. The coarse-to-fine mode gets around that by only searching a
+// narrow window of the fine histogram, which has one bin per pixel
 const int NUM_HISTOGRAM_BINS = 400;
 
+typedef QVector<double> HistogramBins;
+
 /// Classify the grid pattern in an original image.
 ///
 /// This class uses the following tricks for faster performance:
@@ -19,11 +26,18 @@ const int NUM_HISTOGRAM_BINS = 400;
 ///    end of the end of the image back around to the start of the image - so the grid line count is
 ///    not even relevant. In other words, the searches are START X STEP + COUNT rather than
 ///    START X STEP X COUNT
+/// -# The start and step search correlates each histogram against every candidate picket fence in one batch, so
+///    the histogram is transformed once and the picket fences are transformed by a single FFTW plan
+/// -# In coarse-to-fine mode, start and step from the coarse histogram are refined using a fine histogram with one
+///    bin per pixel. Only a window of one coarse bin on either side of the coarse start and step is searched, and the
+///    picket fence correlation is evaluated sparsely at the pickets. One coarse bin spans about max(width, height) /
+///    NUM_HISTOGRAM_BINS fine bins, so the refinement still grows with the image size, but far more slowly than a
+///    search of the whole fine histogram. Parabolic interpolation of the correlation peak then gives sub-bin accuracy
 class GridClassifier
 {
 public:
-  /// Single constructor.
-  GridClassifier();
+  /// Single constructor. Coarse-to-fine refinement of start and step is optional
+  GridClassifier(bool isCoarseToFine);
 
   /// Classify the specified image, and return the most probably x and y grid settings.
   void classify (const QPixmap &originalPixmap,
@@ -44,18 +58,30 @@ private:
                                      double &xMax,
                                      double &yMin,
                                      double &yMax);
-  void initializeHistogramBins ();
+  void initializeHistogramBins (const QImage &image);
+  double correlatePicketFenceFine (const HistogramBins &binsFine,
+                                   const HistogramBins &binsFineSums,
+                                   int binStart,
+                                   int binStep) const;
   void loadPicketFence (double picketFence [NUM_HISTOGRAM_BINS],
                         int binStart,
                         int binStep,
                         int count,
                         bool isCount);
+  double parabolicPeakOffset (double corrLeft,
+                              double corrCenter,
+                              double corrRight) const;
   void populateHistogramBins (const QImage &image,
                               const Transformation &transformation,
                               double xMin,
                               double xMax,
                               double yMin,
                               double yMax);
+  void refineStartStep (const HistogramBins &binsFine,
+                        double binStartCoarse,
+                        double binStepCoarse,
+                        double &binStartFine,
+                        double &binStepFine) const;
   void searchCountSpace (double bins [NUM_HISTOGRAM_BINS],
                          double binStart,
                          double binStep,
@@ -73,8 +99,17 @@ private:
                              double &binStartY,
                              double &binStepY);
 
+  bool m_isCoarseToFine;
+
+  Correlation m_correlation;
+
   double m_binsX [NUM_HISTOGRAM_BINS];
   double m_binsY [NUM_HISTOGRAM_BINS];
+
+  // Fine histograms for coarse-to-fine mode. Empty if that mode is off
+  int m_numHistogramBinsFine;
+  HistogramBins m_binsFineX;
+  HistogramBins m_binsFineY;
 };
 
 #endif // GRID_CLASSIFIER_H
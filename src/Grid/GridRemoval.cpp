@@ -0,0 +1,402 @@
+#include "DocumentModelCoords.h"
+#include "DocumentModelGridRemoval.h"
+#include "GridRemoval.h"
+#include "Logger.h"
+#include <QColor>
+#include <QImage>
+#include <qmath.h>
+#include "Transformation.h"
+#include "TransformationPipelineAbstractBase.h"
+
+const int BITS_PER_WORD = 32;
+const quint32 ALL_BITS = 0xffffffff;
+const int MAX_GRID_LINES = 1000; // Guard against a tiny step producing an unreasonable number of grid lines
+const int NUM_POLAR_SEGMENTS = 90; // Polar grid lines are curved in screen coordinates so they are approximated by segments
+
+// Coordinates far outside the image, from extreme axis transformations, would overflow when converted to int, so they
+// are first clamped to just outside the image. Ranges that lie entirely outside the image therefore stay empty
+static double clampToImage (double value,
+                            int size)
+{
+  return qBound (-1.0, value, (double) size);
+}
+
+GridRemoval::GridRemoval() :
+  m_width (0),
+  m_height (0),
+  m_wordsPerRow (0),
+  m_isEmpty (true)
+{
+}
+
+void GridRemoval::applyMask (QImage &imageFiltered) const
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GridRemoval::applyMask";
+
+  Q_ASSERT (imageFiltered.format () == QImage::Format_RGB32);
+  Q_ASSERT (imageFiltered.width () == m_width);
+  Q_ASSERT (imageFiltered.height () == m_height);
+
+  if (m_isEmpty) {
+    return;
+  }
+
+  QRgb rgbOff = QColor (Qt::white).rgb ();
+
+  for (int y = 0; y < m_height; y++) {
+
+    QRgb *line = (QRgb *) imageFiltered.scanLine (y);
+    const quint32 *words = &m_mask [y * m_wordsPerRow];
+
+    for (int word = 0; word < m_wordsPerRow; word++) {
+
+      // Most words are far from the grid lines, so they are skipped without looking at their pixels
+      quint32 bits = words [word];
+      for (int bit = 0; bits != 0; bit++, bits >>= 1) {
+        if ((bits & 1) != 0) {
+          line [word * BITS_PER_WORD + bit] = rgbOff;
+        }
+      }
+    }
+  }
+}
+
+void GridRemoval::applyMask (QImage &imageTile,
+                             const QRectF &rectImage) const
+{
+  Q_ASSERT (imageTile.format () == QImage::Format_RGB32);
+
+  if (m_isEmpty || imageTile.isNull ()) {
+    return;
+  }
+
+  QRgb rgbOff = QColor (Qt::white).rgb ();
+
+  // Size of one tile pixel in full size image pixels
+  double pixelWidth = rectImage.width () / imageTile.width ();
+  double pixelHeight = rectImage.height () / imageTile.height ();
+
+  for (int row = 0; row < imageTile.height (); row++) {
+
+    int y = qFloor (rectImage.top () + (row + 0.5) * pixelHeight);
+    if ((y < 0) || (y >= m_height)) {
+      continue;
+    }
+
+    QRgb *line = (QRgb *) imageTile.scanLine (row);
+    const quint32 *words = &m_mask [y * m_wordsPerRow];
+
+    for (int column = 0; column < imageTile.width (); column++) {
+
+      int x = qFloor (rectImage.left () + (column + 0.5) * pixelWidth);
+      if ((x >= 0) &&
+          (x < m_width) &&
+          ((words [x / BITS_PER_WORD] & (1u << (x % BITS_PER_WORD))) != 0)) {
+        line [column] = rgbOff;
+      }
+    }
+  }
+}
+
+bool GridRemoval::clipInterval (double slope,
+                                double intercept,
+                                double low,
+                                double high,
+                                double &xLeft,
+                                double &xRight) const
+{
+  // Narrow the interval xLeft to xRight to the values of x for which low <= slope * x + intercept <= high. Returns
+  // false if the interval is empty
+  if (qAbs (slope) < 1e-12) {
+
+    // Constraint does not depend on x, so it either keeps or rejects the whole interval
+    return (low <= intercept) && (intercept <= high);
+
+  }
+
+  double x0 = (low - intercept) / slope;
+  double x1 = (high - intercept) / slope;
+
+  xLeft = qMax (xLeft, qMin (x0, x1));
+  xRight = qMin (xRight, qMax (x0, x1));
+
+  return xLeft <= xRight;
+}
+
+bool GridRemoval::isEmpty () const
+{
+  return m_isEmpty;
+}
+
+void GridRemoval::mergeDisk (const QPointF &posCenter,
+                             int y,
+                             double radius,
+                             bool &isOn,
+                             double &xLeft,
+                             double &xRight) const
+{
+  // Merge the intersection of the disk with row y into the interval. The union of the end disks and the body of
+  // a segment is convex, so the pieces always combine into a single interval
+  double dy = y - posCenter.y ();
+  double halfWidthSquared = radius * radius - dy * dy;
+  if (halfWidthSquared >= 0) {
+
+    double halfWidth = qSqrt (halfWidthSquared);
+    if (isOn) {
+      xLeft = qMin (xLeft, posCenter.x () - halfWidth);
+      xRight = qMax (xRight, posCenter.x () + halfWidth);
+    } else {
+      isOn = true;
+      xLeft = posCenter.x () - halfWidth;
+      xRight = posCenter.x () + halfWidth;
+    }
+  }
+}
+
+void GridRemoval::rasterizeGridLine (const DocumentModelCoords &modelCoords,
+                                     const TransformationPipelineAbstractBase &pipeline,
+                                     const Transformation &transformation,
+                                     const QPointF &posGraphStart,
+                                     const QPointF &posGraphStop,
+                                     double closeDistance)
+{
+  // Straight grid lines in cartesian coordinates stay straight in screen coordinates, so only the endpoints are
+  // transformed. In polar coordinates the lines of constant radius are arcs
+  int numSegments = (modelCoords.coordsType () == COORDS_TYPE_POLAR ?
+                     NUM_POLAR_SEGMENTS :
+                     1);
+
+  QVector<QPointF> positions (numSegments + 1);
+  int i;
+  for (i = 0; i <= numSegments; i++) {
+
+    double s = (double) i / numSegments;
+    positions [i] = posGraphStart + s * (posGraphStop - posGraphStart);
+  }
+
+  pipeline.cartesianFromCartesianOrPolarMany (positions.count (),
+                                              positions.constData (),
+                                              positions.data ());
+  transformation.transformInverseMany (positions.count (),
+                                       positions.constData (),
+                                       positions.data ());
+
+  for (i = 1; i <= numSegments; i++) {
+    rasterizeSegment (positions [i - 1],
+                      positions [i],
+                      closeDistance);
+  }
+}
+
+void GridRemoval::rasterizeMask (const DocumentModelGridRemoval &modelGridRemoval,
+                                 const DocumentModelCoords &modelCoords,
+                                 const Transformation &transformation,
+                                 int width,
+                                 int height)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "GridRemoval::rasterizeMask";
+
+  m_width = width;
+  m_height = height;
+  m_wordsPerRow = (width + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  m_isEmpty = true;
+  m_mask.fill (0, m_wordsPerRow * height);
+
+  double closeDistance = modelGridRemoval.closeDistance ();
+
+  if (modelGridRemoval.removeDefinedGridLines () &&
+      (closeDistance > 0) &&
+      transformation.transformIsDefined ()) {
+
+    int countX, countY;
+    double startX, startY, stepX, stepY;
+    resolveGridCoords (modelGridRemoval.gridCoordDisableX (),
+                       modelGridRemoval.countX (),
+                       modelGridRemoval.startX (),
+                       modelGridRemoval.stepX (),
+                       modelGridRemoval.stopX (),
+                       countX,
+                       startX,
+                       stepX);
+    resolveGridCoords (modelGridRemoval.gridCoordDisableY (),
+                       modelGridRemoval.countY (),
+                       modelGridRemoval.startY (),
+                       modelGridRemoval.stepY (),
+                       modelGridRemoval.stopY (),
+                       countY,
+                       startY,
+                       stepY);
+
+    // Each set of grid lines runs from the first to the last grid line of the other set
+    double stopX = startX + (countX - 1) * stepX;
+    double stopY = startY + (countY - 1) * stepY;
+
+    // Cartesian/polar conversion is selected once for all of the grid lines
+    const TransformationPipelineAbstractBase &pipeline = TransformationPipelineAbstractBase::select (modelCoords);
+
+    int i;
+    for (i = 0; i < countX; i++) {
+      double x = startX + i * stepX;
+      rasterizeGridLine (modelCoords,
+                         pipeline,
+                         transformation,
+                         QPointF (x, startY),
+                         QPointF (x, stopY),
+                         closeDistance);
+    }
+
+    for (i = 0; i < countY; i++) {
+      double y = startY + i * stepY;
+      rasterizeGridLine (modelCoords,
+                         pipeline,
+                         transformation,
+                         QPointF (startX, y),
+                         QPointF (stopX, y),
+                         closeDistance);
+    }
+  }
+}
+
+void GridRemoval::rasterizeSegment (const QPointF &posScreenStart,
+                                    const QPointF &posScreenStop,
+                                    double closeDistance)
+{
+  QPointF delta = posScreenStop - posScreenStart;
+  double length = qSqrt (delta.x () * delta.x () + delta.y () * delta.y ());
+
+  int yMin = qMax (0, qCeil (clampToImage (qMin (posScreenStart.y (), posScreenStop.y ()) - closeDistance, m_height)));
+  int yMax = qMin (m_height - 1, qFloor (clampToImage (qMax (posScreenStart.y (), posScreenStop.y ()) + closeDistance, m_height)));
+
+  for (int y = yMin; y <= yMax; y++) {
+
+    bool isOn = false;
+    double xLeft = 0, xRight = 0;
+
+    // Rounded ends
+    mergeDisk (posScreenStart, y, closeDistance, isOn, xLeft, xRight);
+    mergeDisk (posScreenStop, y, closeDistance, isOn, xLeft, xRight);
+
+    if (length > 0) {
+
+      // Body is the set of points whose projection along the segment falls inside the segment, and whose
+      // projection across the segment is within the close distance
+      double alongX = delta.x () / length, alongY = delta.y () / length;
+      double dy = y - posScreenStart.y ();
+      double bodyLeft = -1e300, bodyRight = 1e300;
+      if (clipInterval (alongX,
+                        alongY * dy - alongX * posScreenStart.x (),
+                        0,
+                        length,
+                        bodyLeft,
+                        bodyRight) &&
+          clipInterval (-alongY,
+                        alongX * dy + alongY * posScreenStart.x (),
+                        -closeDistance,
+                        closeDistance,
+                        bodyLeft,
+                        bodyRight)) {
+
+        if (isOn) {
+          xLeft = qMin (xLeft, bodyLeft);
+          xRight = qMax (xRight, bodyRight);
+        } else {
+          isOn = true;
+          xLeft = bodyLeft;
+          xRight = bodyRight;
+        }
+      }
+    }
+
+    if (isOn) {
+      setBits (y,
+               qMax (0, qCeil (clampToImage (xLeft, m_width))),
+               qMin (m_width - 1, qFloor (clampToImage (xRight, m_width))));
+    }
+  }
+}
+
+void GridRemoval::removeGridLines (const DocumentModelGridRemoval &modelGridRemoval,
+                                   const DocumentModelCoords &modelCoords,
+                                   const Transformation &transformation,
+                                   QImage &imageFiltered)
+{
+  rasterizeMask (modelGridRemoval,
+                 modelCoords,
+                 transformation,
+                 imageFiltered.width (),
+                 imageFiltered.height ());
+  applyMask (imageFiltered);
+}
+
+void GridRemoval::resolveGridCoords (GridCoordDisable gridCoordDisable,
+                                     int count,
+                                     double start,
+                                     double step,
+                                     double stop,
+                                     int &countResolved,
+                                     double &startResolved,
+                                     double &stepResolved) const
+{
+  // Only three of the four values are specified, with the disabled value following from the other three
+  countResolved = count;
+  startResolved = start;
+  stepResolved = step;
+
+  switch (gridCoordDisable) {
+    case GRID_COORD_DISABLE_COUNT:
+      countResolved = (step > 0 ? 1 + qFloor ((stop - start) / step) : 0);
+      break;
+
+    case GRID_COORD_DISABLE_START:
+      startResolved = stop - (count - 1) * step;
+      break;
+
+    case GRID_COORD_DISABLE_STEP:
+      stepResolved = (count > 1 ? (stop - start) / (count - 1) : 0);
+      break;
+
+    case GRID_COORD_DISABLE_STOP:
+      break;
+
+    default:
+      Q_ASSERT (false);
+  }
+
+  if ((stepResolved <= 0) && (countResolved > 1)) {
+
+    // Degenerate grid, so only the first line is kept
+    countResolved = 1;
+  }
+
+  countResolved = qMax (0, qMin (MAX_GRID_LINES, countResolved));
+}
+
+void GridRemoval::setBits (int y,
+                           int xStart,
+                           int xStop)
+{
+  if (xStart > xStop) {
+    return;
+  }
+
+  m_isEmpty = false;
+
+  quint32 *row = &m_mask [y * m_wordsPerRow];
+  int wordStart = xStart / BITS_PER_WORD;
+  int wordStop = xStop / BITS_PER_WORD;
+  quint32 bitsStart = ALL_BITS << (xStart % BITS_PER_WORD);
+  quint32 bitsStop = ALL_BITS >> (BITS_PER_WORD - 1 - xStop % BITS_PER_WORD);
+
+  if (wordStart == wordStop) {
+
+    row [wordStart] |= (bitsStart & bitsStop);
+
+  } else {
+
+    row [wordStart] |= bitsStart;
+    for (int word = wordStart + 1; word < wordStop; word++) {
+      row [word] = ALL_BITS;
+    }
+    row [wordStop] |= bitsStop;
+  }
+}
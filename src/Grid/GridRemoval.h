@@ -0,0 +1,99 @@
+#ifndef GRID_REMOVAL_H
+#define GRID_REMOVAL_H
+
+#include "DocumentModelGridRemoval.h"
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+class DocumentModelCoords;
+class QImage;
+class Transformation;
+class TransformationPipelineAbstractBase;
+
+/// Remove pixels close to the defined grid lines from the filtered image, so the grid lines do not produce
+/// useless runs and branch points during segment extraction.
+///
+/// This class uses the following tricks for faster performance:
+/// -# The grid lines are inverse-transformed into screen coordinates once, rather than transforming every pixel
+///    into graph coordinates
+/// -# Each grid line segment is rasterized row by row, as the interval of pixels within the close distance, so the
+///    mask is filled a word at a time rather than pixel by pixel
+/// -# The mask has one bit per pixel, so applying it tests 32 pixels per word and skips the large areas far from
+///    the grid lines without touching the image
+class GridRemoval
+{
+public:
+  /// Single constructor.
+  GridRemoval();
+
+  /// Apply the mask to the filtered image, turning off (to white) every pixel close to a grid line. The image must
+  /// be QImage::Format_RGB32 and have the same size as the mask
+  void applyMask (QImage &imageFiltered) const;
+
+  /// Apply the mask to one tile of a filtered image, which covers the specified rectangle of the full size image,
+  /// possibly at a lower resolution. Each tile pixel is turned off if the mask pixel at its center is on
+  void applyMask (QImage &imageTile,
+                  const QRectF &rectImage) const;
+
+  /// Return true if no pixels are close to a grid line, which is the case if grid line removal is turned off.
+  bool isEmpty () const;
+
+  /// Rasterize the mask of pixels within the close distance of the grid lines defined in DocumentModelGridRemoval.
+  void rasterizeMask (const DocumentModelGridRemoval &modelGridRemoval,
+                      const DocumentModelCoords &modelCoords,
+                      const Transformation &transformation,
+                      int width,
+                      int height);
+
+  /// Convenience method that rasterizes the mask and applies it to the filtered image.
+  void removeGridLines (const DocumentModelGridRemoval &modelGridRemoval,
+                        const DocumentModelCoords &modelCoords,
+                        const Transformation &transformation,
+                        QImage &imageFiltered);
+
+private:
+
+  bool clipInterval (double slope,
+                     double intercept,
+                     double low,
+                     double high,
+                     double &xLeft,
+                     double &xRight) const;
+  void mergeDisk (const QPointF &posCenter,
+                  int y,
+                  double radius,
+                  bool &isOn,
+                  double &xLeft,
+                  double &xRight) const;
+  void rasterizeGridLine (const DocumentModelCoords &modelCoords,
+                          const TransformationPipelineAbstractBase &pipeline,
+                          const Transformation &transformation,
+                          const QPointF &posGraphStart,
+                          const QPointF &posGraphStop,
+                          double closeDistance);
+  void rasterizeSegment (const QPointF &posScreenStart,
+                         const QPointF &posScreenStop,
+                         double closeDistance);
+  void resolveGridCoords (GridCoordDisable gridCoordDisable,
+                          int count,
+                          double start,
+                          double step,
+                          double stop,
+                          int &countResolved,
+                          double &startResolved,
+                          double &stepResolved) const;
+  void setBits (int y,
+                int xStart,
+                int xStop);
+
+  int m_width;
+  int m_height;
+  int m_wordsPerRow;
+  bool m_isEmpty;
+
+  // One bit per pixel, with pixel x of row y at bit x % 32 of word y * m_wordsPerRow + x / 32
+  QVector<quint32> m_mask;
+};
+
+#endif // GRID_REMOVAL_H
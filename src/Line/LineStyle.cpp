@@ -1,4 +1,5 @@
 #include "LineStyle.h"
+#include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
 const int DEFAULT_LINE_WIDTH = 1;
@@ -54,6 +55,16 @@ LineStyle LineStyle::defaultGraphCurve (int /* index */)
                     CONNECT_AS_FUNCTION); // Same default color as used for PointStyle graph curves default
 }
 
+void LineStyle::loadStyle (QXmlStreamReader &reader)
+{
+  QXmlStreamAttributes attributes = reader.attributes ();
+  m_width = attributes.value ("LineWidth").toString ().toUInt ();
+  m_paletteColor = (ColorPalette) attributes.value ("Color").toString ().toInt ();
+  m_curveConnectAs = (CurveConnectAs) attributes.value ("ConnectAs").toString ().toInt ();
+
+  reader.skipCurrentElement ();
+}
+
 ColorPalette LineStyle::paletteColor() const
 {
   return m_paletteColor;
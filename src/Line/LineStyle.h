@@ -5,6 +5,7 @@
 #include "CurveConnectAs.h"
 #include <QColor>
 
+class QXmlStreamReader;
 class QXmlStreamWriter;
 
 /// Details for a specific Line.
@@ -34,6 +35,9 @@ public:
   /// Initial default for index'th graph curve.
   static LineStyle defaultGraphCurve (int index);
 
+  /// Load style from the attributes of the current element of the reader, which is then skipped. See saveStyle.
+  void loadStyle (QXmlStreamReader &reader);
+
   /// Line color.
   ColorPalette paletteColor() const;
 
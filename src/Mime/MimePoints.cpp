@@ -1,3 +1,4 @@
+#include "ExportToClipboard.h"
 #include "MimePoints.h"
 
 const QString FORMAT_CSV ("text/csv");
@@ -5,30 +6,30 @@ const QString FORMAT_CSV_INTERNAL ("text/engauge-points-csv"); // Custom mime ty
 const QString FORMAT_HTML ("text/html");
 const QString FORMAT_PLAIN ("text/plain");
 
-MimePoints::MimePoints ()
+MimePoints::MimePoints () :
+  m_transformIsDefined (false)
 {
 }
 
-MimePoints::MimePoints(const QString &csvGraph,
-                       const QString &htmlGraph) :
-  m_csvGraph (csvGraph),
-  m_htmlGraph (htmlGraph)
+MimePoints::MimePoints(const MimePointsCurves &curves,
+                       bool transformIsDefined) :
+  m_curves (curves),
+  m_transformIsDefined (transformIsDefined)
 {
-  m_formats << FORMAT_CSV << FORMAT_HTML << FORMAT_PLAIN;
-}
-
-MimePoints::MimePoints (const QString &csvPoints) :
-  m_csvPoints (csvPoints)
-{
-  m_formats << FORMAT_CSV_INTERNAL;
+  if (transformIsDefined) {
+    m_formats << FORMAT_CSV << FORMAT_HTML << FORMAT_PLAIN;
+  } else {
+    m_formats << FORMAT_CSV_INTERNAL;
+  }
 }
 
 MimePoints &MimePoints::operator=(const MimePoints &other)
 {
-  m_csvGraph = other.csvGraph();
-  m_csvPoints = other.csvPoints();
-  m_htmlGraph = other.htmlGraph();
+  m_curves = other.curves();
+  m_transformIsDefined = other.m_transformIsDefined;
   m_formats = other.formats();
+  m_csv = other.m_csv;
+  m_html = other.m_html;
 
   return *this;
 }
@@ -39,12 +40,25 @@ MimePoints::~MimePoints ()
 
 QString MimePoints::csvGraph () const
 {
-  return m_csvGraph;
+  if (m_transformIsDefined) {
+    return QString::fromUtf8 (renderedCsv ());
+  }
+
+  return QString ();
 }
 
 QString MimePoints::csvPoints () const
 {
-  return m_csvPoints;
+  if (!m_transformIsDefined) {
+    return QString::fromUtf8 (renderedCsv ());
+  }
+
+  return QString ();
+}
+
+MimePointsCurves MimePoints::curves () const
+{
+  return m_curves;
 }
 
 QStringList MimePoints::formats() const
@@ -54,22 +68,43 @@ QStringList MimePoints::formats() const
 
 QString MimePoints::htmlGraph () const
 {
-  return m_htmlGraph;
+  if (m_transformIsDefined) {
+    return QString::fromUtf8 (renderedHtml ());
+  }
+
+  return QString ();
+}
+
+QByteArray MimePoints::renderedCsv () const
+{
+  if (m_csv.isNull ()) {
+    ExportToClipboard exportStrategy;
+    m_csv = exportStrategy.exportCsv (m_curves);
+  }
+
+  return m_csv;
+}
+
+QByteArray MimePoints::renderedHtml () const
+{
+  if (m_html.isNull ()) {
+    ExportToClipboard exportStrategy;
+    m_html = exportStrategy.exportHtml (m_curves);
+  }
+
+  return m_html;
 }
 
 QVariant MimePoints::retrieveData (const QString &format,
                                    QVariant::Type /* preferredType */) const
 {
-  if (format == FORMAT_CSV) {
-    return m_csvGraph;
-  } else if (format == FORMAT_CSV_INTERNAL) {
-    return m_csvPoints;
-  } else if (format == FORMAT_HTML) {
-    return m_htmlGraph;
-  } else if (format == FORMAT_PLAIN) {
-    return m_csvGraph;
-  } else {
+  // The bytes are utf8, which QMimeData converts when a string is wanted
+  if (!m_formats.contains (format)) {
     QVariant null;
     return null;
+  } else if (format == FORMAT_HTML) {
+    return renderedHtml ();
+  } else {
+    return renderedCsv (); // FORMAT_CSV, FORMAT_CSV_INTERNAL or FORMAT_PLAIN
   }
 }
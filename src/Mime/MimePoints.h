@@ -1,21 +1,29 @@
 #ifndef MIME_POINTS_H
 #define MIME_POINTS_H
 
+#include "MimePointsCurve.h"
+#include <QByteArray>
 #include <QMimeData>
 
+extern const QString FORMAT_CSV;
+extern const QString FORMAT_CSV_INTERNAL;
+extern const QString FORMAT_HTML;
+extern const QString FORMAT_PLAIN;
+
 /// Custom mime type for separate treatment of graph coordinates and, when there is no transform, points coordinates.
+///
+/// Only a snapshot of the coordinates is kept. Each text format is rendered the first time it is requested through
+/// retrieveData, so copying a large selection is immediate and formats that no application asks for cost nothing
 class MimePoints : public QMimeData
 {
 public:
   /// Default constructor. Initial contents are overwritten by other constructors.
   MimePoints();
 
-  /// Constructor when graph coordinates are available because the transformation is defined.
-  MimePoints(const QString &csvGraph,
-             const QString &htmlGraph);
-
-  /// Constructor when transformation is not defined. This data is not meant to leave this application
-  MimePoints (const QString &csvPoints);
+  /// Constructor from the captured coordinates. These are graph coordinates if the transformation is defined, and
+  /// points coordinates otherwise. Points coordinates are not meant to leave this application
+  MimePoints(const MimePointsCurves &curves,
+             bool transformIsDefined);
 
   /// Assignment operator.
   MimePoints &operator=(const MimePoints &other);
@@ -29,6 +37,9 @@ public:
   /// Get method for csvPoints.
   QString csvPoints () const;
 
+  /// Get method for the captured coordinates.
+  MimePointsCurves curves () const;
+
   /// Available formats, which depend on whether or not the transform is defined
   virtual QStringList formats() const;
 
@@ -36,15 +47,21 @@ public:
   QString htmlGraph () const;
 
 protected:
-  /// Returns a variant with the data for the specified format.
+  /// Returns a variant with the data for the specified format. The text is rendered on the first request.
   virtual QVariant retrieveData (const QString &format,
                                  QVariant::Type preferredType) const;
 
 private:
-  QString m_csvGraph;
-  QString m_csvPoints;
-  QString m_htmlGraph;
+  QByteArray renderedCsv () const;
+  QByteArray renderedHtml () const;
+
+  MimePointsCurves m_curves;
+  bool m_transformIsDefined;
   QStringList m_formats;
+
+  // Text renderings, which stay null until requested
+  mutable QByteArray m_csv;
+  mutable QByteArray m_html;
 };
 
 #endif // MIME_POINTS_H
@@ -0,0 +1,25 @@
+#ifndef MIME_POINTS_CURVE_H
+#define MIME_POINTS_CURVE_H
+
+#include <QList>
+#include <QString>
+#include <QVector>
+
+/// Coordinates of the points of one curve, as placed on or read from the clipboard. The coordinates are kept as
+/// columns so a snapshot of a large selection costs two doubles per point, and no text until a format is requested
+struct MimePointsCurve
+{
+  /// Curve name. Empty when the points were pasted from text without a header.
+  QString curveName;
+
+  /// X coordinates.
+  QVector<double> x;
+
+  /// Y coordinates.
+  QVector<double> y;
+};
+
+/// Curves in the order they appear on the clipboard.
+typedef QList<MimePointsCurve> MimePointsCurves;
+
+#endif // MIME_POINTS_CURVE_H
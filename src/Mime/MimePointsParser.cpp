@@ -0,0 +1,207 @@
+#include <cstring>
+#include "MimePoints.h"
+#include "MimePointsParser.h"
+#include <QMimeData>
+
+const char TAB_DELIMITER = '\t';
+
+// Integers up to this value are exact in a double
+const quint64 MAX_EXACT_MANTISSA = ((quint64) 1) << 53;
+
+// Digits beyond this many are not accumulated, since the mantissa would overflow
+const int MAX_MANTISSA_DIGITS = 19;
+
+// Powers of ten that are exact in a double. Multiplying or dividing an exact mantissa by one of these is correctly
+// rounded, which covers the numbers that ExportToClipboard writes
+const int MAX_EXACT_POWER_OF_TEN = 22;
+static const double POWERS_OF_TEN [] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+MimePointsParser::MimePointsParser()
+{
+}
+
+bool MimePointsParser::parse (const QByteArray &csv,
+                              MimePointsCurves &curves) const
+{
+  MimePointsCurves parsed;
+
+  const char *pos = csv.constData ();
+  const char *end = pos + csv.size ();
+  while (pos < end) {
+
+    const char *endOfLine = (const char *) memchr (pos, '\n', end - pos);
+    if (endOfLine == 0) {
+      endOfLine = end;
+    }
+
+    const char *last = endOfLine;
+    if ((last > pos) && (*(last - 1) == '\r')) {
+      --last;
+    }
+
+    if (last > pos) {
+
+      if ((*pos == 'X') && (last - pos > 1) && (pos [1] == TAB_DELIMITER)) {
+
+        // Header that starts a new curve
+        MimePointsCurve curve;
+        curve.curveName = QString::fromUtf8 (pos + 2, last - pos - 2);
+        parsed << curve;
+
+      } else {
+
+        double x, y;
+        const char *ptr = parseNumber (pos, last, x);
+        if ((ptr == 0) || (ptr == last) || (*ptr != TAB_DELIMITER)) {
+          return false;
+        }
+
+        ptr = parseNumber (ptr + 1, last, y);
+        if (ptr != last) {
+          return false;
+        }
+
+        if (parsed.isEmpty ()) {
+          parsed << MimePointsCurve ();
+        }
+
+        MimePointsCurve &curve = parsed.last ();
+        curve.x << x;
+        curve.y << y;
+      }
+    }
+
+    pos = endOfLine + 1;
+  }
+
+  curves = parsed;
+
+  return true;
+}
+
+bool MimePointsParser::parse (const QMimeData &mimeData,
+                              MimePointsCurves &curves) const
+{
+  if (mimeData.hasFormat (FORMAT_CSV_INTERNAL)) {
+    return parse (mimeData.data (FORMAT_CSV_INTERNAL), curves);
+  } else if (mimeData.hasFormat (FORMAT_CSV)) {
+    return parse (mimeData.data (FORMAT_CSV), curves);
+  } else if (mimeData.hasText ()) {
+    return parse (mimeData.text ().toUtf8 (), curves);
+  }
+
+  return false;
+}
+
+const char *MimePointsParser::parseNumber (const char *first,
+                                           const char *last,
+                                           double &value) const
+{
+  // Returns the position just after the number, or zero if there is no number at first
+  const char *ptr = first;
+
+  bool isNegative = false;
+  if ((ptr < last) && ((*ptr == '-') || (*ptr == '+'))) {
+    isNegative = (*ptr == '-');
+    ++ptr;
+  }
+
+  quint64 mantissa = 0;
+  int mantissaDigits = 0;
+  int exponent = 0;
+  bool isExact = true;
+  bool hasDigits = false;
+
+  // Integer part. Leading zeros do not count as mantissa digits
+  while ((ptr < last) && (*ptr >= '0') && (*ptr <= '9')) {
+    if (mantissaDigits < MAX_MANTISSA_DIGITS) {
+      mantissa = 10 * mantissa + (*ptr - '0');
+      if (mantissa != 0) {
+        ++mantissaDigits;
+      }
+    } else {
+      ++exponent;
+      isExact = isExact && (*ptr == '0');
+    }
+    hasDigits = true;
+    ++ptr;
+  }
+
+  // Fractional part
+  if ((ptr < last) && (*ptr == '.')) {
+    ++ptr;
+    while ((ptr < last) && (*ptr >= '0') && (*ptr <= '9')) {
+      if (mantissaDigits < MAX_MANTISSA_DIGITS) {
+        mantissa = 10 * mantissa + (*ptr - '0');
+        if (mantissa != 0) {
+          ++mantissaDigits;
+        }
+        --exponent;
+      } else {
+        isExact = isExact && (*ptr == '0');
+      }
+      hasDigits = true;
+      ++ptr;
+    }
+  }
+
+  if (!hasDigits) {
+    return 0;
+  }
+
+  // Exponent
+  if ((ptr < last) && ((*ptr == 'e') || (*ptr == 'E'))) {
+    ++ptr;
+
+    bool exponentIsNegative = false;
+    if ((ptr < last) && ((*ptr == '-') || (*ptr == '+'))) {
+      exponentIsNegative = (*ptr == '-');
+      ++ptr;
+    }
+
+    if ((ptr == last) || (*ptr < '0') || (*ptr > '9')) {
+      return 0;
+    }
+
+    int exponentValue = 0;
+    while ((ptr < last) && (*ptr >= '0') && (*ptr <= '9')) {
+      if (exponentValue < 100000) {
+        exponentValue = 10 * exponentValue + (*ptr - '0');
+      }
+      ++ptr;
+    }
+
+    exponent += (exponentIsNegative ? -exponentValue : exponentValue);
+  }
+
+  if (isExact &&
+      (mantissa <= MAX_EXACT_MANTISSA) &&
+      (exponent >= -MAX_EXACT_POWER_OF_TEN) &&
+      (exponent <= MAX_EXACT_POWER_OF_TEN)) {
+
+    // Fast path
+    value = (double) mantissa;
+    if (exponent < 0) {
+      value /= POWERS_OF_TEN [-exponent];
+    } else {
+      value *= POWERS_OF_TEN [exponent];
+    }
+    if (isNegative) {
+      value = -value;
+    }
+
+  } else {
+
+    // Slow path for long mantissas and large exponents, which the clipboard text rarely has
+    bool ok;
+    value = QByteArray (first, ptr - first).toDouble (&ok);
+    if (!ok) {
+      return 0;
+    }
+  }
+
+  return ptr;
+}
@@ -0,0 +1,33 @@
+#ifndef MIME_POINTS_PARSER_H
+#define MIME_POINTS_PARSER_H
+
+#include "MimePointsCurve.h"
+#include <QByteArray>
+
+class QMimeData;
+
+/// Parser for the tab-delimited text that ExportToClipboard renders, for pasting points back in. Each line is split
+/// in place and the numbers are converted straight from the bytes, in the manner of std::from_chars, so no QString
+/// is created per line or per field. Text without header lines, as copied from a spreadsheet, gives one curve
+/// without a name
+class MimePointsParser
+{
+public:
+  /// Single constructor.
+  MimePointsParser();
+
+  /// Parse the text. Returns false, leaving curves unchanged, if any line is neither a header nor a pair of numbers.
+  bool parse (const QByteArray &csv,
+              MimePointsCurves &curves) const;
+
+  /// Parse the best available format of the mime data, preferring the formats that MimePoints provides.
+  bool parse (const QMimeData &mimeData,
+              MimePointsCurves &curves) const;
+
+private:
+  const char *parseNumber (const char *first,
+                           const char *last,
+                           double &value) const;
+};
+
+#endif // MIME_POINTS_PARSER_H
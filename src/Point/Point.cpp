@@ -1,9 +1,26 @@
 #include "Point.h"
-#include <QStringList>
-
-unsigned int Point::m_identifierIndex = 0;
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 
 const QString POINT_IDENTIFIER_DELIMITER ("_");
+const int SERIAL_BITS = 48;
+const quint64 SERIAL_MASK = (Q_UINT64_C (1) << SERIAL_BITS) - 1;
+
+// Next serial number. This is atomic so points can be generated in parallel
+static QAtomicInteger<quint64> identifierIndexNext (0);
+
+// Curve names are interned so an identifier only needs to hold a small index. Entry N-1 holds the name with index N.
+// Names are only ever appended, since old identifiers may still refer to them (from the undo stack for example). An
+// entry is written before the count that publishes it, so reading names takes no lock. Adding names is locked
+const int CURVE_NAMES_MAX = (1 << (64 - SERIAL_BITS)) - 1;
+static QMutex curveNamesMutex;
+static const QString *curveNames [CURVE_NAMES_MAX];
+static QAtomicInt curveNamesCount (0);
+static QHash<QString, quint64> curveNameToIndex;
+static const QString curveNameUnknown;
 
 Point::Point(const QString &curveName,
              const QPointF &posScreen,
@@ -17,7 +34,7 @@ Point::Point(const QString &curveName,
 
 Point::Point(const QString &curveName,
              const QPointF &posScreen,
-             const QString &identifier,
+             PointIdentifier identifier,
              const QPointF posGraph) :
   m_identifier (identifier),
   m_posScreen (posScreen),
@@ -42,20 +59,72 @@ Point &Point::operator=(const Point &point)
   return *this;
 }
 
-QString Point::curveNameFromPointIdentifier (const QString &pointIdentifier)
+quint64 Point::curveIndexFromCurveName (const QString &curveName)
+{
+  QMutexLocker locker (&curveNamesMutex);
+
+  quint64 curveIndex = curveNameToIndex.value (curveName);
+  if (curveIndex == 0) {
+
+    int count = curveNamesCount.load ();
+    Q_ASSERT (count < CURVE_NAMES_MAX);
+
+    curveNames [count] = new QString (curveName);
+    curveNamesCount.storeRelease (count + 1);
+
+    curveIndex = count + 1;
+    curveNameToIndex [curveName] = curveIndex;
+  }
+
+  return curveIndex;
+}
+
+quint64 Point::curveIndexFromPointIdentifier (PointIdentifier pointIdentifier)
+{
+  return pointIdentifier >> SERIAL_BITS;
+}
+
+const QString &Point::curveNameFromPointIdentifier (PointIdentifier pointIdentifier)
 {
-  QStringList tokens = pointIdentifier.split (POINT_IDENTIFIER_DELIMITER);
-  return tokens.value (0);
+  quint64 curveIndex = curveIndexFromPointIdentifier (pointIdentifier);
+  if ((curveIndex == 0) ||
+      (curveIndex > (quint64) curveNamesCount.loadAcquire ())) {
+    return curveNameUnknown;
+  }
+
+  return *curveNames [curveIndex - 1];
 }
 
-QString Point::identifier() const
+PointIdentifier Point::identifier() const
 {
   return m_identifier;
 }
 
-unsigned int Point::identifierIndex ()
+PointIdentifier Point::identifierFromCurveIndex (quint64 curveIndex,
+                                                quint64 serial)
+{
+  return (curveIndex << SERIAL_BITS) | (serial & SERIAL_MASK);
+}
+
+PointIdentifier Point::identifierFromSerial (const QString &curveName,
+                                             quint64 serial)
 {
-  return m_identifierIndex;
+  return identifierFromCurveIndex (curveIndexFromCurveName (curveName),
+                                   serial);
+}
+
+quint64 Point::identifierIndex ()
+{
+  return identifierIndexNext.load ();
+}
+
+QString Point::identifierToString (PointIdentifier pointIdentifier)
+{
+  return QString ("%1%2point%3%4")
+      .arg (curveNameFromPointIdentifier (pointIdentifier))
+      .arg (POINT_IDENTIFIER_DELIMITER)
+      .arg (POINT_IDENTIFIER_DELIMITER)
+      .arg (pointIdentifier & SERIAL_MASK);
 }
 
 QPointF Point::posGraph () const
@@ -68,9 +137,16 @@ QPointF Point::posScreen () const
   return m_posScreen;
 }
 
-void Point::setIdentifierIndex (unsigned int identifierIndex)
+quint64 Point::reserveIdentifierSerials (int count)
+{
+  Q_ASSERT (count >= 0);
+
+  return identifierIndexNext.fetchAndAddOrdered (count);
+}
+
+void Point::setIdentifierIndex (quint64 identifierIndex)
 {
-  m_identifierIndex = identifierIndex;
+  identifierIndexNext.store (identifierIndex);
 }
 
 void Point::setPosGraph (const QPointF &posGraph)
@@ -83,11 +159,8 @@ void Point::setPosScreen (const QPointF &posScreen)
   m_posScreen = posScreen;
 }
 
-QString Point::uniqueIdentifierGenerator (const QString &curveName)
+PointIdentifier Point::uniqueIdentifierGenerator (const QString &curveName)
 {
-  return QString ("%1%2point%3%4")
-      .arg (curveName)
-      .arg (POINT_IDENTIFIER_DELIMITER)
-      .arg (POINT_IDENTIFIER_DELIMITER)
-      .arg (m_identifierIndex++);
+  return identifierFromSerial (curveName,
+                               reserveIdentifierSerials (1));
 }
@@ -1,6 +1,7 @@
 #ifndef POINT_H
 #define POINT_H
 
+#include "PointIdentifier.h"
 #include <QPointF>
 #include <QString>
 
@@ -16,7 +17,7 @@ public:
   /// Constructor for specified identifier (after redo). The position, in screen coordinates, applies to the center of the Point
   Point (const QString &curveName,
          const QPointF &posScreen,
-         const QString &identifier,
+         PointIdentifier identifier,
          const QPointF posGraph = QPointF (0, 0));
 
   /// Copy constructor.
@@ -25,14 +26,34 @@ public:
   /// Assignment constructor.
   Point &operator=(const Point &point);
 
-  /// Parse the curve name from the specified point identifier. This does the opposite of uniqueIdentifierGenerator
-  static QString curveNameFromPointIdentifier (const QString &pointIdentifier);
+  /// Return the index of the curve name, adding it to the table of curve names if it is new. Indexes start at one.
+  /// This takes a lock, so code that builds many identifiers looks the index up once, see identifierFromCurveIndex
+  static quint64 curveIndexFromCurveName (const QString &curveName);
+
+  /// Return the curve index from the specified point identifier. Comparing indexes is cheaper than comparing names
+  static quint64 curveIndexFromPointIdentifier (PointIdentifier pointIdentifier);
+
+  /// Return the curve name from the specified point identifier. This is a table lookup without any lock or copy
+  static const QString &curveNameFromPointIdentifier (PointIdentifier pointIdentifier);
 
   /// Unique identifier for a specific Point.
-  QString identifier () const;
+  PointIdentifier identifier () const;
+
+  /// Build an identifier from a curve index returned by curveIndexFromCurveName, and a serial number returned by
+  /// reserveIdentifierSerials.
+  static PointIdentifier identifierFromCurveIndex (quint64 curveIndex,
+                                                   quint64 serial);
+
+  /// Build an identifier from a serial number returned by reserveIdentifierSerials.
+  static PointIdentifier identifierFromSerial (const QString &curveName,
+                                               quint64 serial);
 
   /// Return the current index for storage in case we need to reset it later while performing a Redo.
-  static unsigned int identifierIndex ();
+  static quint64 identifierIndex ();
+
+  /// Human readable form of the identifier, for tooltips, the clipboard and the file format only. Everything else
+  /// works with the integer form.
+  static QString identifierToString (PointIdentifier pointIdentifier);
 
   /// Accessor for graph position.
   QPointF posGraph () const;
@@ -40,8 +61,12 @@ public:
   /// Accessor for screen position
   QPointF posScreen () const;
 
+  /// Reserve count consecutive serial numbers, returning the first. Code that generates points in parallel reserves
+  /// one block up front and then builds identifiers with identifierFromSerial, without contending for the counter
+  static quint64 reserveIdentifierSerials (int count);
+
   /// Reset the current index while performing a Redo.
-  static void setIdentifierIndex (unsigned int identifierIndex);
+  static void setIdentifierIndex (quint64 identifierIndex);
 
   /// Set method for position in graph coordinates.
   void setPosGraph (const QPointF &posGraph);
@@ -55,15 +80,13 @@ private:
   /// Generate a unique identifier for a Point. This is static so it can be used while a
   /// GraphicsPointAbstractBase-based object is being constructed.
   ///
-  /// Identifiers follow sequential counting numbers since those are easier to deal with
+  /// Serial numbers follow sequential counting numbers since those are easier to deal with
   /// than alternatives such as 64-bit guids (like Microsoft)
-  static QString uniqueIdentifierGenerator(const QString &curveName);
+  static PointIdentifier uniqueIdentifierGenerator(const QString &curveName);
 
-  QString m_identifier;
+  PointIdentifier m_identifier;
   QPointF m_posScreen;
   QPointF m_posGraph;
-
-  static unsigned int m_identifierIndex; // For generating unique identifiers
 };
 
 #endif // POINT_H
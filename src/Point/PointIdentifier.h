@@ -0,0 +1,19 @@
+#ifndef POINT_IDENTIFIER_H
+#define POINT_IDENTIFIER_H
+
+#include <QList>
+#include <QtGlobal>
+
+/// Compact identifier for one Point. The upper 16 bits hold the index of the curve name (see
+/// Point::curveNameFromPointIdentifier) and the lower 48 bits hold a serial number that is unique within the process,
+/// so identifiers are compared and hashed as integers. The string form from Point::identifierToString is only
+/// used for display
+typedef quint64 PointIdentifier;
+
+/// List of point identifiers, such as the currently selected points.
+typedef QList<PointIdentifier> PointIdentifierList;
+
+/// Never assigned to a Point, since curve indexes start at one
+const PointIdentifier POINT_IDENTIFIER_INVALID = 0;
+
+#endif // POINT_IDENTIFIER_H
@@ -3,8 +3,8 @@
 
 #include <QGraphicsItem>
 #include <QHash>
-#include <QString>
+#include "PointIdentifier.h"
 
-typedef QHash<QString, QGraphicsItem*> PointIdentifierToGraphicsItem;
+typedef QHash<PointIdentifier, QGraphicsItem*> PointIdentifierToGraphicsItem;
 
 #endif // POINT_IDENTIFIER_TO_GRAPHICS_ITEM_H
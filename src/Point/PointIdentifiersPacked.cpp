@@ -0,0 +1,120 @@
+#include <algorithm>
+#include "PointIdentifiersPacked.h"
+
+const int BITS_PER_VARINT_BYTE = 7;
+const quint8 VARINT_MORE = 0x80; // Set in every byte of a delta except its last
+const quint8 VARINT_MASK = 0x7f;
+
+PointIdentifiersPacked::PointIdentifiersPacked() :
+  m_count (0),
+  m_isCompressed (false)
+{
+}
+
+PointIdentifiersPacked::PointIdentifiersPacked(const PointIdentifierList &identifiers) :
+  m_count (0),
+  m_isCompressed (false)
+{
+  PointIdentifierList sorted = identifiers;
+  std::sort (sorted.begin (), sorted.end ());
+
+  PointIdentifier previous = 0;
+  PointIdentifierList::const_iterator itr;
+  for (itr = sorted.begin (); itr != sorted.end (); itr++) {
+
+    PointIdentifier identifier = *itr;
+    if ((m_count > 0) && (identifier == previous)) {
+      continue; // Skip duplicate
+    }
+
+    // Identifiers of consecutively created points in one curve differ by small amounts, so the deltas are mostly a
+    // single byte. The first delta is from zero
+    quint64 delta = identifier - previous;
+    do {
+      quint8 byte = delta & VARINT_MASK;
+      delta >>= BITS_PER_VARINT_BYTE;
+      if (delta != 0) {
+        byte |= VARINT_MORE;
+      }
+      m_bytes.append ((char) byte);
+    } while (delta != 0);
+
+    previous = identifier;
+    ++m_count;
+  }
+
+  m_bytes.squeeze ();
+}
+
+bool PointIdentifiersPacked::operator==(const PointIdentifiersPacked &other) const
+{
+  if (m_count != other.count ()) {
+    return false;
+  }
+
+  return bytesUncompressed () == other.bytesUncompressed ();
+}
+
+int PointIdentifiersPacked::byteCount () const
+{
+  return sizeof (PointIdentifiersPacked) + m_bytes.size ();
+}
+
+QByteArray PointIdentifiersPacked::bytesUncompressed () const
+{
+  if (m_isCompressed) {
+    return qUncompress (m_bytes);
+  }
+
+  return m_bytes;
+}
+
+void PointIdentifiersPacked::compress ()
+{
+  if (!m_isCompressed) {
+
+    m_bytes = qCompress (m_bytes);
+    m_isCompressed = true;
+  }
+}
+
+int PointIdentifiersPacked::count () const
+{
+  return m_count;
+}
+
+PointIdentifierList PointIdentifiersPacked::identifiers () const
+{
+  PointIdentifierList identifiers;
+  identifiers.reserve (m_count);
+
+  QByteArray bytes = bytesUncompressed ();
+
+  PointIdentifier identifier = 0;
+  quint64 delta = 0;
+  int shift = 0;
+  for (int i = 0; i < bytes.size (); i++) {
+
+    quint8 byte = (quint8) bytes.at (i);
+    delta |= ((quint64) (byte & VARINT_MASK)) << shift;
+    shift += BITS_PER_VARINT_BYTE;
+
+    if ((byte & VARINT_MORE) == 0) {
+
+      identifier += delta;
+      identifiers << identifier;
+
+      delta = 0;
+      shift = 0;
+    }
+  }
+
+  Q_ASSERT (identifiers.count () == m_count);
+
+  return identifiers;
+}
+
+bool PointIdentifiersPacked::isCompressed () const
+{
+  return m_isCompressed;
+}
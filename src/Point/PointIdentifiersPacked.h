@@ -0,0 +1,47 @@
+#ifndef POINT_IDENTIFIERS_PACKED_H
+#define POINT_IDENTIFIERS_PACKED_H
+
+#include "PointIdentifier.h"
+#include <QByteArray>
+
+/// Compact, read-only set of point identifiers for storage in undo commands. The identifiers are sorted and stored
+/// as variable-length deltas, so a selection of points that were created one after another costs about one byte
+/// per point rather than the dozens of bytes per entry of a QHash. The bytes can additionally be compressed when the
+/// set is unlikely to be used again soon, such as in the oldest commands of the undo stack
+class PointIdentifiersPacked
+{
+public:
+  /// Default constructor for an empty set.
+  PointIdentifiersPacked();
+
+  /// Constructor from a list of identifiers, in any order and possibly with duplicates.
+  PointIdentifiersPacked(const PointIdentifierList &identifiers);
+
+  /// Equality operator. Sets are equal if they hold the same identifiers.
+  bool operator==(const PointIdentifiersPacked &other) const;
+
+  /// Approximate memory used by this set, in bytes.
+  int byteCount () const;
+
+  /// Compress the packed bytes. The set stays usable, at the cost of decompressing on each call to identifiers.
+  void compress ();
+
+  /// Number of identifiers.
+  int count () const;
+
+  /// Return the identifiers in increasing order, which allows membership tests with a binary search.
+  PointIdentifierList identifiers () const;
+
+  /// True if compress has been called.
+  bool isCompressed () const;
+
+private:
+
+  QByteArray bytesUncompressed () const;
+
+  QByteArray m_bytes;
+  int m_count;
+  bool m_isCompressed;
+};
+
+#endif // POINT_IDENTIFIERS_PACKED_H
@@ -1,5 +1,6 @@
 #include "PointStyle.h"
 #include <qmath.h>
+#include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
 const int DEFAULT_POINT_RADIUS = 10;
@@ -71,6 +72,17 @@ double PointStyle::lineWidth() const
   return m_lineWidth;
 }
 
+void PointStyle::loadStyle (QXmlStreamReader &reader)
+{
+  QXmlStreamAttributes attributes = reader.attributes ();
+  m_radius = attributes.value ("Radius").toString ().toUInt ();
+  m_lineWidth = attributes.value ("LineWidth").toString ().toDouble ();
+  m_paletteColor = (ColorPalette) attributes.value ("Color").toString ().toInt ();
+  m_shape = (PointShape) attributes.value ("Shape").toString ().toInt ();
+
+  reader.skipCurrentElement ();
+}
+
 ColorPalette PointStyle::paletteColor () const
 {
   return m_paletteColor;
@@ -163,6 +175,7 @@ void PointStyle::saveStyle(QXmlStreamWriter &stream,
   stream.writeStartElement("PointStyle");
   stream.writeAttribute ("Curve", curveName);
   stream.writeAttribute ("Radius", QString::number (m_radius));
+  stream.writeAttribute ("LineWidth", QString::number (m_lineWidth));
   stream.writeAttribute ("Color", QString::number (m_paletteColor));
   stream.writeAttribute ("Shape", QString::number (m_shape));
   stream.writeEndElement();
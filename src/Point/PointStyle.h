@@ -6,6 +6,7 @@
 #include <QColor>
 #include <QPolygonF>
 
+class QXmlStreamReader;
 class QXmlStreamWriter;
 
 /// Details for a specific Point.
@@ -39,6 +40,9 @@ public:
   /// Get method for line width.
   double lineWidth () const;
 
+  /// Load style from the attributes of the current element of the reader, which is then skipped. See saveStyle.
+  void loadStyle (QXmlStreamReader &reader);
+
   /// Get method for point color.
   ColorPalette paletteColor () const;
 
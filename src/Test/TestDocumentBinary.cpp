@@ -0,0 +1,142 @@
+#include "Curve.h"
+#include "Document.h"
+#include <QImage>
+#include <QScopedPointer>
+#include <QTemporaryFile>
+#include <QtTest/QtTest>
+#include "Test/TestDocumentBinary.h"
+
+const QString CURVE_NAME_SECOND ("Curve2");
+
+TestDocumentBinary::TestDocumentBinary(QObject *parent) :
+  QObject(parent)
+{
+}
+
+// Document with axis points and points in two graph curves. Coordinates have full mantissas so any rounding shows
+static Document *createDocument ()
+{
+  QImage image (40, 30, QImage::Format_RGB32);
+  image.fill (Qt::white);
+
+  Document *document = new Document (image);
+  document->addGraphCurveAtEnd (CURVE_NAME_SECOND);
+
+  PointIdentifier identifier;
+  document->addPointAxis (QPointF (1.0 / 3.0, 29.1), QPointF (0, 0), identifier);
+  document->addPointAxis (QPointF (39.7, 28.9), QPointF (1e-7, 0), identifier);
+  document->addPointAxis (QPointF (0.2, 2.0 / 7.0), QPointF (0, 123456.789), identifier);
+
+  QString curveNameFirst = document->curvesGraphsNames ().first ();
+  for (int index = 0; index < 100; index++) {
+    document->addPointGraph (curveNameFirst, QPointF (index / 10.0, 30.0 - index / 7.0), identifier);
+  }
+  document->addPointGraph (CURVE_NAME_SECOND, QPointF (3.14159265358979, 2.71828182845905), identifier);
+
+  return document;
+}
+
+// QPointF comparisons are fuzzy, while the binary format must keep every bit
+static bool isIdentical (const QPointF &first,
+                         const QPointF &second)
+{
+  return (first.x () == second.x ()) &&
+         (first.y () == second.y ());
+}
+
+// Save the document into the temporary file, and return the bytes that were written
+static QByteArray saveDocument (Document &document,
+                                QTemporaryFile &file)
+{
+  bool success = file.open ();
+  Q_ASSERT (success);
+  Q_UNUSED (success);
+
+  document.saveDocumentBinary (file);
+  file.close ();
+
+  file.open ();
+  QByteArray bytes = file.readAll ();
+  file.close ();
+
+  return bytes;
+}
+
+// Overwrite the temporary file with the specified bytes
+static void writeBytes (QTemporaryFile &file,
+                        const QByteArray &bytes)
+{
+  QFile fileRewritten (file.fileName ());
+  bool success = fileRewritten.open (QIODevice::WriteOnly | QIODevice::Truncate) &&
+                 (fileRewritten.write (bytes) == bytes.size ());
+  Q_ASSERT (success);
+  Q_UNUSED (success);
+}
+
+void TestDocumentBinary::testDamagedImageIsRejected ()
+{
+  QScopedPointer<Document> document (createDocument ());
+  QTemporaryFile file;
+  QByteArray bytes = saveDocument (*document,
+                                   file);
+
+  // The image section is the first one after the header and the table of the image, settings and three curve sections
+  const int OFFSET_IMAGE = 16 + 5 * 24;
+  bytes.replace (OFFSET_IMAGE, 8, QByteArray (8, 0));
+  writeBytes (file,
+              bytes);
+
+  Document documentOpened (file.fileName ());
+  QVERIFY (!documentOpened.successfulRead ());
+  QCOMPARE (documentOpened.reasonForUnsuccessfulRead (), QString ("Document image could not be decoded"));
+}
+
+void TestDocumentBinary::testRoundTrip ()
+{
+  QScopedPointer<Document> document (createDocument ());
+  QTemporaryFile file;
+  saveDocument (*document,
+                file);
+
+  const Document documentOpened (file.fileName ());
+  QVERIFY (documentOpened.successfulRead ());
+  const Document &documentSaved = *document;
+
+  QCOMPARE (documentOpened.curvesGraphsNames (), documentSaved.curvesGraphsNames ());
+  QCOMPARE (documentOpened.pixmap ().size (), documentSaved.pixmap ().size ());
+
+  // Axis points keep their graph coordinates, and every point keeps its exact screen coordinates in order
+  QStringList curveNames = documentSaved.curvesGraphsNames ();
+  curveNames.prepend (AXIS_CURVE_NAME);
+  QStringList::const_iterator itr;
+  for (itr = curveNames.begin (); itr != curveNames.end (); itr++) {
+
+    const Points points = documentSaved.curveForCurveName (*itr)->points ();
+    const Points pointsOpened = documentOpened.curveForCurveName (*itr)->points ();
+    QCOMPARE (pointsOpened.count (), points.count ());
+
+    for (int index = 0; index < points.count (); index++) {
+      QVERIFY (isIdentical (pointsOpened.at (index).posScreen (), points.at (index).posScreen ()));
+      if (*itr == AXIS_CURVE_NAME) {
+        QVERIFY (isIdentical (pointsOpened.at (index).posGraph (), points.at (index).posGraph ()));
+      }
+    }
+  }
+}
+
+void TestDocumentBinary::testTruncatedFileIsRejected ()
+{
+  QScopedPointer<Document> document (createDocument ());
+  QTemporaryFile file;
+  QByteArray bytes = saveDocument (*document,
+                                   file);
+
+  // Cutting the last point of the last curve leaves a section that runs past the end of the file
+  bytes.chop (8);
+  writeBytes (file,
+              bytes);
+
+  Document documentOpened (file.fileName ());
+  QVERIFY (!documentOpened.successfulRead ());
+  QCOMPARE (documentOpened.reasonForUnsuccessfulRead (), QString ("Document is damaged"));
+}
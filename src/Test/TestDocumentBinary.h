@@ -0,0 +1,20 @@
+#ifndef TEST_DOCUMENT_BINARY_H
+#define TEST_DOCUMENT_BINARY_H
+
+#include <QObject>
+
+/// Unit tests for saving and opening a Document in the binary format of Document::saveDocumentBinary.
+class TestDocumentBinary : public QObject
+{
+  Q_OBJECT
+public:
+  /// Single constructor.
+  explicit TestDocumentBinary(QObject *parent = 0);
+
+private slots:
+  void testDamagedImageIsRejected ();
+  void testRoundTrip ();
+  void testTruncatedFileIsRejected ();
+};
+
+#endif // TEST_DOCUMENT_BINARY_H
@@ -0,0 +1,156 @@
+#include "Curve.h"
+#include "Document.h"
+#include "DocumentJournal.h"
+#include <QImage>
+#include <QScopedPointer>
+#include <QTemporaryFile>
+#include <QtTest/QtTest>
+#include "Test/TestDocumentJournal.h"
+
+const QString CURVE_NAME_SECOND ("Curve2");
+
+TestDocumentJournal::TestDocumentJournal(QObject *parent) :
+  QObject(parent)
+{
+}
+
+static QImage createImage ()
+{
+  QImage image (40, 30, QImage::Format_RGB32);
+  image.fill (Qt::white);
+
+  return image;
+}
+
+// Replayed Points get new identifiers, so they are compared by position, in their order along the Curve
+static QList<QPointF> pointPositions (const Document &document,
+                                      const QString &curveName,
+                                      bool isGraph)
+{
+  QList<QPointF> positions;
+
+  const Points points = document.curveForCurveName (curveName)->points ();
+  Points::const_iterator itr;
+  for (itr = points.begin (); itr != points.end (); itr++) {
+    positions << (isGraph ? itr->posGraph () : itr->posScreen ());
+  }
+
+  return positions;
+}
+
+static void compareDocuments (const Document &documentReplayed,
+                              const Document &document)
+{
+  QCOMPARE (documentReplayed.curvesGraphsNames (), document.curvesGraphsNames ());
+
+  QCOMPARE (pointPositions (documentReplayed, AXIS_CURVE_NAME, false),
+            pointPositions (document, AXIS_CURVE_NAME, false));
+  QCOMPARE (pointPositions (documentReplayed, AXIS_CURVE_NAME, true),
+            pointPositions (document, AXIS_CURVE_NAME, true));
+
+  QStringList curveNames = document.curvesGraphsNames ();
+  QStringList::const_iterator itr;
+  for (itr = curveNames.begin (); itr != curveNames.end (); itr++) {
+    QCOMPARE (pointPositions (documentReplayed, *itr, false),
+              pointPositions (document, *itr, false));
+  }
+}
+
+// Start with axis and graph points, take the snapshot, and then add, move, delete and undo the delete, appending the
+// delta of each edit to the records
+static void editDocument (Document &document,
+                          QList<QByteArray> &records)
+{
+  document.addGraphCurveAtEnd (CURVE_NAME_SECOND);
+  QString curveNameFirst = document.curvesGraphsNames ().first ();
+
+  PointIdentifier identifierAxis, identifierRemoved, identifierAdded, identifierDiscarded, identifier;
+  document.addPointAxis (QPointF (1, 29), QPointF (0, 0), identifierAxis);
+  document.addPointAxis (QPointF (39, 29), QPointF (10, 0), identifier);
+  document.addPointAxis (QPointF (1, 1), QPointF (0, 10), identifier);
+  document.addPointGraph (curveNameFirst, QPointF (5, 6), identifier);
+  document.addPointGraph (curveNameFirst, QPointF (7, 8), identifierRemoved);
+  document.addPointGraph (CURVE_NAME_SECOND, QPointF (9, 10), identifier);
+
+  records << document.journalSnapshot ();
+
+  document.addPointGraph (CURVE_NAME_SECOND, QPointF (11.5, 12.25), identifierAdded);
+  records << document.journalDelta ();
+
+  // Several Points that are added between two records are replayed in the same order along their Curve
+  for (int index = 0; index < 16; index++) {
+    document.addPointGraph (CURVE_NAME_SECOND, QPointF (index, 15 - index), identifier);
+  }
+  records << document.journalDelta ();
+
+  document.movePoint (identifierAdded, QPointF (-0.5, 0.75));
+  document.movePoint (identifierAxis, QPointF (0.125, -0.25));
+  records << document.journalDelta ();
+
+  // The discarded Point is added and removed between two records, so it leaves no trace
+  document.removePointGraph (identifierRemoved);
+  document.addPointGraph (curveNameFirst, QPointF (20, 20), identifierDiscarded);
+  document.removePointGraph (identifierDiscarded);
+  records << document.journalDelta ();
+
+  // Undo restores the removed Point with its original identifier
+  document.addPointGraph (curveNameFirst, QPointF (7, 8), identifierRemoved);
+  records << document.journalDelta ();
+}
+
+void TestDocumentJournal::testReplayFromFile ()
+{
+  Document document (createImage ());
+  QList<QByteArray> records;
+  editDocument (document,
+                records);
+
+  // The header of the journal refers to the saved Document file
+  QTemporaryFile file;
+  QVERIFY (file.open ());
+  document.saveDocumentBinary (file);
+  file.close ();
+
+  QScopedPointer<DocumentJournal> journal (new DocumentJournal (file.fileName (),
+                                                                records.first (),
+                                                                0));
+  for (int index = 1; index < records.count (); index++) {
+    journal->append (records.at (index));
+  }
+
+  // The snapshot is written in the background, and the records appended meanwhile are carried over once it is done
+  QList<QByteArray> recordsRead;
+  QTRY_VERIFY (DocumentJournal::readRecords (file.fileName (), recordsRead) &&
+               (recordsRead.count () == records.count ()));
+  QCOMPARE (recordsRead, records);
+
+  Document documentReplayed (createImage ());
+  QVERIFY (documentReplayed.replayJournal (recordsRead));
+  compareDocuments (documentReplayed,
+                    document);
+
+  // Deleting the journal, as saving or closing the Document does, removes its file
+  journal.reset ();
+  QVERIFY (!QFile::exists (DocumentJournal::fileNameForDocument (file.fileName ())));
+}
+
+void TestDocumentJournal::testReplayRecords ()
+{
+  Document document (createImage ());
+  QList<QByteArray> records;
+  editDocument (document,
+                records);
+
+  Document documentReplayed (createImage ());
+  QVERIFY (documentReplayed.replayJournal (records));
+  QVERIFY (documentReplayed.isModified ());
+  compareDocuments (documentReplayed,
+                    document);
+
+  // A record that was cut short stops the replay
+  QList<QByteArray> recordsDamaged = records;
+  recordsDamaged.last ().chop (4);
+
+  Document documentDamaged (createImage ());
+  QVERIFY (!documentDamaged.replayJournal (recordsDamaged));
+}
@@ -0,0 +1,19 @@
+#ifndef TEST_DOCUMENT_JOURNAL_H
+#define TEST_DOCUMENT_JOURNAL_H
+
+#include <QObject>
+
+/// Unit tests for recovering a Document from the snapshot and delta records of a DocumentJournal.
+class TestDocumentJournal : public QObject
+{
+  Q_OBJECT
+public:
+  /// Single constructor.
+  explicit TestDocumentJournal(QObject *parent = 0);
+
+private slots:
+  void testReplayFromFile ();
+  void testReplayRecords ();
+};
+
+#endif // TEST_DOCUMENT_JOURNAL_H
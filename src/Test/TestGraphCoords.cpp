@@ -3,8 +3,6 @@
 #include <QtTest/QtTest>
 #include "Test/TestGraphCoords.h"
 
-QTEST_MAIN (TestGraphCoords)
-
 TestGraphCoords::TestGraphCoords(QObject *parent) :
   QObject(parent)
 {
@@ -17,11 +15,7 @@ void TestGraphCoords::cleanupTestCase ()
 
 void TestGraphCoords::initTestCase ()
 {
-  const bool DEBUG_FLAG = false;
-  initializeLogging ("engauge_test",
-                     "engauge_test.log",
-                     DEBUG_FLAG);
-
+  // Logging is initialized by TestMain
   MainWindow w;
   w.show ();
 }
@@ -0,0 +1,39 @@
+#include "Logger.h"
+#include <QApplication>
+#include <QtTest/QtTest>
+#include "Test/TestDocumentBinary.h"
+#include "Test/TestDocumentJournal.h"
+#include "Test/TestGraphCoords.h"
+#include "Test/TestMimePointsParser.h"
+#include "Test/TestPointIdentifiersPacked.h"
+
+// Each test class is run in turn, in place of QTEST_MAIN which allows only one test class per executable
+int main (int argc, char *argv[])
+{
+  QApplication app (argc, argv);
+
+  // Logging is set up once here, since the classes under test log through mainCat
+  const bool DEBUG_FLAG = false;
+  initializeLogging ("engauge_test",
+                     "engauge_test.log",
+                     DEBUG_FLAG);
+
+  int status = 0;
+
+  TestDocumentBinary testDocumentBinary;
+  status |= QTest::qExec (&testDocumentBinary, argc, argv);
+
+  TestDocumentJournal testDocumentJournal;
+  status |= QTest::qExec (&testDocumentJournal, argc, argv);
+
+  TestGraphCoords testGraphCoords;
+  status |= QTest::qExec (&testGraphCoords, argc, argv);
+
+  TestMimePointsParser testMimePointsParser;
+  status |= QTest::qExec (&testMimePointsParser, argc, argv);
+
+  TestPointIdentifiersPacked testPointIdentifiersPacked;
+  status |= QTest::qExec (&testPointIdentifiersPacked, argc, argv);
+
+  return status;
+}
@@ -0,0 +1,104 @@
+#include <cstring>
+#include "MimePointsParser.h"
+#include <QStringList>
+#include <QtTest/QtTest>
+#include "Test/TestMimePointsParser.h"
+
+TestMimePointsParser::TestMimePointsParser(QObject *parent) :
+  QObject(parent)
+{
+}
+
+// Parse each value as the x coordinate of its own point, and compare it bit for bit with QByteArray::toDouble
+static void compareWithToDouble (const QStringList &values)
+{
+  QByteArray csv;
+  QStringList::const_iterator itr;
+  for (itr = values.begin (); itr != values.end (); itr++) {
+    csv += itr->toLatin1 () + "\t0\n";
+  }
+
+  MimePointsParser parser;
+  MimePointsCurves curves;
+  QVERIFY (parser.parse (csv, curves));
+  QCOMPARE (curves.count (), 1);
+  QCOMPARE (curves.first ().x.count (), values.count ());
+
+  for (int index = 0; index < values.count (); index++) {
+
+    bool ok;
+    double expected = values.at (index).toLatin1 ().toDouble (&ok);
+    QVERIFY (ok);
+
+    double actual = curves.first ().x.at (index);
+    QVERIFY2 (memcmp (&actual, &expected, sizeof (double)) == 0,
+              values.at (index).toLatin1 ().data ());
+  }
+}
+
+void TestMimePointsParser::testCurvesWithHeaders ()
+{
+  QByteArray csv ("X\tCurve1\r\n"
+                  "1\t2\r\n"
+                  "3.5\t-4.25\r\n"
+                  "\r\n"
+                  "X\tCurve2\n"
+                  "-0.5\t1e3\n");
+
+  MimePointsParser parser;
+  MimePointsCurves curves;
+  QVERIFY (parser.parse (csv, curves));
+
+  QCOMPARE (curves.count (), 2);
+  QCOMPARE (curves.at (0).curveName, QString ("Curve1"));
+  QCOMPARE (curves.at (0).x, QVector<double> () << 1 << 3.5);
+  QCOMPARE (curves.at (0).y, QVector<double> () << 2 << -4.25);
+  QCOMPARE (curves.at (1).curveName, QString ("Curve2"));
+  QCOMPARE (curves.at (1).x, QVector<double> () << -0.5);
+  QCOMPARE (curves.at (1).y, QVector<double> () << 1000);
+}
+
+void TestMimePointsParser::testFastPathMatchesToDouble ()
+{
+  // Short mantissas and small exponents, as ExportToClipboard writes them
+  compareWithToDouble (QStringList () << "0" << "-0" << "+7" << "42" << "0.1" << "-0.3" << "123.456"
+                                      << "1e22" << "1e-22" << "2.5E+3" << "-6.02e-5" << "0.000001"
+                                      << "9007199254740992");
+}
+
+void TestMimePointsParser::testInvalidLineLeavesCurvesUnchanged ()
+{
+  MimePointsParser parser;
+  MimePointsCurves curves;
+  QVERIFY (parser.parse (QByteArray ("1\t2\n"), curves));
+
+  QVERIFY (!parser.parse (QByteArray ("1\t2\nabc\t3\n"), curves));
+  QVERIFY (!parser.parse (QByteArray ("1\t2\t3\n"), curves));
+  QVERIFY (!parser.parse (QByteArray ("1e\t2\n"), curves));
+  QVERIFY (!parser.parse (QByteArray ("1\n"), curves));
+
+  QCOMPARE (curves.count (), 1);
+  QCOMPARE (curves.first ().x, QVector<double> () << 1);
+}
+
+void TestMimePointsParser::testSlowPathMatchesToDouble ()
+{
+  // Mantissas with more than 19 digits or above 2^53, and exponents beyond the exact powers of ten
+  compareWithToDouble (QStringList () << "0.30000000000000004" << "9007199254740993"
+                                      << "123456789012345678901234567890" << "1.7976931348623157e308"
+                                      << "1e23" << "1e-23"
+                                      << "3.14159265358979323846264338327950288");
+}
+
+void TestMimePointsParser::testTextWithoutHeader ()
+{
+  // As copied from a spreadsheet, with no final line break
+  MimePointsParser parser;
+  MimePointsCurves curves;
+  QVERIFY (parser.parse (QByteArray ("1\t10\n2\t20"), curves));
+
+  QCOMPARE (curves.count (), 1);
+  QVERIFY (curves.first ().curveName.isEmpty ());
+  QCOMPARE (curves.first ().x, QVector<double> () << 1 << 2);
+  QCOMPARE (curves.first ().y, QVector<double> () << 10 << 20);
+}
@@ -0,0 +1,22 @@
+#ifndef TEST_MIME_POINTS_PARSER_H
+#define TEST_MIME_POINTS_PARSER_H
+
+#include <QObject>
+
+/// Unit tests for MimePointsParser, which parses pasted clipboard text.
+class TestMimePointsParser : public QObject
+{
+  Q_OBJECT
+public:
+  /// Single constructor.
+  explicit TestMimePointsParser(QObject *parent = 0);
+
+private slots:
+  void testCurvesWithHeaders ();
+  void testFastPathMatchesToDouble ();
+  void testInvalidLineLeavesCurvesUnchanged ();
+  void testSlowPathMatchesToDouble ();
+  void testTextWithoutHeader ();
+};
+
+#endif // TEST_MIME_POINTS_PARSER_H
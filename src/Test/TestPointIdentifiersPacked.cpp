@@ -0,0 +1,100 @@
+#include <algorithm>
+#include "Point.h"
+#include "PointIdentifiersPacked.h"
+#include <QtTest/QtTest>
+#include "Test/TestPointIdentifiersPacked.h"
+
+const int NUM_CONSECUTIVE = 1000;
+
+TestPointIdentifiersPacked::TestPointIdentifiersPacked(QObject *parent) :
+  QObject(parent)
+{
+}
+
+void TestPointIdentifiersPacked::testCompressedRoundTrip ()
+{
+  quint64 serialFirst = Point::reserveIdentifierSerials (NUM_CONSECUTIVE);
+
+  PointIdentifierList identifiers;
+  for (int i = 0; i < NUM_CONSECUTIVE; i++) {
+    identifiers << Point::identifierFromSerial ("Curve1", serialFirst + i);
+  }
+
+  PointIdentifiersPacked packed (identifiers);
+  PointIdentifiersPacked packedCompressed (identifiers);
+  packedCompressed.compress ();
+
+  QVERIFY (packedCompressed.isCompressed ());
+  QCOMPARE (packedCompressed.count (), NUM_CONSECUTIVE);
+  QCOMPARE (packedCompressed.identifiers (), identifiers);
+  QVERIFY (packedCompressed == packed);
+}
+
+void TestPointIdentifiersPacked::testConsecutiveIdentifiersCostOneByte ()
+{
+  quint64 serialFirst = Point::reserveIdentifierSerials (NUM_CONSECUTIVE);
+
+  PointIdentifierList identifiers;
+  for (int i = 0; i < NUM_CONSECUTIVE; i++) {
+    identifiers << Point::identifierFromSerial ("Curve1", serialFirst + i);
+  }
+
+  // Only the first delta, which is from zero, takes more than one byte
+  PointIdentifiersPacked packed (identifiers);
+  QVERIFY (packed.byteCount () < (int) sizeof (PointIdentifiersPacked) + NUM_CONSECUTIVE + 10);
+  QCOMPARE (packed.identifiers (), identifiers);
+}
+
+void TestPointIdentifiersPacked::testEmpty ()
+{
+  PointIdentifiersPacked packed ((PointIdentifierList ()));
+
+  QCOMPARE (packed.count (), 0);
+  QVERIFY (packed.identifiers ().isEmpty ());
+  QVERIFY (packed == PointIdentifiersPacked ());
+}
+
+void TestPointIdentifiersPacked::testEquality ()
+{
+  PointIdentifierList identifiers;
+  identifiers << 5 << 300 << 70000;
+
+  PointIdentifierList identifiersReversed;
+  identifiersReversed << 70000 << 300 << 5;
+
+  PointIdentifierList identifiersOther;
+  identifiersOther << 5 << 300 << 70001;
+
+  QVERIFY (PointIdentifiersPacked (identifiers) == PointIdentifiersPacked (identifiersReversed));
+  QVERIFY (!(PointIdentifiersPacked (identifiers) == PointIdentifiersPacked (identifiersOther)));
+}
+
+void TestPointIdentifiersPacked::testLargeDeltasRoundTrip ()
+{
+  // Deltas that need every number of varint bytes, up to the full 64 bits of an identifier
+  PointIdentifierList identifiers;
+  identifiers << 1
+              << 128
+              << (((quint64) 1) << 21)
+              << ((((quint64) 1) << 35) + 7)
+              << ((((quint64) 1) << 48) + 1)
+              << ~((quint64) 0);
+  std::sort (identifiers.begin (), identifiers.end ());
+
+  PointIdentifiersPacked packed (identifiers);
+  QCOMPARE (packed.count (), identifiers.count ());
+  QCOMPARE (packed.identifiers (), identifiers);
+}
+
+void TestPointIdentifiersPacked::testUnsortedWithDuplicatesRoundTrip ()
+{
+  PointIdentifierList identifiers;
+  identifiers << 900 << 3 << 900 << 17 << 3 << 1000000;
+
+  PointIdentifierList expected;
+  expected << 3 << 17 << 900 << 1000000;
+
+  PointIdentifiersPacked packed (identifiers);
+  QCOMPARE (packed.count (), expected.count ());
+  QCOMPARE (packed.identifiers (), expected);
+}
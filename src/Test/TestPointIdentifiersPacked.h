@@ -0,0 +1,23 @@
+#ifndef TEST_POINT_IDENTIFIERS_PACKED_H
+#define TEST_POINT_IDENTIFIERS_PACKED_H
+
+#include <QObject>
+
+/// Unit tests for the variable-length delta encoding of PointIdentifiersPacked.
+class TestPointIdentifiersPacked : public QObject
+{
+  Q_OBJECT
+public:
+  /// Single constructor.
+  explicit TestPointIdentifiersPacked(QObject *parent = 0);
+
+private slots:
+  void testCompressedRoundTrip ();
+  void testConsecutiveIdentifiersCostOneByte ();
+  void testEmpty ();
+  void testEquality ();
+  void testLargeDeltasRoundTrip ();
+  void testUnsortedWithDuplicatesRoundTrip ();
+};
+
+#endif // TEST_POINT_IDENTIFIERS_PACKED_H
@@ -1,18 +1,24 @@
 #include "CallbackUpdateTransform.h"
 #include "Document.h"
 #include "Logger.h"
+#include <QAtomicInteger>
 #include <qmath.h>
 #include <QtGlobal>
 #include "Transformation.h"
+#include "TransformationPipelineAbstractBase.h"
 
 /// Max number of significant digits. Number of pixels in each direction should just fit into this
 /// number of characters.
 const int PRECISION_DIGITS = 4;
 
-const double PI = 3.1415926535;
+// Last version handed out by updateCachedMatrices. This is shared by all Transformation objects so versions from
+// different objects never collide
+static QAtomicInteger<quint64> versionLast (0);
 
 Transformation::Transformation() :
-  m_transformIsDefined (false)
+  m_transformIsDefined (false),
+  m_pipeline (&TransformationPipelineAbstractBase::select (m_modelCoords)),
+  m_version (0)
 {
 }
 
@@ -20,6 +26,10 @@ Transformation &Transformation::operator=(const Transformation &other)
 {
   m_transformIsDefined = other.transformIsDefined();
   m_transform = other.transformMatrix ();
+  updateCachedMatrices ();
+  m_modelCoords = other.m_modelCoords;
+  m_pipeline = other.m_pipeline;
+  m_version = other.version ();
   m_xGraphRange = other.xGraphRange ();
   m_yGraphRange = other.yGraphRange ();
 
@@ -37,41 +47,10 @@ bool Transformation::operator!=(const Transformation &other)
 QPointF Transformation::cartesianFromCartesianOrPolar (const DocumentModelCoords &modelCoords,
                                                        const QPointF &posGraphIn)
 {
-  // Initialize assuming input coordinates are already cartesian
-  QPointF posGraphCartesian = posGraphIn;
-
-  if (modelCoords.coordsType() == COORDS_TYPE_POLAR) {
-
-    // Input coordinates are polar so convert them
-    double angleRadians;
-    switch (modelCoords.coordThetaUnits())
-    {
-      case COORD_THETA_UNITS_DEGREES:
-      case COORD_THETA_UNITS_DEGREES_MINUTES:
-      case COORD_THETA_UNITS_DEGREES_MINUTES_SECONDS:
-        angleRadians = posGraphIn.x () * PI / 180.0;
-        break;
-
-      case COORD_THETA_UNITS_GRADIANS:
-        angleRadians = posGraphIn.x () * PI / 200.0;
-        break;
-
-      case COORD_THETA_UNITS_RADIANS:
-        angleRadians = posGraphIn.x ();
-        break;
-
-      case COORD_THETA_UNITS_TURNS:
-        angleRadians = posGraphIn.x () * 2.0 * PI;
-        break;
-
-      default:
-        Q_ASSERT (false);
-    }
-
-    double radius = posGraphIn.y ();
-    posGraphCartesian.setX (radius * cos (angleRadians));
-    posGraphCartesian.setY (radius * sin (angleRadians));
-  }
+  QPointF posGraphCartesian;
+  TransformationPipelineAbstractBase::select (modelCoords).cartesianFromCartesianOrPolarMany (1,
+                                                                                               &posGraphIn,
+                                                                                               &posGraphCartesian);
 
   return posGraphCartesian;
 }
@@ -79,41 +58,10 @@ QPointF Transformation::cartesianFromCartesianOrPolar (const DocumentModelCoords
 QPointF Transformation::cartesianOrPolarFromCartesian (const DocumentModelCoords &modelCoords,
                                                        const QPointF &posGraphIn)
 {
-  // Initialize assuming output coordinates are to be cartesian
-  QPointF posGraphCartesianOrPolar = posGraphIn;
-
-  if (modelCoords.coordsType() == COORDS_TYPE_POLAR) {
-
-    // Output coordinates are to be polar so convert them
-    double angleRadians = atan2 (posGraphIn.y (),
-                                 posGraphIn.x ());
-    switch (modelCoords.coordThetaUnits())
-    {
-      case COORD_THETA_UNITS_DEGREES:
-      case COORD_THETA_UNITS_DEGREES_MINUTES:
-      case COORD_THETA_UNITS_DEGREES_MINUTES_SECONDS:
-        posGraphCartesianOrPolar.setX (angleRadians * 180.0 / PI);
-        break;
-
-      case COORD_THETA_UNITS_GRADIANS:
-        posGraphCartesianOrPolar.setX (angleRadians * 200.0 / PI);
-        break;
-
-      case COORD_THETA_UNITS_RADIANS:
-        posGraphCartesianOrPolar.setX (angleRadians);
-        break;
-
-      case COORD_THETA_UNITS_TURNS:
-        posGraphCartesianOrPolar.setX (angleRadians / 2.0 / PI);
-        break;
-
-      default:
-        Q_ASSERT (false);
-    }
-
-    double radius = qSqrt (posGraphIn.x () * posGraphIn.x () + posGraphIn.y () * posGraphIn.y ());
-    posGraphCartesianOrPolar.setY (radius);
-  }
+  QPointF posGraphCartesianOrPolar;
+  TransformationPipelineAbstractBase::select (modelCoords).cartesianOrPolarFromCartesianMany (1,
+                                                                                               &posGraphIn,
+                                                                                               &posGraphCartesianOrPolar);
 
   return posGraphCartesianOrPolar;
 }
@@ -144,19 +92,15 @@ void Transformation::coordTextForStatusBar (QPointF cursorScreen,
     if (m_transformIsDefined) {
 
       // For resolution we compute graph coords for cursorScreen, and then for cursorScreen plus a delta
-      QPointF cursorScreenDelta (cursorScreen.x () + X_DELTA_PIXELS,
-                                 cursorScreen.y () + Y_DELTA_PIXELS);
+      QPointF cursors [2] = {cursorScreen,
+                             QPointF (cursorScreen.x () + X_DELTA_PIXELS,
+                                      cursorScreen.y () + Y_DELTA_PIXELS)};
 
-      // Screen to graph
-      QPointF cursorGraph, cursorGraphDelta;
-      transform (cursorScreen, cursorGraph);
-      transform (cursorScreenDelta, cursorGraphDelta);
-
-      // Convert to polar if appropriate
-      cursorGraph = cartesianOrPolarFromCartesian (m_modelCoords,
-                                                   cursorGraph);
-      cursorGraphDelta = cartesianOrPolarFromCartesian (m_modelCoords,
-                                                        cursorGraphDelta);
+      // Screen to graph, and then to polar if appropriate
+      transformMany (2, cursors, cursors);
+      m_pipeline->cartesianOrPolarFromCartesianMany (2, cursors, cursors);
+      const QPointF &cursorGraph = cursors [0];
+      const QPointF &cursorGraphDelta = cursors [1];
 
       // Compute graph coordinates at cursor
       double xGraph = cursorGraph.x ();
@@ -207,6 +151,35 @@ void Transformation::identity()
 
   if (m_transformIsDefined) {
     m_transform = cb.transform ();
+    updateCachedMatrices ();
+  }
+}
+
+void Transformation::mapMany (const QTransform &matrix,
+                              int count,
+                              const QPointF coordsIn [],
+                              QPointF coordsOut []) const
+{
+  if (matrix.type () <= QTransform::TxShear) {
+
+    // Affine, so the coefficients are hoisted out of the loop and there is no perspective division. This is the
+    // usual case since the axis points define an affine transformation
+    double m11 = matrix.m11 (), m12 = matrix.m12 ();
+    double m21 = matrix.m21 (), m22 = matrix.m22 ();
+    double dx = matrix.dx (), dy = matrix.dy ();
+
+    for (int i = 0; i < count; i++) {
+      double x = coordsIn [i].x ();
+      double y = coordsIn [i].y ();
+      coordsOut [i] = QPointF (m11 * x + m21 * y + dx,
+                               m12 * x + m22 * y + dy);
+    }
+
+  } else {
+
+    for (int i = 0; i < count; i++) {
+      coordsOut [i] = matrix.map (coordsIn [i]);
+    }
   }
 }
 
@@ -224,7 +197,7 @@ void Transformation::transform (const QPointF &coordScreen,
 {
   Q_ASSERT (m_transformIsDefined);
 
-  coordGraph = m_transform.transposed ().map (coordScreen);
+  coordGraph = m_transformForward.map (coordScreen);
 }
 
 void Transformation::transformInverse (const QPointF &coordGraph,
@@ -232,7 +205,63 @@ void Transformation::transformInverse (const QPointF &coordGraph,
 {
   Q_ASSERT (m_transformIsDefined);
 
-  coordScreen = m_transform.inverted ().transposed ().map (coordGraph);
+  coordScreen = m_transformInverse.map (coordGraph);
+}
+
+void Transformation::transformInverseMany (int count,
+                                           const QPointF coordsGraph [],
+                                           QPointF coordsScreen []) const
+{
+  Q_ASSERT (m_transformIsDefined);
+
+  mapMany (m_transformInverse,
+           count,
+           coordsGraph,
+           coordsScreen);
+}
+
+void Transformation::transformMany (int count,
+                                    const QPointF coordsScreen [],
+                                    QPointF coordsGraph []) const
+{
+  Q_ASSERT (m_transformIsDefined);
+
+  mapMany (m_transformForward,
+           count,
+           coordsScreen,
+           coordsGraph);
+}
+
+void Transformation::transformManyColumns (int count,
+                                           const double xScreen [],
+                                           const double yScreen [],
+                                           double xGraph [],
+                                           double yGraph []) const
+{
+  Q_ASSERT (m_transformIsDefined);
+
+  if (m_transformForward.type () <= QTransform::TxShear) {
+
+    double m11 = m_transformForward.m11 (), m12 = m_transformForward.m12 ();
+    double m21 = m_transformForward.m21 (), m22 = m_transformForward.m22 ();
+    double dx = m_transformForward.dx (), dy = m_transformForward.dy ();
+
+    for (int i = 0; i < count; i++) {
+      double x = xScreen [i];
+      double y = yScreen [i];
+      xGraph [i] = m11 * x + m21 * y + dx;
+      yGraph [i] = m12 * x + m22 * y + dy;
+    }
+
+  } else {
+
+    for (int i = 0; i < count; i++) {
+      QPointF posGraph = m_transformForward.map (QPointF (xScreen [i],
+                                                          yScreen [i]));
+      xGraph [i] = posGraph.x ();
+      yGraph [i] = posGraph.y ();
+    }
+  }
 }
 
 QTransform Transformation::transformMatrix () const
@@ -252,25 +281,42 @@ void Transformation::update (bool fileIsLoaded,
   } else {
 
     m_modelCoords = cmdMediator.document().modelCoords();
+    m_pipeline = &TransformationPipelineAbstractBase::select (m_modelCoords);
 
     CallbackUpdateTransform ftor (m_modelCoords);
 
-    Functor2wRet<const QString &, const Point&, CallbackSearchReturn> ftorWithCallback = functor_ret (ftor,
-                                                                                                      &CallbackUpdateTransform::callback);
-    cmdMediator.iterateThroughCurvePointsAxes (ftorWithCallback);
+    cmdMediator.iterateThroughCurvePointsAxes (ftor);
+
+    bool transformWasDefined = m_transformIsDefined;
 
     m_transformIsDefined = ftor.transformIsDefined ();
     m_xGraphRange = ftor.xGraphRange ();
     m_yGraphRange = ftor.yGraphRange ();
 
-    if (m_transformIsDefined) {
+    // The transform is actually calculated by the callback. This runs after every command, so the matrices and the
+    // version are only refreshed when the transform really changed. Otherwise the lazily computed graph coordinates
+    // in the curves would be thrown away for nothing
+    if (m_transformIsDefined &&
+        (!transformWasDefined || (m_transform != ftor.transform ()))) {
 
-      // The transform is actually calculated by the callback
       m_transform = ftor.transform ();
+      updateCachedMatrices ();
     }
   }
 }
 
+void Transformation::updateCachedMatrices ()
+{
+  m_transformForward = m_transform.transposed ();
+  m_transformInverse = m_transform.inverted ().transposed ();
+  m_version = versionLast.fetchAndAddOrdered (1) + 1;
+}
+
+quint64 Transformation::version () const
+{
+  return m_version;
+}
+
 double Transformation::xGraphRange() const
 {
   return m_xGraphRange;
@@ -7,6 +7,8 @@
 #include <QString>
 #include <QTransform>
 
+class TransformationPipelineAbstractBase;
+
 /// Affine transformation between screen and graph coordinates, based on digitized axis points
 class Transformation
 {
@@ -23,11 +25,13 @@ public:
   /// Inequality operator. This is marked as defined.
   bool operator!=(const Transformation &other);
 
-  /// Output cartesian coordinates from input cartesian or polar coordinates. This is static for easier use externally
+  /// Output cartesian coordinates from input cartesian or polar coordinates. This is static for easier use externally.
+  /// Bulk conversions should use TransformationPipelineAbstractBase::select instead
   static QPointF cartesianFromCartesianOrPolar (const DocumentModelCoords &modelCoords,
                                                 const QPointF &posGraphIn);
 
-  /// Output cartesian or polar coordinates from input cartesian coordinates. This is static for easier use externally
+  /// Output cartesian or polar coordinates from input cartesian coordinates. This is static for easier use externally.
+  /// Bulk conversions should use TransformationPipelineAbstractBase::select instead
   static QPointF cartesianOrPolarFromCartesian (const DocumentModelCoords &modelCoords,
                                                 const QPointF &posGraphIn);
 
@@ -48,6 +52,26 @@ public:
   void transformInverse (const QPointF &coordGraph,
                          QPointF &coordScreen) const;
 
+  /// Batch version of transformInverse for count contiguous points, which is much faster than calling
+  /// transformInverse once per point. The input and output arrays may be the same
+  void transformInverseMany (int count,
+                             const QPointF coordsGraph [],
+                             QPointF coordsScreen []) const;
+
+  /// Batch version of transform for count contiguous points, which is much faster than calling transform once per
+  /// point. The input and output arrays may be the same
+  void transformMany (int count,
+                      const QPointF coordsScreen [],
+                      QPointF coordsGraph []) const;
+
+  /// Column version of transformMany, for points stored as separate x and y arrays. The affine loop reads and writes
+  /// plain doubles with unit stride, so the compiler can vectorize it. The output arrays must not overlap the inputs
+  void transformManyColumns (int count,
+                             const double xScreen [],
+                             const double yScreen [],
+                             double xGraph [],
+                             double yGraph []) const;
+
   /// Get method for copying only, for the transform matrix.
   QTransform transformMatrix () const;
 
@@ -55,6 +79,10 @@ public:
   void update (bool fileIsLoaded,
                const CmdMediator &cmdMediator);
 
+  /// Version of the transform matrix. Each change to the matrix gets a new, larger version, and copies share the
+  /// version of their source, so equal versions mean equal matrices. Zero is never used for a defined transform
+  quint64 version () const;
+
   /// Get method for copying only, for x epsilon.
   double xGraphRange() const;
 
@@ -62,14 +90,33 @@ public:
   double yGraphRange() const;
 
 private:
+  // Apply one of the cached matrices to count points, using the affine coefficients directly when possible
+  void mapMany (const QTransform &matrix,
+                int count,
+                const QPointF coordsIn [],
+                QPointF coordsOut []) const;
+
+  // Recompute the cached matrices after m_transform changes, and move to a new version
+  void updateCachedMatrices ();
+
   bool m_transformIsDefined;
 
   // Transform between cartesian screen coordinates and cartesian graph coordinates
   QTransform m_transform;
 
+  // Matrices that are applied to points, derived from m_transform once when it changes rather than for every point
+  QTransform m_transformForward; // Screen to graph
+  QTransform m_transformInverse; // Graph to screen
+
   // Coordinates information from last time the transform was updated. Only defined if  m_transformIsDefined is true
   DocumentModelCoords m_modelCoords;
 
+  // Cartesian/polar conversion selected when m_modelCoords changes. This is shared so it is never deleted
+  const TransformationPipelineAbstractBase *m_pipeline;
+
+  // See version()
+  quint64 m_version;
+
   // No need to display values like 1E-17 when it is insignificant relative to the range
   double roundOffSmallValues (double value, double range);
 
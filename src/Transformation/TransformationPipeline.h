@@ -0,0 +1,90 @@
+#ifndef TRANSFORMATION_PIPELINE_H
+#define TRANSFORMATION_PIPELINE_H
+
+#include "CoordsType.h"
+#include "CoordThetaUnits.h"
+#include <qmath.h>
+#include "TransformationPipelineAbstractBase.h"
+
+/// Pipeline for one combination of coordinates type and theta units. The template parameters are constants, so the
+/// compiler folds the tests on them away and each instantiation ends up with a branch-free loop
+template <CoordsType coordsType, CoordThetaUnits coordThetaUnits>
+class TransformationPipeline : public TransformationPipelineAbstractBase
+{
+public:
+  /// Single constructor.
+  TransformationPipeline() {}
+
+  virtual void cartesianFromCartesianOrPolarMany (int count,
+                                                  const QPointF posGraphIn [],
+                                                  QPointF posGraphOut []) const
+  {
+    if (coordsType == COORDS_TYPE_CARTESIAN) {
+
+      copyMany (count, posGraphIn, posGraphOut);
+
+    } else {
+
+      double radiansPerUnit = radiansPerThetaUnit ();
+      for (int i = 0; i < count; i++) {
+        double angleRadians = posGraphIn [i].x () * radiansPerUnit;
+        double radius = posGraphIn [i].y ();
+        posGraphOut [i] = QPointF (radius * cos (angleRadians),
+                                   radius * sin (angleRadians));
+      }
+    }
+  }
+
+  virtual void cartesianOrPolarFromCartesianMany (int count,
+                                                  const QPointF posGraphIn [],
+                                                  QPointF posGraphOut []) const
+  {
+    if (coordsType == COORDS_TYPE_CARTESIAN) {
+
+      copyMany (count, posGraphIn, posGraphOut);
+
+    } else {
+
+      double thetaUnitsPerRadian = 1.0 / radiansPerThetaUnit ();
+      for (int i = 0; i < count; i++) {
+        double x = posGraphIn [i].x ();
+        double y = posGraphIn [i].y ();
+        posGraphOut [i] = QPointF (atan2 (y, x) * thetaUnitsPerRadian,
+                                   qSqrt (x * x + y * y));
+      }
+    }
+  }
+
+private:
+  void copyMany (int count,
+                 const QPointF posGraphIn [],
+                 QPointF posGraphOut []) const
+  {
+    if (posGraphIn != posGraphOut) {
+      for (int i = 0; i < count; i++) {
+        posGraphOut [i] = posGraphIn [i];
+      }
+    }
+  }
+
+  // Resolved at compile time since coordThetaUnits is a template parameter
+  static double radiansPerThetaUnit ()
+  {
+    switch (coordThetaUnits) {
+      case COORD_THETA_UNITS_GRADIANS:
+        return M_PI / 200.0;
+
+      case COORD_THETA_UNITS_RADIANS:
+        return 1.0;
+
+      case COORD_THETA_UNITS_TURNS:
+        return 2.0 * M_PI;
+
+      default:
+        // Degrees, with or without minutes and seconds, which only affect formatting
+        return M_PI / 180.0;
+    }
+  }
+};
+
+#endif // TRANSFORMATION_PIPELINE_H
@@ -0,0 +1,47 @@
+#include "DocumentModelCoords.h"
+#include "TransformationPipeline.h"
+#include "TransformationPipelineAbstractBase.h"
+
+TransformationPipelineAbstractBase::TransformationPipelineAbstractBase()
+{
+}
+
+TransformationPipelineAbstractBase::~TransformationPipelineAbstractBase()
+{
+}
+
+const TransformationPipelineAbstractBase &TransformationPipelineAbstractBase::select (const DocumentModelCoords &modelCoords)
+{
+  // One shared instance per combination. Theta units do not matter for cartesian coordinates. The degrees variants
+  // differ only in formatting, so they share the degrees pipeline
+  static const TransformationPipeline<COORDS_TYPE_CARTESIAN, COORD_THETA_UNITS_DEGREES> pipelineCartesian;
+  static const TransformationPipeline<COORDS_TYPE_POLAR, COORD_THETA_UNITS_DEGREES> pipelinePolarDegrees;
+  static const TransformationPipeline<COORDS_TYPE_POLAR, COORD_THETA_UNITS_GRADIANS> pipelinePolarGradians;
+  static const TransformationPipeline<COORDS_TYPE_POLAR, COORD_THETA_UNITS_RADIANS> pipelinePolarRadians;
+  static const TransformationPipeline<COORDS_TYPE_POLAR, COORD_THETA_UNITS_TURNS> pipelinePolarTurns;
+
+  if (modelCoords.coordsType () == COORDS_TYPE_CARTESIAN) {
+    return pipelineCartesian;
+  }
+
+  switch (modelCoords.coordThetaUnits ()) {
+    case COORD_THETA_UNITS_DEGREES:
+    case COORD_THETA_UNITS_DEGREES_MINUTES:
+    case COORD_THETA_UNITS_DEGREES_MINUTES_SECONDS:
+      return pipelinePolarDegrees;
+
+    case COORD_THETA_UNITS_GRADIANS:
+      return pipelinePolarGradians;
+
+    case COORD_THETA_UNITS_RADIANS:
+      return pipelinePolarRadians;
+
+    case COORD_THETA_UNITS_TURNS:
+      return pipelinePolarTurns;
+
+    default:
+      Q_ASSERT (false);
+  }
+
+  return pipelinePolarDegrees;
+}
@@ -0,0 +1,35 @@
+#ifndef TRANSFORMATION_PIPELINE_ABSTRACT_BASE_H
+#define TRANSFORMATION_PIPELINE_ABSTRACT_BASE_H
+
+#include <QPointF>
+
+class DocumentModelCoords;
+
+/// Conversion of graph coordinates between cartesian and the cartesian or polar coordinates of the document. There is
+/// one subclass for each combination of coordinates type and theta units, so the choice is made once per
+/// DocumentModelCoords rather than once per point, and the per-point loops in the subclasses have no branching
+class TransformationPipelineAbstractBase
+{
+public:
+  /// Single constructor.
+  TransformationPipelineAbstractBase();
+  virtual ~TransformationPipelineAbstractBase();
+
+  /// Output cartesian coordinates from input cartesian or polar coordinates, for count contiguous points. The input
+  /// and output arrays may be the same
+  virtual void cartesianFromCartesianOrPolarMany (int count,
+                                                  const QPointF posGraphIn [],
+                                                  QPointF posGraphOut []) const = 0;
+
+  /// Output cartesian or polar coordinates from input cartesian coordinates, for count contiguous points. The input
+  /// and output arrays may be the same
+  virtual void cartesianOrPolarFromCartesianMany (int count,
+                                                  const QPointF posGraphIn [],
+                                                  QPointF posGraphOut []) const = 0;
+
+  /// Return the shared pipeline for the coordinates type and theta units of the specified model. This should be
+  /// called when the model changes, and the result kept for the bulk conversions
+  static const TransformationPipelineAbstractBase &select (const DocumentModelCoords &modelCoords);
+};
+
+#endif // TRANSFORMATION_PIPELINE_ABSTRACT_BASE_H
@@ -48,7 +48,7 @@ void TransformationStateDefined::setModelGridRemoval (CmdMediator &cmdMediator,
   // Initialize grid removal settings so user does not have to
   int countX, countY;
   double startX, startY, stepX, stepY;
-  GridClassifier gridClassifier;
+  GridClassifier gridClassifier (true); // Coarse-to-fine, for sub-bin accuracy of start and step
   gridClassifier.classify (cmdMediator.document().pixmap(),
                            transformation,
                            countX,
@@ -91,9 +91,7 @@ void TransformationStateDefined::updateAxesChecker (CmdMediator &cmdMediator,
                                                     const Transformation &transformation)
 {
   CallbackAxesCheckerFromAxesPoints ftor;
-  Functor2wRet<const QString &, const Point&, CallbackSearchReturn> ftorWithCallback = functor_ret (ftor,
-                                                                                                    &CallbackAxesCheckerFromAxesPoints::callback);
-  cmdMediator.iterateThroughCurvePointsAxes (ftorWithCallback);
+  cmdMediator.iterateThroughCurvePointsAxes (ftor);
 
   m_axesChecker->prepareForDisplay (ftor.points(),
                                     cmdMediator.document().modelAxesChecker(),
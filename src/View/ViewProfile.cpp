@@ -1,6 +1,8 @@
 #include <QGraphicsRectItem>
+#include <QMouseEvent>
 #include "ViewProfile.h"
 #include "ViewProfileParameters.h"
+#include "ViewRenderQuality.h"
 
 const int FRAME_WIDTH = 2;
 
@@ -9,6 +11,7 @@ ViewProfile::ViewProfile(QGraphicsScene *scene,
   QGraphicsView (scene, parent)
 {
   setRenderHint (QPainter::Antialiasing);
+  m_renderQuality = new ViewRenderQuality (*this);
   setHorizontalScrollBarPolicy (Qt::ScrollBarAlwaysOff);
   setVerticalScrollBarPolicy (Qt::ScrollBarAlwaysOff);
 
@@ -29,6 +32,15 @@ void ViewProfile::createFrame ()
   scene()->addItem (m_frame);
 }
 
+void ViewProfile::mouseMoveEvent(QMouseEvent *event)
+{
+  if (event->buttons () != Qt::NoButton) {
+    m_renderQuality->startInteraction ();
+  }
+
+  QGraphicsView::mouseMoveEvent (event);
+}
+
 void ViewProfile::refit ()
 {
   // Force the scene boundaries to be the same, even after resizing
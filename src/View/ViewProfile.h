@@ -4,6 +4,7 @@
 #include <QGraphicsView>
 
 class QGraphicsRectItem;
+class ViewRenderQuality;
 
 /// Class that modifies QGraphicsView to present a two-dimensional profile, with movable dividers for selecting a range.
 class ViewProfile : public QGraphicsView
@@ -13,6 +14,9 @@ public:
   ViewProfile(QGraphicsScene *scene,
               QWidget *parent = 0);
 
+  /// Intercept mouse move events so dragging a divider renders quickly.
+  virtual void mouseMoveEvent(QMouseEvent *event);
+
   /// Intercept resize events so the geometry can be scaled to perfectly fit into the window.
   virtual void resizeEvent(QResizeEvent *event);
 
@@ -23,6 +27,7 @@ private:
   void refit();
 
   QGraphicsRectItem *m_frame;
+  ViewRenderQuality *m_renderQuality;
 };
 
 #endif // VIEW_PROFILE_H
@@ -0,0 +1,45 @@
+#include "Logger.h"
+#include "ViewRenderQuality.h"
+
+const int IDLE_MILLISECONDS = 150; // Time without interaction before rendering at full quality again
+
+ViewRenderQuality::ViewRenderQuality(QGraphicsView &view) :
+  QObject (&view),
+  m_view (view),
+  m_renderHints (view.renderHints ()),
+  m_viewportUpdateMode (view.viewportUpdateMode ()),
+  m_isInteracting (false)
+{
+  m_timerIdle.setSingleShot (true);
+  m_timerIdle.setInterval (IDLE_MILLISECONDS);
+
+  connect (&m_timerIdle, SIGNAL (timeout ()), this, SLOT (slotIdle ()));
+}
+
+void ViewRenderQuality::slotIdle ()
+{
+  LOG4CPP_DEBUG_S ((*mainCat)) << "ViewRenderQuality::slotIdle";
+
+  m_isInteracting = false;
+
+  m_view.setRenderHints (m_renderHints);
+  m_view.setViewportUpdateMode (m_viewportUpdateMode);
+
+  // Parts that were rendered quickly are rendered again
+  m_view.viewport ()->update ();
+}
+
+void ViewRenderQuality::startInteraction ()
+{
+  if (!m_isInteracting) {
+
+    LOG4CPP_DEBUG_S ((*mainCat)) << "ViewRenderQuality::startInteraction";
+
+    m_isInteracting = true;
+
+    m_view.setRenderHints (QPainter::RenderHints ());
+    m_view.setViewportUpdateMode (QGraphicsView::BoundingRectViewportUpdate);
+  }
+
+  m_timerIdle.start ();
+}
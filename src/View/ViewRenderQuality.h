@@ -0,0 +1,41 @@
+#ifndef VIEW_RENDER_QUALITY_H
+#define VIEW_RENDER_QUALITY_H
+
+#include <QGraphicsView>
+#include <QObject>
+#include <QPainter>
+#include <QTimer>
+
+/// Render policy for a QGraphicsView that drops to fast rendering while the user interacts with it.
+///
+/// While panning, zooming or dragging, the view renders without antialiasing or smooth pixmap transforms and
+/// updates just the bounding rectangle of the changes. Once the view has been idle for a short time, the full
+/// quality settings are restored and the whole viewport is rendered again
+class ViewRenderQuality : public QObject
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor. The render hints of the view at this time are its full quality settings.
+  ViewRenderQuality(QGraphicsView &view);
+
+  /// Switch to fast rendering, if not already done, and restart the idle period.
+  void startInteraction ();
+
+private slots:
+  void slotIdle ();
+
+private:
+  ViewRenderQuality();
+
+  QGraphicsView &m_view;
+
+  // Full quality settings, which are restored after each interaction
+  QPainter::RenderHints m_renderHints;
+  QGraphicsView::ViewportUpdateMode m_viewportUpdateMode;
+
+  bool m_isInteracting;
+  QTimer m_timerIdle;
+};
+
+#endif // VIEW_RENDER_QUALITY_H
@@ -6,7 +6,6 @@ RCC_DIR = .rcc
 
 HEADERS  += \
     include/BackgroundImage.h \
-    Callback/CallbackAddPointsInCurvesGraphs.h \
     Callback/CallbackAxesCheckerFromAxesPoints.h \
     Callback/CallbackAxisPointsAbstract.h \
     Callback/CallbackCheckAddPointAxis.h \
@@ -42,8 +41,10 @@ HEADERS  += \
     Coord/CoordThetaUnits.h \
     Correlation/Correlation.h \
     Curve/Curve.h \
+    Curve/CurveChunk.h \
     Curve/CurveConnectAs.h \
     Curve/CurvesGraphs.h \
+    Curve/CurvesGraphsPacked.h \
     Curve/CurveStyle.h \
     include/DataKey.h \
     DigitizeState/DigitizeStateAbstractBase.h \
@@ -59,6 +60,8 @@ HEADERS  += \
     Dlg/DlgFilterCommand.h \
     Dlg/DlgFilterThread.h \
     Dlg/DlgFilterWorker.h \
+    Dlg/DlgGridRemovalThread.h \
+    Dlg/DlgGridRemovalWorker.h \
     Dlg/DlgSettingsAbstractBase.h \
     Dlg/DlgSettingsAxesChecker.h \
     Dlg/DlgSettingsCoords.h \
@@ -72,6 +75,7 @@ HEADERS  += \
     Dlg/DlgSpinBoxDouble.h \
     Dlg/DlgSpinBoxInt.h \
     Document/Document.h \
+    Document/DocumentJournal.h \
     Document/DocumentModelAbstractBase.h \
     Document/DocumentModelAxesChecker.h \
     Document/DocumentModelCoords.h \
@@ -83,6 +87,7 @@ HEADERS  += \
     Document/DocumentModelGridRemoval.h \
     Document/DocumentModelPointMatch.h \
     Document/DocumentModelSegments.h \
+    Document/ImagePyramid.h \
     util/EnumsToQt.h \
     Export/ExportLayoutFunctions.h \
     Export/ExportPointsSelectionFunctions.h \
@@ -94,22 +99,30 @@ HEADERS  += \
     Filter/Filter.h \
     Filter/FilterColorEntry.h \
     Filter/FilterParameter.h \
-    Callback/functor.h \
+    Graphics/GraphicsBackground.h \
+    Graphics/GraphicsBackgroundFiltered.h \
     Graphics/GraphicsItemType.h \
     Graphics/GraphicsPointAbstractBase.h \
     Graphics/GraphicsPointCircle.h \
     Graphics/GraphicsPointPolygon.h \
+    Graphics/GraphicsPointsBatch.h \
     Graphics/GraphicsScene.h \
     Graphics/GraphicsView.h \
     Grid/GridClassifier.h \
     Grid/GridCoordDisable.h \
+    Grid/GridRemoval.h \
     Line/LineStyle.h \
     Load/LoadImageFromUrl.h \
     Logger/Logger.h \
     main/MainWindow.h \
+    main/StartupTiming.h \
     Mime/MimePoints.h \
+    Mime/MimePointsCurve.h \
+    Mime/MimePointsParser.h \
     util/mmsubs.h \
     Point/Point.h \
+    Point/PointIdentifier.h \
+    Point/PointIdentifiersPacked.h \
     Point/PointIdentifierToGraphicsItem.h \
     Point/PointShape.h \
     Point/PointStyle.h \
@@ -120,6 +133,8 @@ HEADERS  += \
     StatusBar/StatusBar.h \
     StatusBar/StatusBarMode.h \
     Transformation/Transformation.h \
+    Transformation/TransformationPipeline.h \
+    Transformation/TransformationPipelineAbstractBase.h \
     Transformation/TransformationStateAbstractBase.h \
     Transformation/TransformationStateContext.h \
     Transformation/TransformationStateDefined.h \
@@ -129,10 +144,10 @@ HEADERS  += \
     View/ViewProfileDivider.h \
     View/ViewProfileParameters.h \
     View/ViewProfileScale.h \
+    View/ViewRenderQuality.h \
     include/ZoomFactor.h
 
 SOURCES += \
-    Callback/CallbackAddPointsInCurvesGraphs.cpp \
     Callback/CallbackAxesCheckerFromAxesPoints.cpp \
     Callback/CallbackAxisPointsAbstract.cpp \
     Callback/CallbackCheckAddPointAxis.cpp \
@@ -163,6 +178,7 @@ SOURCES += \
     Correlation/Correlation.cpp \
     Curve/Curve.cpp \
     Curve/CurvesGraphs.cpp \
+    Curve/CurvesGraphsPacked.cpp \
     Curve/CurveStyle.cpp \
     DigitizeState/DigitizeStateAbstractBase.cpp \
     DigitizeState/DigitizeStateAxis.cpp \
@@ -177,6 +193,8 @@ SOURCES += \
     Dlg/DlgFilterCommand.cpp \
     Dlg/DlgFilterThread.cpp \
     Dlg/DlgFilterWorker.cpp \
+    Dlg/DlgGridRemovalThread.cpp \
+    Dlg/DlgGridRemovalWorker.cpp \
     Dlg/DlgSettingsAbstractBase.cpp \
     Dlg/DlgSettingsAxesChecker.cpp \
     Dlg/DlgSettingsCoords.cpp \
@@ -190,6 +208,7 @@ SOURCES += \
     Dlg/DlgSpinBoxDouble.cpp \
     Dlg/DlgSpinBoxInt.cpp \
     Document/Document.cpp \
+    Document/DocumentJournal.cpp \
     Document/DocumentModelAbstractBase.cpp \
     Document/DocumentModelAxesChecker.cpp \
     Document/DocumentModelCoords.cpp \
@@ -201,23 +220,31 @@ SOURCES += \
     Document/DocumentModelGridRemoval.cpp \
     Document/DocumentModelPointMatch.cpp \
     Document/DocumentModelSegments.cpp \
+    Document/ImagePyramid.cpp \
     util/EnumsToQt.cpp \
     Export/ExportToClipboard.cpp \
     Export/ExportToFile.cpp \
     Filter/Filter.cpp \
+    Graphics/GraphicsBackground.cpp \
+    Graphics/GraphicsBackgroundFiltered.cpp \
     Graphics/GraphicsPointAbstractBase.cpp \
     Graphics/GraphicsPointCircle.cpp \
     Graphics/GraphicsPointPolygon.cpp \
+    Graphics/GraphicsPointsBatch.cpp \
     Graphics/GraphicsScene.cpp \
     Graphics/GraphicsView.cpp \
     Grid/GridClassifier.cpp \
+    Grid/GridRemoval.cpp \
     Line/LineStyle.cpp \
     Load/LoadImageFromUrl.cpp \
     Logger/Logger.cpp \
     main/MainWindow.cpp \
+    main/StartupTiming.cpp \
     Mime/MimePoints.cpp \
+    Mime/MimePointsParser.cpp \
     util/mmsubs.cpp \
     Point/Point.cpp \
+    Point/PointIdentifiersPacked.cpp \
     Point/PointStyle.cpp \
     util/QtToString.cpp \
     Segment/Segment.cpp \
@@ -225,6 +252,7 @@ SOURCES += \
     Segment/SegmentLine.cpp \
     StatusBar/StatusBar.cpp \
     Transformation/Transformation.cpp \
+    Transformation/TransformationPipelineAbstractBase.cpp \
     Transformation/TransformationStateAbstractBase.cpp \
     Transformation/TransformationStateContext.cpp \
     Transformation/TransformationStateDefined.cpp \
@@ -233,14 +261,15 @@ SOURCES += \
     View/ViewProfile.cpp \
     View/ViewProfileDivider.cpp \
     View/ViewProfileParameters.cpp \
-    View/ViewProfileScale.cpp
+    View/ViewProfileScale.cpp \
+    View/ViewRenderQuality.cpp
 
 # Main entry point for non-test
 SOURCES += main/main.cpp
 
 TARGET = ../bin/engauge
 
-QT += core gui network printsupport widgets
+QT += concurrent core gui network printsupport widgets
 
 LIBS += -llog4cpp -lfftw3
 INCLUDEPATH += Callback \
@@ -6,7 +6,7 @@ RCC_DIR = .rcc_test
 
 HEADERS  += \
     include/BackgroundImage.h \
-    Callback/CallbackAddPointsInCurvesGraphs.h \
+    Callback/CallbackAxesCheckerFromAxesPoints.h \
     Callback/CallbackAxisPointsAbstract.h \
     Callback/CallbackCheckAddPointAxis.h \
     Callback/CallbackCheckEditPointAxis.h \
@@ -14,6 +14,8 @@ HEADERS  += \
     Callback/CallbackSceneUpdateAfterCommand.h \
     Callback/CallbackSearchReturn.h \
     Callback/CallbackUpdateTransform.h \
+    Checker/Checker.h \
+    Checker/CheckerMode.h \
     Cmd/CmdAbstract.h \
     Cmd/CmdAddPointAxis.h \
     Cmd/CmdAddPointGraph.h \
@@ -37,9 +39,12 @@ HEADERS  += \
     Coord/CoordScale.h \
     Coord/CoordsType.h \
     Coord/CoordThetaUnits.h \
+    Correlation/Correlation.h \
     Curve/Curve.h \
+    Curve/CurveChunk.h \
     Curve/CurveConnectAs.h \
     Curve/CurvesGraphs.h \
+    Curve/CurvesGraphsPacked.h \
     Curve/CurveStyle.h \
     include/DataKey.h \
     DigitizeState/DigitizeStateAbstractBase.h \
@@ -55,6 +60,8 @@ HEADERS  += \
     Dlg/DlgFilterCommand.h \
     Dlg/DlgFilterThread.h \
     Dlg/DlgFilterWorker.h \
+    Dlg/DlgGridRemovalThread.h \
+    Dlg/DlgGridRemovalWorker.h \
     Dlg/DlgSettingsAbstractBase.h \
     Dlg/DlgSettingsAxesChecker.h \
     Dlg/DlgSettingsCoords.h \
@@ -68,6 +75,7 @@ HEADERS  += \
     Dlg/DlgSpinBoxDouble.h \
     Dlg/DlgSpinBoxInt.h \
     Document/Document.h \
+    Document/DocumentJournal.h \
     Document/DocumentModelAbstractBase.h \
     Document/DocumentModelAxesChecker.h \
     Document/DocumentModelCoords.h \
@@ -79,6 +87,7 @@ HEADERS  += \
     Document/DocumentModelGridRemoval.h \
     Document/DocumentModelPointMatch.h \
     Document/DocumentModelSegments.h \
+    Document/ImagePyramid.h \
     util/EnumsToQt.h \
     Export/ExportLayoutFunctions.h \
     Export/ExportPointsSelectionFunctions.h \
@@ -90,44 +99,63 @@ HEADERS  += \
     Filter/Filter.h \
     Filter/FilterColorEntry.h \
     Filter/FilterParameter.h \
-    Callback/functor.h \
+    Graphics/GraphicsBackground.h \
+    Graphics/GraphicsBackgroundFiltered.h \
     Graphics/GraphicsItemType.h \
     Graphics/GraphicsPointAbstractBase.h \
     Graphics/GraphicsPointCircle.h \
     Graphics/GraphicsPointPolygon.h \
+    Graphics/GraphicsPointsBatch.h \
     Graphics/GraphicsScene.h \
     Graphics/GraphicsView.h \
+    Grid/GridClassifier.h \
     Grid/GridCoordDisable.h \
-    Highlight/Indicator.h \
+    Grid/GridRemoval.h \
     Line/LineStyle.h \
     Load/LoadImageFromUrl.h \
     Logger/Logger.h \
     main/MainWindow.h \
+    main/StartupTiming.h \
     Mime/MimePoints.h \
+    Mime/MimePointsCurve.h \
+    Mime/MimePointsParser.h \
+    util/mmsubs.h \
     Point/Point.h \
+    Point/PointIdentifier.h \
+    Point/PointIdentifiersPacked.h \
     Point/PointIdentifierToGraphicsItem.h \
     Point/PointShape.h \
     Point/PointStyle.h \
     util/QtToString.h \
-    Settings/SettingsCurve.h \
+    Segment/Segment.h \
+    Segment/SegmentFactory.h \
+    Segment/SegmentLine.h \
     StatusBar/StatusBar.h \
     StatusBar/StatusBarMode.h \
     Transformation/Transformation.h \
+    Transformation/TransformationPipeline.h \
+    Transformation/TransformationPipelineAbstractBase.h \
+    Transformation/TransformationStateAbstractBase.h \
+    Transformation/TransformationStateContext.h \
+    Transformation/TransformationStateDefined.h \
+    Transformation/TransformationStateUndefined.h \
     View/ViewPreview.h \
     View/ViewProfile.h \
     View/ViewProfileDivider.h \
     View/ViewProfileParameters.h \
     View/ViewProfileScale.h \
+    View/ViewRenderQuality.h \
     include/ZoomFactor.h
 
 SOURCES += \
-    Callback/CallbackAddPointsInCurvesGraphs.cpp \
+    Callback/CallbackAxesCheckerFromAxesPoints.cpp \
     Callback/CallbackAxisPointsAbstract.cpp \
     Callback/CallbackCheckAddPointAxis.cpp \
     Callback/CallbackCheckEditPointAxis.cpp \
     Callback/CallbackRemovePointsInCurvesGraphs.cpp \
     Callback/CallbackSceneUpdateAfterCommand.cpp \
     Callback/CallbackUpdateTransform.cpp \
+    Checker/Checker.cpp \
     Cmd/CmdAbstract.cpp \
     Cmd/CmdAddPointAxis.cpp \
     Cmd/CmdAddPointGraph.cpp \
@@ -147,8 +175,10 @@ SOURCES += \
     Cmd/CmdSettingsGridRemoval.cpp \
     Cmd/CmdSettingsPointMatch.cpp \
     Cmd/CmdSettingsSegments.cpp \
+    Correlation/Correlation.cpp \
     Curve/Curve.cpp \
     Curve/CurvesGraphs.cpp \
+    Curve/CurvesGraphsPacked.cpp \
     Curve/CurveStyle.cpp \
     DigitizeState/DigitizeStateAbstractBase.cpp \
     DigitizeState/DigitizeStateAxis.cpp \
@@ -163,6 +193,8 @@ SOURCES += \
     Dlg/DlgFilterCommand.cpp \
     Dlg/DlgFilterThread.cpp \
     Dlg/DlgFilterWorker.cpp \
+    Dlg/DlgGridRemovalThread.cpp \
+    Dlg/DlgGridRemovalWorker.cpp \
     Dlg/DlgSettingsAbstractBase.cpp \
     Dlg/DlgSettingsAxesChecker.cpp \
     Dlg/DlgSettingsCoords.cpp \
@@ -176,6 +208,7 @@ SOURCES += \
     Dlg/DlgSpinBoxDouble.cpp \
     Dlg/DlgSpinBoxInt.cpp \
     Document/Document.cpp \
+    Document/DocumentJournal.cpp \
     Document/DocumentModelAbstractBase.cpp \
     Document/DocumentModelAxesChecker.cpp \
     Document/DocumentModelCoords.cpp \
@@ -187,43 +220,75 @@ SOURCES += \
     Document/DocumentModelGridRemoval.cpp \
     Document/DocumentModelPointMatch.cpp \
     Document/DocumentModelSegments.cpp \
+    Document/ImagePyramid.cpp \
     util/EnumsToQt.cpp \
     Export/ExportToClipboard.cpp \
     Export/ExportToFile.cpp \
     Filter/Filter.cpp \
+    Graphics/GraphicsBackground.cpp \
+    Graphics/GraphicsBackgroundFiltered.cpp \
     Graphics/GraphicsPointAbstractBase.cpp \
     Graphics/GraphicsPointCircle.cpp \
     Graphics/GraphicsPointPolygon.cpp \
+    Graphics/GraphicsPointsBatch.cpp \
     Graphics/GraphicsScene.cpp \
     Graphics/GraphicsView.cpp \
+    Grid/GridClassifier.cpp \
+    Grid/GridRemoval.cpp \
     Line/LineStyle.cpp \
     Load/LoadImageFromUrl.cpp \
     Logger/Logger.cpp \
     main/MainWindow.cpp \
+    main/StartupTiming.cpp \
     Mime/MimePoints.cpp \
+    Mime/MimePointsParser.cpp \
+    util/mmsubs.cpp \
     Point/Point.cpp \
+    Point/PointIdentifiersPacked.cpp \
     Point/PointStyle.cpp \
     util/QtToString.cpp \
-    Settings/SettingsCurve.cpp \
+    Segment/Segment.cpp \
+    Segment/SegmentFactory.cpp \
+    Segment/SegmentLine.cpp \
     StatusBar/StatusBar.cpp \
     Transformation/Transformation.cpp \
+    Transformation/TransformationPipelineAbstractBase.cpp \
+    Transformation/TransformationStateAbstractBase.cpp \
+    Transformation/TransformationStateContext.cpp \
+    Transformation/TransformationStateDefined.cpp \
+    Transformation/TransformationStateUndefined.cpp \
     View/ViewPreview.cpp \
     View/ViewProfile.cpp \
     View/ViewProfileDivider.cpp \
     View/ViewProfileParameters.cpp \
-    View/ViewProfileScale.cpp
+    View/ViewProfileScale.cpp \
+    View/ViewRenderQuality.cpp
 
 # Main entry point for test
-HEADERS += Test/TestGraphCoords.h
-SOURCES += Test/TestGraphCoords.cpp
+HEADERS += \
+    Test/TestDocumentBinary.h \
+    Test/TestDocumentJournal.h \
+    Test/TestGraphCoords.h \
+    Test/TestMimePointsParser.h \
+    Test/TestPointIdentifiersPacked.h
+SOURCES += \
+    Test/TestDocumentBinary.cpp \
+    Test/TestDocumentJournal.cpp \
+    Test/TestGraphCoords.cpp \
+    Test/TestMain.cpp \
+    Test/TestMimePointsParser.cpp \
+    Test/TestPointIdentifiersPacked.cpp
 
 TARGET = ../bin/engauge_test
 
-QT += core gui network printsupport testlib widgets
-LIBS += -llog4cpp
+QT += concurrent core gui network printsupport testlib widgets
+
+LIBS += -llog4cpp -lfftw3
 INCLUDEPATH += Callback \
+               Checker \
                Cmd \
                Coord \
+               Correlation \
                Curve \
                DigitizeState \
                Dlg \
@@ -232,7 +297,6 @@ INCLUDEPATH += Callback \
                Filter \
                Graphics \
                Grid \
-               Highlight \
                img \
                include \
                Line \
@@ -242,7 +306,6 @@ INCLUDEPATH += Callback \
                Mime \
                Plot \
                Point \
-               Settings \
                StatusBar \
                Transformation \
                util \
@@ -8,6 +8,7 @@
 #include "CmdCut.h"
 #include "CmdDelete.h"
 #include "CmdMediator.h"
+#include "CmdPaste.h"
 #include "Curve.h"
 #include "DataKey.h"
 #include "DigitizeStateContext.h"
@@ -26,11 +27,13 @@
 #include "DlgSettingsPointMatch.h"
 #include "DlgSettingsSegments.h"
 #include "ExportToFile.h"
-#include "Filter.h"
+#include "GraphicsBackground.h"
+#include "GraphicsBackgroundFiltered.h"
 #include "GraphicsItemType.h"
 #include "GraphicsPointPolygon.h"
 #include "GraphicsScene.h"
 #include "GraphicsView.h"
+#include "GridRemoval.h"
 #include "LoadImageFromUrl.h"
 #include "Logger.h"
 #include "MainWindow.h"
@@ -42,7 +45,7 @@
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QGraphicsLineItem>
-#include <QGraphicsPixmapItem>
+#include <QGraphicsRectItem>
 #include <QImageReader>
 #include <QKeySequence>
 #include <QMenu>
@@ -51,6 +54,7 @@
 #include <QPrintDialog>
 #include <QPrinter>
 #include <QSettings>
+#include <QtConcurrentRun>
 #include <QTextStream>
 #include <QToolBar>
 #include <QToolButton>
@@ -77,10 +81,20 @@ MainWindow::MainWindow(QWidget *parent) :
   m_imageNone (0),
   m_imageUnfiltered (0),
   m_imageFiltered (0),
-  m_cmdMediator (0)
-{
+  m_cmdMediator (0),
+  m_dlgSettingsAxesChecker (0),
+  m_dlgSettingsCoords (0),
+  m_dlgSettingsCurveProperties (0),
+  m_dlgSettingsCurves (0),
+  m_dlgSettingsExport (0),
+  m_dlgSettingsFilter (0),
+  m_dlgSettingsGridRemoval (0),
+  m_dlgSettingsPointMatch (0),
+  m_dlgSettingsSegments (0)
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::MainWindow";
+
   setCurrentFile ("");
-  createIcons();
   setWindowFlags (Qt::WindowContextHelpButtonHint);
 
   createCentralWidget();
@@ -92,12 +106,18 @@ MainWindow::MainWindow(QWidget *parent) :
   createLoadImageFromUrl ();
   createStateContextDigitize ();
   createStateContextTransformation ();
-  createSettingsDialogs ();
   updateControls ();
 
   settingsRead ();
   setCurrentFile ("");
   setUnifiedTitleAndToolBarOnMac(true);
+
+  // The window icons are only needed by the window manager, so they are decoded off the critical path to the first
+  // paint. The finished signal is delivered by the event loop, after the window has been shown
+  connect (&m_watcherIcons, SIGNAL (finished ()), this, SLOT (slotIconsDecoded ()));
+  m_watcherIcons.setFuture (QtConcurrent::run (&MainWindow::decodeIcons));
+
+  connect (&m_watcherImagePyramid, SIGNAL (finished ()), this, SLOT (slotImagePyramidBuilt ()));
 }
 
 MainWindow::~MainWindow()
@@ -108,6 +128,12 @@ void MainWindow::closeEvent(QCloseEvent *event)
 {
   if (maybeSave()) {
     settingsWrite ();
+
+    // Unsaved changes were either saved or discarded, so the journal is no longer needed
+    if (m_cmdMediator != 0) {
+      m_cmdMediator->closeJournal ();
+    }
+
     event->accept ();
   } else {
     event->ignore ();
@@ -540,22 +566,25 @@ void MainWindow::createCentralWidget ()
   widget->setLayout (m_layout);
 }
 
-void MainWindow::createIcons()
+void MainWindow::createImageFiltered ()
 {
-  QIcon icon;
-  QPixmap icon16 (bannerapp_16);
-  QPixmap icon32 (bannerapp_32);
-  QPixmap icon64 (bannerapp_64);
-  QPixmap icon128 (bannerapp_128);
-  QPixmap icon256 (bannerapp_256);
-
-  icon.addPixmap (icon16);
-  icon.addPixmap (icon32);
-  icon.addPixmap (icon64);
-  icon.addPixmap (icon128);
-  icon.addPixmap (icon256);
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::createImageFiltered";
 
-  setWindowIcon (icon);
+  // Nothing is filtered here. The tiles are filtered as they are painted, from the same images as the unfiltered
+  // background
+  m_imageFiltered = new GraphicsBackgroundFiltered (m_imageUnfiltered->image (),
+                                                    cmdMediator().document().modelFilter().filterParameter(),
+                                                    cmdMediator().document().modelFilter().low(),
+                                                    cmdMediator().document().modelFilter().high(),
+                                                    gridRemovalMask ());
+  m_scene->addItem (m_imageFiltered);
+  m_imageFiltered->setData (DATA_KEY_IDENTIFIER, "view");
+  m_imageFiltered->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_IMAGE);
+
+  // Otherwise the pyramid is handed over by slotImagePyramidBuilt
+  if (m_watcherImagePyramid.isFinished ()) {
+    m_imageFiltered->setImagePyramid (m_watcherImagePyramid.result ());
+  }
 }
 
 void MainWindow::createLoadImageFromUrl ()
@@ -647,29 +676,6 @@ void MainWindow::createMenus()
   m_menuHelp->insertSeparator (m_actionWhatsThis);
 }
 
-void MainWindow::createSettingsDialogs ()
-{
-  m_dlgSettingsCoords = new DlgSettingsCoords (*this);
-  m_dlgSettingsCurveProperties = new DlgSettingsCurveProperties (*this);
-  m_dlgSettingsCurves = new DlgSettingsCurves (*this);
-  m_dlgSettingsExport = new DlgSettingsExport (*this);
-  m_dlgSettingsFilter = new DlgSettingsFilter (*this);
-  m_dlgSettingsAxesChecker = new DlgSettingsAxesChecker (*this);
-  m_dlgSettingsGridRemoval = new DlgSettingsGridRemoval (*this);
-  m_dlgSettingsPointMatch = new DlgSettingsPointMatch (*this);
-  m_dlgSettingsSegments = new DlgSettingsSegments (*this);
-
-  m_dlgSettingsCoords->setVisible (false);
-  m_dlgSettingsCurveProperties->setVisible (false);
-  m_dlgSettingsCurves->setVisible (false);
-  m_dlgSettingsExport->setVisible (false);
-  m_dlgSettingsFilter->setVisible (false);
-  m_dlgSettingsAxesChecker->setVisible (false);
-  m_dlgSettingsGridRemoval->setVisible (false);
-  m_dlgSettingsPointMatch->setVisible (false);
-  m_dlgSettingsSegments->setVisible (false);
-}
-
 void MainWindow::createScene ()
 {
   m_scene = new GraphicsScene (this);
@@ -736,12 +742,32 @@ void MainWindow::createToolBars ()
   addToolBar (m_toolDigitize);
 }
 
+QList<QImage> MainWindow::decodeIcons ()
+{
+  // Runs in a worker thread, so only QImage is used here. QPixmap is restricted to the gui thread
+  QList<QImage> icons;
+  icons << QImage (bannerapp_16)
+        << QImage (bannerapp_32)
+        << QImage (bannerapp_64)
+        << QImage (bannerapp_128)
+        << QImage (bannerapp_256);
+
+  return icons;
+}
+
 void MainWindow::fileImport (const QString &fileName)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::fileImport fileName=" << fileName.toLatin1 ().data ();
 
+  // The file bytes are kept along with the decoded image, so saving the Document does not encode the image again
+  QFile file (fileName);
+  QByteArray bytes;
+  if (file.open (QIODevice::ReadOnly)) {
+    bytes = file.readAll ();
+  }
+
   QImage image;
-  if (!image.load (fileName)) {
+  if (!image.loadFromData (bytes)) {
     QMessageBox::warning (this,
                           tr("Application"),
                           tr("Cannot read file %1.").
@@ -750,13 +776,45 @@ void MainWindow::fileImport (const QString &fileName)
   }
 
   loadImage (fileName,
-             image);
+             image,
+             bytes);
+}
+
+GridRemoval MainWindow::gridRemovalMask () const
+{
+  // Grid lines are removed from the filtered image, which is what segment extraction works on
+  QPixmap pixmap = m_cmdMediator->document().pixmap();
+
+  GridRemoval gridRemoval;
+  gridRemoval.rasterizeMask (m_cmdMediator->document().modelGridRemoval(),
+                             m_cmdMediator->document().modelCoords(),
+                             m_transformation,
+                             pixmap.width (),
+                             pixmap.height ());
+
+  return gridRemoval;
+}
+
+QImage MainWindow::imageFiltered ()
+{
+  if (m_imageFiltered == 0) {
+    createImageFiltered ();
+    updateViewedBackground ();
+  }
+
+  return m_imageFiltered->imageFiltered ();
 }
 
 void MainWindow::loadFile (const QString &fileName)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::loadFile fileName=" << fileName.toLatin1 ().data ();
 
+  // Unsaved changes of the current Document were saved or discarded before getting here, so its journal is removed.
+  // Otherwise reopening the same file would replay the discarded changes
+  if (m_cmdMediator != 0) {
+    m_cmdMediator->closeJournal ();
+  }
+
   QApplication::setOverrideCursor(Qt::WaitCursor);
   CmdMediator *cmdMediator = new CmdMediator (fileName);
   QApplication::restoreOverrideCursor();
@@ -784,14 +842,19 @@ void MainWindow::loadFile (const QString &fileName)
     slotViewZoomFill();
 
     setCurrentFile(fileName);
-    m_statusBar->showTemporaryMessage("File opened");
+    m_engaugeFile = fileName;
+    if (m_cmdMediator->journalWasReplayed ()) {
+      m_statusBar->showTemporaryMessage("File opened, with unsaved changes recovered from its journal");
+    } else {
+      m_statusBar->showTemporaryMessage("File opened");
+    }
     m_statusBar->wakeUp ();
 
     // Start select mode
     m_actionDigitizeSelect->setChecked (true); // We assume user wants to first select existing stuff
     slotDigitizeSelect(); // Trigger transition so cursor gets updated immediately
 
-    updateControls ();
+    updateAfterCommand (); // Adds the loaded Points to the scene, and defines the transformation from the axis points
 
   } else {
 
@@ -802,16 +865,24 @@ void MainWindow::loadFile (const QString &fileName)
                           arg(cmdMediator->reasonForUnsuccessfulRead ()));
     delete cmdMediator;
 
+    // The current Document stays open, so it is journaled again
+    if ((m_cmdMediator != 0) &&
+        !m_engaugeFile.isEmpty ()) {
+      m_cmdMediator->startJournal (m_engaugeFile);
+    }
+
   }
 }
 
 void MainWindow::loadImage (const QString &fileName,
-                            const QImage &image)
+                            const QImage &image,
+                            const QByteArray &imageBytes)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::loadImage fileName=" << fileName.toLatin1 ().data ();
 
   QApplication::setOverrideCursor(Qt::WaitCursor);
-  CmdMediator *cmdMediator = new CmdMediator (image);
+  CmdMediator *cmdMediator = new CmdMediator (image,
+                                              imageBytes);
   QApplication::restoreOverrideCursor();
 
   setCurrentPathFromFile (fileName);
@@ -882,16 +953,19 @@ void MainWindow::removePixmaps ()
 {
   if (m_imageNone != 0) {
     m_scene->removeItem (m_imageNone);
+    delete m_imageNone;
     m_imageNone = 0;
   }
 
   if (m_imageUnfiltered != 0) {
     m_scene->removeItem (m_imageUnfiltered);
+    delete m_imageUnfiltered;
     m_imageUnfiltered = 0;
   }
 
   if (m_imageFiltered != 0) {
     m_scene->removeItem (m_imageFiltered);
+    delete m_imageFiltered;
     m_imageFiltered = 0;
   }
 }
@@ -920,11 +994,37 @@ bool MainWindow::saveFile (const QString &fileName)
   }
 
   QApplication::setOverrideCursor (Qt::WaitCursor);
-  QXmlStreamWriter stream(&file);
-  stream.setAutoFormatting(true);
-  m_cmdMediator->document().saveDocument(stream);
+  bool success;
+  if (QFileInfo (fileName).suffix () == ENGAUGE_FILENAME_EXTENSION) {
+
+    // Compact binary format, whose sections are written straight to the file
+    m_cmdMediator->document().saveDocumentBinary (file);
+    success = (file.error () == QFile::NoError);
+
+  } else {
+
+    // The xml format is serialized into memory and then written with one call, rather than in many small writes
+    QByteArray bytes;
+    QXmlStreamWriter stream(&bytes);
+    stream.setAutoFormatting(true);
+    m_cmdMediator->document().saveDocument(stream);
+    success = (file.write (bytes) == bytes.size ());
+  }
   QApplication::restoreOverrideCursor ();
 
+  if (!success) {
+    QMessageBox::warning (this,
+                          tr("Application"),
+                          tr ("Cannot write file %1: \n%2.").
+                          arg(fileName).
+                          arg(file.errorString()));
+    return false;
+  }
+
+  // The journal only needs to hold the changes made after this save
+  file.close ();
+  m_cmdMediator->startJournal (fileName);
+
   setCurrentFile(fileName);
   m_engaugeFile = fileName;
   m_statusBar->showTemporaryMessage("File saved");
@@ -1108,9 +1208,9 @@ void MainWindow::slotCmbCurve(int /* currentIndex */)
   updateViewedPoints();
 }
 
-void MainWindow::slotContextMenuEvent (QString pointIdentifier)
+void MainWindow::slotContextMenuEvent (PointIdentifier pointIdentifier)
 {
-  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotContextMenuEvent point=" << pointIdentifier.toLatin1 ().data ();
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotContextMenuEvent point=" << Point::identifierToString (pointIdentifier).toLatin1 ().data ();
 
   m_digitizeStateContext->handleContextMenuEvent (pointIdentifier);
 }
@@ -1188,6 +1288,11 @@ void MainWindow::slotEditDelete ()
 void MainWindow::slotEditPaste ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotEditPaste";
+
+  CmdPaste *cmd = new CmdPaste (*this,
+                                m_cmdMediator->document(),
+                                m_scene->selectedPointIdentifiers ());
+  m_digitizeStateContext->appendNewCmd (cmd);
 }
 
 void MainWindow::slotFileExport ()
@@ -1293,7 +1398,7 @@ void MainWindow::slotFileOpen()
 
     // Allow selection of files with strange suffixes in case the file extension was changed. Since
     // the default is the first filter, the wildcard filter is added afterwards (it is the off-nominal case)
-    QString filter (tr ("Documents (*.dig);; All Files (*.*)"));
+    QString filter (tr ("Documents (*.dig *.xml);; All Files (*.*)"));
 
     QString fileName = QFileDialog::getOpenFileName (this,
                                                      tr("Open Document"),
@@ -1386,6 +1491,37 @@ void MainWindow::slotHelpAbout()
   aboutBox.exec ();
 }
 
+void MainWindow::slotIconsDecoded ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotIconsDecoded";
+
+  QIcon icon;
+  QList<QImage> icons = m_watcherIcons.result ();
+  QList<QImage>::const_iterator itr;
+  for (itr = icons.begin (); itr != icons.end (); itr++) {
+    icon.addPixmap (QPixmap::fromImage (*itr));
+  }
+
+  setWindowIcon (icon);
+
+  emit signalStartupFinished ();
+}
+
+void MainWindow::slotImagePyramidBuilt ()
+{
+  LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotImagePyramidBuilt";
+
+  // The background items are removed, and the watcher moves to the next Document, when a Document is replaced. So
+  // any pyramid that arrives here belongs to the current background items
+  ImagePyramid imagePyramid = m_watcherImagePyramid.result ();
+  if (m_imageUnfiltered != 0) {
+    m_imageUnfiltered->setImagePyramid (imagePyramid);
+  }
+  if (m_imageFiltered != 0) {
+    m_imageFiltered->setImagePyramid (imagePyramid);
+  }
+}
+
 void MainWindow::slotKeyPress (Qt::Key key)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotKeyPress key=" << QKeySequence (key).toString().toLatin1 ().data ();
@@ -1419,7 +1555,7 @@ void MainWindow::slotMousePress (QPointF pos)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotMousePress";
 
-  m_view->resetPositionHasChangedFlags();
+  m_scene->resetPositionHasChanged ();
 
   m_digitizeStateContext->handleMousePress (pos);
 }
@@ -1453,6 +1589,10 @@ void MainWindow::slotSettingsAxesChecker ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsAxesChecker";
 
+  if (m_dlgSettingsAxesChecker == 0) {
+    m_dlgSettingsAxesChecker = new DlgSettingsAxesChecker (*this);
+  }
+
   m_dlgSettingsAxesChecker->load (*m_cmdMediator);
   m_dlgSettingsAxesChecker->show ();
 }
@@ -1461,6 +1601,10 @@ void MainWindow::slotSettingsCoords ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsCoords";
 
+  if (m_dlgSettingsCoords == 0) {
+    m_dlgSettingsCoords = new DlgSettingsCoords (*this);
+  }
+
   m_dlgSettingsCoords->load (*m_cmdMediator);
   m_dlgSettingsCoords->show ();
 }
@@ -1469,6 +1613,10 @@ void MainWindow::slotSettingsCurveProperties ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsCoords";
 
+  if (m_dlgSettingsCurveProperties == 0) {
+    m_dlgSettingsCurveProperties = new DlgSettingsCurveProperties (*this);
+  }
+
   m_dlgSettingsCurveProperties->load (*m_cmdMediator);
   m_dlgSettingsCurveProperties->setCurveName (m_cmbCurve->currentText ());
   m_dlgSettingsCurveProperties->show ();
@@ -1478,6 +1626,10 @@ void MainWindow::slotSettingsCurves ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsCoords";
 
+  if (m_dlgSettingsCurves == 0) {
+    m_dlgSettingsCurves = new DlgSettingsCurves (*this);
+  }
+
   m_dlgSettingsCurves->load (*m_cmdMediator);
   m_dlgSettingsCurves->show ();
 }
@@ -1486,6 +1638,10 @@ void MainWindow::slotSettingsExport ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsCoords";
 
+  if (m_dlgSettingsExport == 0) {
+    m_dlgSettingsExport = new DlgSettingsExport (*this);
+  }
+
   m_dlgSettingsExport->load (*m_cmdMediator);
   m_dlgSettingsExport->show ();
 }
@@ -1494,6 +1650,10 @@ void MainWindow::slotSettingsFilter ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsCoords";
 
+  if (m_dlgSettingsFilter == 0) {
+    m_dlgSettingsFilter = new DlgSettingsFilter (*this);
+  }
+
   m_dlgSettingsFilter->load (*m_cmdMediator);
   m_dlgSettingsFilter->show ();
 }
@@ -1502,6 +1662,10 @@ void MainWindow::slotSettingsGridRemoval ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsCoords";
 
+  if (m_dlgSettingsGridRemoval == 0) {
+    m_dlgSettingsGridRemoval = new DlgSettingsGridRemoval (*this);
+  }
+
   m_dlgSettingsGridRemoval->load (*m_cmdMediator);
   m_dlgSettingsGridRemoval->show ();
 }
@@ -1510,6 +1674,10 @@ void MainWindow::slotSettingsPointMatch ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsCoords";
 
+  if (m_dlgSettingsPointMatch == 0) {
+    m_dlgSettingsPointMatch = new DlgSettingsPointMatch (*this);
+  }
+
   m_dlgSettingsPointMatch->load (*m_cmdMediator);
   m_dlgSettingsPointMatch->show ();
 }
@@ -1518,6 +1686,10 @@ void MainWindow::slotSettingsSegments ()
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::slotSettingsCoords";
 
+  if (m_dlgSettingsSegments == 0) {
+    m_dlgSettingsSegments = new DlgSettingsSegments (*this);
+  }
+
   m_dlgSettingsSegments->load (*m_cmdMediator);
   m_dlgSettingsSegments->show ();
 }
@@ -1889,6 +2061,11 @@ void MainWindow::slotViewZoomOut ()
   }
 }
 
+const Transformation &MainWindow::transformation() const
+{
+  return m_transformation;
+}
+
 bool MainWindow::transformIsDefined() const
 {
   return m_transformation.transformIsDefined();
@@ -1956,6 +2133,13 @@ void MainWindow::updateAfterCommandStatusBarCoords ()
 
   }
 
+  if ((m_transformationBefore != m_transformation) &&
+      cmdMediator().document().modelGridRemoval().removeDefinedGridLines()) {
+
+    // Removed grid lines are defined in graph coordinates, so they moved along with the transformation
+    updateImageFiltered ();
+  }
+
   QPoint posLocal = m_view->mapFromGlobal (QCursor::pos ()) - HACK_SO_GRAPH_COORDINATE_MATCHES_INPUT;
   QPointF posScreen = m_view->mapToScene (posLocal);
 
@@ -1987,7 +2171,7 @@ void MainWindow::updateControls ()
   }
   m_actionEditCut->setEnabled (m_scene->selectedItems().count () > 0);
   m_actionEditCopy->setEnabled (m_scene->selectedItems().count () > 0);
-  m_actionEditPaste->setEnabled (false);
+  m_actionEditPaste->setEnabled (!m_currentFile.isEmpty ());
   m_actionEditDelete->setEnabled (m_scene->selectedItems().count () > 0);
 
   m_actionDigitizeAxis->setEnabled (!m_currentFile.isEmpty ());
@@ -2017,44 +2201,45 @@ void MainWindow::updateControls ()
   m_actionZoomOut->setEnabled (!m_currentFile.isEmpty ()); // Disable at startup so shortcut has no effect
 }
 
+void MainWindow::updateImageFiltered ()
+{
+  // Only the visible tiles of an existing filtered background are filtered again
+  if (m_imageFiltered != 0) {
+    m_imageFiltered->setFilter (cmdMediator().document().modelFilter().filterParameter(),
+                                cmdMediator().document().modelFilter().low(),
+                                cmdMediator().document().modelFilter().high(),
+                                gridRemovalMask ());
+  }
+}
+
 void MainWindow::updateImages (const QPixmap &pixmap)
 {
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::updateImages";
 
   removePixmaps ();
 
-  // Empty background
-  QPixmap pixmapNone (pixmap);
-  pixmapNone.fill (Qt::white);
-  m_imageNone = m_scene->addPixmap (pixmapNone);
+  // Empty background, which is filled with a brush so it needs no image of its own
+  m_imageNone = m_scene->addRect (QRectF (0,
+                                          0,
+                                          pixmap.width (),
+                                          pixmap.height ()),
+                                  QPen (Qt::NoPen),
+                                  QBrush (Qt::white));
   m_imageNone->setData (DATA_KEY_IDENTIFIER, "view");
   m_imageNone->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_IMAGE);
 
-  // Unfiltered original image
-  m_imageUnfiltered = m_scene->addPixmap (pixmap);
+  // Unfiltered original image. It is painted at full resolution until the pyramid, whose levels are shared with the
+  // filtered background and the settings dialogs, has been built in the background
+  m_imageUnfiltered = new GraphicsBackground (pixmap.toImage ());
+  m_scene->addItem (m_imageUnfiltered);
   m_imageUnfiltered->setData (DATA_KEY_IDENTIFIER, "view");
   m_imageUnfiltered->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_IMAGE);
+  m_watcherImagePyramid.setFuture (cmdMediator().document().imagePyramidFuture ());
 
   // Reset scene rectangle or else small image after large image will be off-center
   m_scene->setSceneRect (m_imageUnfiltered->boundingRect ());
 
-  // Filtered image
-  Filter filter;
-  QImage imageUnfiltered (pixmap.toImage ());
-  QImage imageFiltered (pixmap.width (),
-                        pixmap.height (),
-                        QImage::Format_RGB32);
-  QRgb rgbBackground = filter.marginColor (&imageUnfiltered);
-  filter.filterImage (imageUnfiltered,
-                      imageFiltered,
-                      cmdMediator().document().modelFilter().filterParameter(),
-                      cmdMediator().document().modelFilter().low(),
-                      cmdMediator().document().modelFilter().high(),
-                      rgbBackground);
-
-  m_imageFiltered = m_scene->addPixmap (QPixmap::fromImage (imageFiltered));
-  m_imageFiltered->setData (DATA_KEY_IDENTIFIER, "view");
-  m_imageFiltered->setData (DATA_KEY_GRAPHICS_ITEM_TYPE, GRAPHICS_ITEM_TYPE_IMAGE);
+  // Filtered image is created when it is first shown or needed, which most sessions never do
 }
 
 void MainWindow::updateSettingsAxesChecker(const DocumentModelAxesChecker &modelAxesChecker)
@@ -2101,8 +2286,7 @@ void MainWindow::updateSettingsFilter(const DocumentModelFilter &modelFilter)
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::updateSettingsFilter";
 
   m_cmdMediator->document().setModelFilter(modelFilter);
-  updateImages (cmdMediator().document().pixmap());
-  updateViewedBackground ();
+  updateImageFiltered ();
 }
 
 void MainWindow::updateSettingsGridRemoval(const DocumentModelGridRemoval &modelGridRemoval)
@@ -2110,6 +2294,7 @@ void MainWindow::updateSettingsGridRemoval(const DocumentModelGridRemoval &model
   LOG4CPP_INFO_S ((*mainCat)) << "MainWindow::updateSettingsGridRemoval";
 
   m_cmdMediator->document().setModelGridRemoval(modelGridRemoval);
+  updateImageFiltered ();
 }
 
 void MainWindow::updateSettingsPointMatch(const DocumentModelPointMatch &modelPointMatch)
@@ -2134,9 +2319,15 @@ void MainWindow::updateViewedBackground()
 
     BackgroundImage backgroundImage = (BackgroundImage) m_cmbBackground->currentData().toInt();
 
+    if ((backgroundImage == BACKGROUND_IMAGE_FILTERED) && (m_imageFiltered == 0)) {
+      createImageFiltered ();
+    }
+
     m_imageNone->setVisible (backgroundImage == BACKGROUND_IMAGE_NONE);
     m_imageUnfiltered->setVisible (backgroundImage == BACKGROUND_IMAGE_ORIGINAL);
-    m_imageFiltered->setVisible (backgroundImage == BACKGROUND_IMAGE_FILTERED);
+    if (m_imageFiltered != 0) {
+      m_imageFiltered->setVisible (backgroundImage == BACKGROUND_IMAGE_FILTERED);
+    }
   }
 }
 
@@ -1,6 +1,11 @@
 #ifndef MAIN_WINDOW_H
 #define MAIN_WINDOW_H
 
+#include "ImagePyramid.h"
+#include "PointIdentifier.h"
+#include <QFutureWatcher>
+#include <QImage>
+#include <QList>
 #include <QMainWindow>
 #include <QUrl>
 #include "Transformation.h"
@@ -25,15 +30,18 @@ class DocumentModelFilter;
 class DocumentModelGridRemoval;
 class DocumentModelPointMatch;
 class DocumentModelSegments;
+class GraphicsBackground;
+class GraphicsBackgroundFiltered;
 class GraphicsScene;
 class GraphicsView;
+class GridRemoval;
 class LoadImageFromUrl;
 class QAction;
 class QActionGroup;
 class QCloseEvent;
 class QComboBox;
 class QGraphicsLineItem;
-class QGraphicsPixmapItem;
+class QGraphicsRectItem;
 class QMenu;
 class QSettings;
 class QToolBar;
@@ -54,6 +62,10 @@ public:
   /// Accessor for commands to process the Document.
   CmdMediator &cmdMediator();
 
+  /// Return the filtered image with the grid lines removed, which is what segment extraction works on. The filtered
+  /// background is created first if it has not been shown yet
+  QImage imageFiltered ();
+
   /// Update the combobox that has the curve names.
   void loadCurveNamesFromCmdMediator();
 
@@ -69,6 +81,9 @@ public:
   /// Return true if all three axis points have been defined.
   bool transformIsDefined() const;
 
+  /// Return the current transformation, which is only meaningful when transformIsDefined is true.
+  const Transformation &transformation() const;
+
   /// See GraphicsScene::updateAfterCommand.
   void updateAfterCommand();
 
@@ -113,7 +128,7 @@ private slots:
   void slotCanUndoChanged (bool);
   void slotCmbBackground(int);
   void slotCmbCurve(int);
-  void slotContextMenuEvent (QString);
+  void slotContextMenuEvent (PointIdentifier);
   void slotDigitizeAxis ();
   void slotDigitizeCurve ();
   void slotDigitizePointMatch ();
@@ -133,6 +148,8 @@ private slots:
   bool slotFileSave(); /// Slot method that is sometimes called directly with return value expected
   bool slotFileSaveAs(); /// Slot method that is sometimes called directly with return value expected
   void slotHelpAbout();
+  void slotIconsDecoded ();
+  void slotImagePyramidBuilt ();
   void slotKeyPress (Qt::Key);
   void slotLeave ();
   void slotMouseMove (QPointF);
@@ -170,6 +187,9 @@ private slots:
   void slotViewZoomOut ();
 
 signals:
+  /// Sent once the startup work that was deferred until after the window is shown has finished.
+  void signalStartupFinished ();
+
   /// Send zoom selection, picked from menu or keystroke, to StatusBar.
   void signalZoom(int);
 
@@ -183,19 +203,21 @@ private:
   void createActionsSettings ();
   void createActionsView ();
   void createCentralWidget ();
-  void createIcons();
+  void createImageFiltered ();
   void createLoadImageFromUrl ();
   void createMenus();
   void createScene ();
-  void createSettingsDialogs ();
   void createStateContextDigitize();
   void createStateContextTransformation();
   void createStatusBar();
   void createToolBars();
+  static QList<QImage> decodeIcons ();
   void fileImport (const QString &fileName);
+  GridRemoval gridRemovalMask () const;
   void loadFile (const QString &fileName);
   void loadImage (const QString &fileName,
-                  const QImage &image);
+                  const QImage &image,
+                  const QByteArray &imageBytes = QByteArray ());
   bool maybeSave();
   void removePixmaps();
   bool saveFile(const QString &fileName);
@@ -208,6 +230,7 @@ private:
   void settingsWrite ();
   void updateAfterCommandStatusBarCoords ();
   void updateControls (); // Update the widgets (typically in terms of show/hide state) depending on the application state.
+  void updateImageFiltered ();
   void updateImages (const QPixmap &pixmap);
   void updateViewedBackground();
   void updateViewedPoints ();
@@ -293,9 +316,9 @@ private:
   GraphicsScene *m_scene;
   GraphicsView *m_view;
 
-  QGraphicsPixmapItem *m_imageNone; // White background with boundary indicating the edge of the original image
-  QGraphicsPixmapItem *m_imageUnfiltered; // Original unfiltered image
-  QGraphicsPixmapItem *m_imageFiltered; // Image produced by Filter class
+  QGraphicsRectItem *m_imageNone; // White background with boundary indicating the edge of the original image
+  GraphicsBackground *m_imageUnfiltered; // Original unfiltered image
+  GraphicsBackgroundFiltered *m_imageFiltered; // Image produced by Filter class, created when first needed
 
   StatusBar *m_statusBar;
   Transformation m_transformation;
@@ -315,6 +338,7 @@ private:
   // State machine for transformation states
   TransformationStateContext *m_transformationStateContext;
 
+  // Settings dialogs are created when they are first opened, rather than at startup
   DlgSettingsAxesChecker *m_dlgSettingsAxesChecker;
   DlgSettingsCoords *m_dlgSettingsCoords;
   DlgSettingsCurveProperties *m_dlgSettingsCurveProperties;
@@ -324,6 +348,13 @@ private:
   DlgSettingsGridRemoval *m_dlgSettingsGridRemoval;
   DlgSettingsPointMatch *m_dlgSettingsPointMatch;
   DlgSettingsSegments *m_dlgSettingsSegments;
+
+  // Decodes the window icons in the background, since the large icons are slow to decode
+  QFutureWatcher<QList<QImage> > m_watcherIcons;
+
+  // Waits for the ImagePyramid of the Document, which is built in the background and then handed to the background
+  // items
+  QFutureWatcher<ImagePyramid> m_watcherImagePyramid;
 };
 
 #endif // MAIN_WINDOW_H
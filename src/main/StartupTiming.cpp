@@ -0,0 +1,72 @@
+#include <iostream>
+#include "Logger.h"
+#include "MainWindow.h"
+#include <QApplication>
+#include <QEvent>
+#include <QWidget>
+#include "StartupTiming.h"
+
+using namespace std;
+
+StartupTiming::StartupTiming(const QElapsedTimer &timerStart,
+                             MainWindow &mainWindow) :
+  QObject (&mainWindow),
+  m_timerStart (timerStart),
+  m_mainWindow (mainWindow),
+  m_painted (false),
+  m_ready (false)
+{
+  report ("constructed");
+
+  qApp->installEventFilter (this);
+  connect (&mainWindow, SIGNAL (signalStartupFinished ()), this, SLOT (slotReady ()));
+}
+
+bool StartupTiming::eventFilter (QObject *object,
+                                 QEvent *event)
+{
+  if (!m_painted &&
+      (event->type () == QEvent::Paint) &&
+      object->isWidgetType ()) {
+
+    QWidget *widget = static_cast<QWidget*> (object);
+    if (widget->window () == &m_mainWindow) {
+
+      m_painted = true;
+      report ("first paint");
+
+      // The filter sees the event just before the widget paints, which is close enough to catch regressions. No
+      // further events are of interest
+      qApp->removeEventFilter (this);
+      quitIfDone ();
+    }
+  }
+
+  return QObject::eventFilter (object, event);
+}
+
+void StartupTiming::quitIfDone ()
+{
+  if (m_painted && m_ready) {
+    qApp->quit ();
+  }
+}
+
+void StartupTiming::report (const QString &milestone) const
+{
+  qint64 elapsed = m_timerStart.elapsed ();
+
+  LOG4CPP_INFO_S ((*mainCat)) << "StartupTiming::report"
+                              << " milestone=" << milestone.toLatin1 ().data ()
+                              << " ms=" << elapsed;
+
+  cerr << "Startup " << milestone.toLatin1 ().data () << ": " << elapsed << " ms" << endl;
+}
+
+void StartupTiming::slotReady ()
+{
+  m_ready = true;
+  report ("ready");
+
+  quitIfDone ();
+}
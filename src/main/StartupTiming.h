@@ -0,0 +1,44 @@
+#ifndef STARTUP_TIMING_H
+#define STARTUP_TIMING_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+class MainWindow;
+class QEvent;
+
+/// Measure the startup time for the -time command line option, so regressions in startup time can be caught.
+///
+/// Times are measured from the start of main to the construction of the main window, its first paint, and the
+/// point where its deferred startup work has finished. Each time is written to standard error and the log. The
+/// application quits once it has painted and finished starting up, so the measurement can be scripted
+class StartupTiming : public QObject
+{
+  Q_OBJECT;
+
+public:
+  /// Single constructor. The timer is started at the beginning of main.
+  StartupTiming(const QElapsedTimer &timerStart,
+                MainWindow &mainWindow);
+
+  /// Catch the first paint event of the main window or any of its children.
+  virtual bool eventFilter (QObject *object,
+                            QEvent *event);
+
+private slots:
+  void slotReady ();
+
+private:
+  StartupTiming();
+
+  void quitIfDone ();
+  void report (const QString &milestone) const;
+
+  QElapsedTimer m_timerStart;
+  MainWindow &m_mainWindow;
+  bool m_painted;
+  bool m_ready;
+};
+
+#endif // STARTUP_TIMING_H
@@ -1,45 +1,64 @@
+#include "DocumentModelGridRemoval.h"
 #include "FilterParameter.h"
 #include <iostream>
 #include "Logger.h"
 #include "MainWindow.h"
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QPixmapCache>
+#include "StartupTiming.h"
 
 using namespace std;
 
+const int PIXMAP_CACHE_LIMIT_KB = 64 * 1024; // Room for the background tiles of a full screen view, and the point glyphs
+
 // Prototypes
-void parseCmdLine (int argc, char **argv, bool &isDebug);
+void parseCmdLine (int argc, char **argv, bool &isDebug, bool &isTime);
 
 // Functions
 int main(int argc, char *argv[])
 {
+  // Started before anything else, so the startup times cover all of the startup work
+  QElapsedTimer timerStart;
+  timerStart.start ();
+
+  qRegisterMetaType<DocumentModelGridRemoval> ("DocumentModelGridRemoval");
   qRegisterMetaType<FilterParameter> ("FilterParameter");
 
   QApplication a(argc, argv);
 
-  bool isDebug;
-  parseCmdLine (argc, argv, isDebug);
+  QPixmapCache::setCacheLimit (PIXMAP_CACHE_LIMIT_KB);
+
+  bool isDebug, isTime;
+  parseCmdLine (argc, argv, isDebug, isTime);
 
   initializeLogging ("engauge",
                      "engauge.log",
                      isDebug);
 
   MainWindow w;
+  if (isTime) {
+    new StartupTiming (timerStart, w); // Owned by the main window
+  }
   w.show();
 
   return a.exec();
 }
 
-void parseCmdLine (int argc, char **argv, bool &isDebug)
+void parseCmdLine (int argc, char **argv, bool &isDebug, bool &isTime)
 {
   bool showUsage = false;
 
   // Defaults
   isDebug = false;
+  isTime = false;
 
   for (int i = 1; i < argc; i++) {
 
     if (strcmp (argv [i], "-debug") == 0) {
       isDebug = true;
+    } else if (strcmp (argv [i], "-time") == 0) {
+      isTime = true;
     } else {
       showUsage = true;
     }
@@ -47,8 +66,9 @@ void parseCmdLine (int argc, char **argv, bool &isDebug)
 
   if (showUsage) {
 
-    cerr << "Usage: engauge [-debug]" << endl
-         << "  -debug     Enable extra debug information" << endl;
+    cerr << "Usage: engauge [-debug] [-time]" << endl
+         << "  -debug     Enable extra debug information" << endl
+         << "  -time      Report the startup times and then exit" << endl;
 
     exit (0);
   }